@@ -109,6 +109,12 @@ INTERNAL reg32_t* currentTCB;
  */
 PRIVATE reg32_t* nextTCB;
 
+/*
+ * Context switching hook of client.
+ * Called on each context switch if it is set.
+ */
+PRIVATE Drv_CPUCore_CSHook csHook;
+
 /**************************** PRIVATE FUNCTIONS ******************************/
 
 /*
@@ -124,6 +130,12 @@ INTERNAL void SwitchContext(void)
     /* TODO Check for stack overflow */
     
 	currentTCB = nextTCB;
+
+	/* Let client run its deferred works before switched task starts */
+	if (csHook != NULL)
+	{
+		csHook();
+	}
 }
 
 /*
@@ -149,6 +161,11 @@ void Drv_CPUCore_Init(void)
 	 * Currently Core initialization done by System_Init function before
 	 * main() function. We can move it here for coding consistency.
 	 */
+
+	/* Enable cycle counter of DWT unit for profiling */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 /*
@@ -216,6 +233,60 @@ void Drv_CPUCore_CSYieldTo(reg32_t* newTCB)
     __DMB();
 }
 
+/*
+ * Sets context switching hook
+ *
+ * @param hook to be called hook on each context switch. NULL removes hook.
+ *
+ * @return none
+ */
+void Drv_CPUCore_CSSetHook(Drv_CPUCore_CSHook hook)
+{
+	csHook = hook;
+}
+
+/*
+ * Disables interrupts to start a critical section.
+ *
+ *  PRIMASK is saved so nested critical sections do not enable interrupts.
+ */
+uint32_t Drv_CPUCore_DisableInterrupts(void)
+{
+	uint32_t state = __get_PRIMASK();
+
+	__disable_irq();
+
+	return state;
+}
+
+/*
+ * Restores interrupt state at the end of a critical section.
+ */
+void Drv_CPUCore_RestoreInterrupts(uint32_t state)
+{
+	__set_PRIMASK(state);
+}
+
+/*
+ * Reads free running CPU cycle counter for profiling.
+ *
+ *  Cortex-M3 has a 32 bit cycle counter in Data Watchpoint and Trace (DWT)
+ *  unit which is enabled in Drv_CPUCore_Init().
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void)
+{
+	return DWT->CYCCNT;
+}
+
+/*
+ * Calculates elapsed CPU cycles since a cycle counter value.
+ */
+uint32_t Drv_CPUCore_ElapsedCycles(uint32_t startCycle)
+{
+	/* 32 bit counter so unsigned subtraction handles wrap around */
+	return DWT->CYCCNT - startCycle;
+}
+
 /*
  * Initializes task stack according to Cortex-M3 Architecture.   
  *
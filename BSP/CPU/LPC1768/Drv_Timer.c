@@ -6,15 +6,20 @@
  *
  * @brief Timer Driver Implementation.
  *
- *			This timer provides one shot timer so Timer is not resetted on
- *			match and just interrupt created. Timer is also disabled on match.
+ *			HW counters are free running and never stopped or reset. Each
+ *			HW Timer provides 4 match channels and each channel is an
+ *			independent one shot timer : match value is set relative to
+ *			current counter and channel is disarmed on match.
+ *
+ *			Periodic timers use reset on match so HW re-arms them without
+ *			any SW cost. While counter is reset on each period, periodic
+ *			timer must be the only channel of its HW Timer.
  *
  *			Timer resolution is 1 microsecond so clock dividers and prescale
  *			values are set according to this resolution.
  *
  *        TODO
  *			- Timer Power should be closed when device enter sleep (Low Power)
- *			- IMP : Check for Cost of Timer Enable/Disable for each time.
  *
  * @see https://github.com/P-LATFORM/P-OS/wiki
  *
@@ -46,6 +51,7 @@
 
 /********************************* INCLUDES ***********************************/
 #include "Drv_Timer.h"
+#include "Drv_CPUCore.h"
 
 #include "LPC17xx.h"
 #include "lpc17xx_clkpwr.h"
@@ -80,6 +86,15 @@
 /* Just a wrapper for to be used timer number */
 #define NUM_OF_TIMERS						DRV_CONFIG_NUM_OF_USED_HW_TIMERS
 
+/*
+ * Number of match channels in a HW Timer.
+ *  LPC17xx Timers have 4 match registers (MR0-MR3).
+ */
+#define NUM_OF_MATCH_CHANNELS				(4)
+
+/* Match register of a channel. MR0-MR3 are sequential in register map. */
+#define MATCH_REGISTER(LPC_TIM, channel)	((&(LPC_TIM)->MR0)[channel])
+
 /* Local Wrapper for global debugging mode */
 #define TIMER_DEBUG_MODE					ENABLE_DEBUG_ASSERT
 
@@ -117,6 +132,21 @@
 				TIM_IR_CLR(TIM_MR3_INT) | /* Match channel 3   */ \
 				TIM_IR_CLR(TIM_CR0_INT) | /* Capture channel 0 */ \
 				TIM_IR_CLR(TIM_CR1_INT)   /* Capture channel 1 */
+
+/* Mask of all match channel interrupt pendings */
+#define TIMER_MATCH_INT_PENDINGS_MASK \
+				TIM_IR_CLR(TIM_MR0_INT) | \
+				TIM_IR_CLR(TIM_MR1_INT) | \
+				TIM_IR_CLR(TIM_MR2_INT) | \
+				TIM_IR_CLR(TIM_MR3_INT)
+
+/* Mask of reset on match of all match channels (periodic channels) */
+#define TIMER_RESET_ON_MATCH_MASK \
+				TIM_RESET_ON_MATCH(0) | \
+				TIM_RESET_ON_MATCH(1) | \
+				TIM_RESET_ON_MATCH(2) | \
+				TIM_RESET_ON_MATCH(3)
+
 /*
  * Clock Division Value for Timer Clock
  * 		Timer_Clock = CPU_Clock / TIMER_CLK_DIV
@@ -135,6 +165,18 @@
  */
 #define TIMER_RESOLUTION_US					(1000000)
 
+/*
+ * Match interval of time base. Counter is observed at least twice in a wrap
+ * around period so a wrap is never missed.
+ */
+#define TIMEBASE_MATCH_INTERVAL				(0x80000000UL)
+
+/*
+ * Match channel used by time base. Last channel is used so channel 0 of
+ * same HW Timer is still available for Drv_Timer_Create() clients.
+ */
+#define TIMEBASE_CHANNEL					(NUM_OF_MATCH_CHANNELS - 1)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*
@@ -152,6 +194,8 @@ typedef struct
     LPC_TIM_TypeDef* LPC_TIM;
 	/* Value (Mask) for Peripheral Control Block to power up of HW Timer */
     uint32_t PCONP_Value;
+	/* IRQ Number of HW Timer. Shared by all match channels */
+	IRQn_Type IRQNo;
 } HWTimerInfo;
 
 /*
@@ -169,8 +213,50 @@ typedef struct
 	DrvTimerCallback callback;
 	/* Reference to HW Objects (e.g. Registers) */
 	const HWTimerInfo* hwTimerInfo;
+	/* Match channel of HW Timer */
+	uint32_t channel;
+	/* Counter value when timer is started. Elapsed time is relative to it */
+	uint32_t startCount;
+	/* Last started timeout */
+	uint32_t timeoutInUs;
+	/* Period of timer. Zero for one shot timers. */
+	uint32_t periodInUs;
+	/* Number of periods which are missed because of overruns */
+	uint32_t missedPeriods;
 } Timer;
 
+/*
+ * Match channels of a HW Timer.
+ *  Channels share HW counter and IRQ of HW Timer.
+ */
+typedef struct
+{
+	/* Timer objects of match channels */
+	Timer channels[NUM_OF_MATCH_CHANNELS];
+	/* Mask of created channels. HW Timer is initialized with first channel */
+	uint32_t createdChannels;
+	/* Priority of shared IRQ. Highest priority requested by channels */
+	DrvTimerPriority priority;
+} TimerBlock;
+
+/*
+ * Free running 64 bit time base.
+ *  32 bit HW counter is extended in SW using wrap arounds of counter.
+ */
+typedef struct
+{
+	/* Match channel which observes counter */
+	Timer* timer;
+	/* Registers of HW Timer which runs time base */
+	LPC_TIM_TypeDef* LPC_TIM;
+	/* Counter value when time base is started */
+	uint32_t startLow;
+	/* Upper 32 bits of time */
+	uint32_t high;
+	/* Last observed counter value to detect wrap arounds */
+	uint32_t lastLow;
+} TimeBase;
+
 /**************************** FUNCTION PROTOTYPES *****************************/
 PRIVATE void TIMER_IRQHandler(TimerNo timerNo);
 
@@ -184,28 +270,33 @@ PRIVATE void TIMER_IRQHandler(TimerNo timerNo);
 PRIVATE const HWTimerInfo HWTimers[] =
 {
 	/* HW Timer 0 */
-    { LPC_TIM0, CLKPWR_PCONP_PCTIM0 },
+    { LPC_TIM0, CLKPWR_PCONP_PCTIM0, TIMER0_IRQn },
 
 	/* HW Timer 1 */
 #if NUM_OF_TIMERS > 1
-    { LPC_TIM1, CLKPWR_PCONP_PCTIM1 },
+    { LPC_TIM1, CLKPWR_PCONP_PCTIM1, TIMER1_IRQn },
 #endif	/* #if NUM_OF_TIMERS > 1 */
 
 	/* HW Timer 2 */
 #if NUM_OF_TIMERS > 2
-    { LPC_TIM2, CLKPWR_PCONP_PCTIM2 },
+    { LPC_TIM2, CLKPWR_PCONP_PCTIM2, TIMER2_IRQn },
 #endif	/* #if NUM_OF_TIMERS > 2 */
 
 	/* HW Timer 3 */
 #if NUM_OF_TIMERS > 3
-    { LPC_TIM3, CLKPWR_PCONP_PCTIM3 }
+    { LPC_TIM3, CLKPWR_PCONP_PCTIM3, TIMER3_IRQn }
 #endif	/* #if NUM_OF_TIMERS > 3 */
 };
 
 /*
- * All timer objects
+ * All timer objects. Grouped by HW Timers.
+ */
+PRIVATE TimerBlock timerBlocks[NUM_OF_TIMERS];
+
+/*
+ * Time base
  */
-PRIVATE Timer timers[NUM_OF_TIMERS];
+PRIVATE TimeBase timeBase;
 
 /*
  * Custom (Emprically Defined) IRQ Priorities for HW Timers
@@ -261,46 +352,196 @@ INTERNAL void POS_TIMER3_IRQHandler(void)
 #endif /* #if NUM_OF_TIMERS > 3 */
 }
 
+/*
+ * Checks whether timeout of an armed channel is elapsed.
+ *  Counter and match values are compared relative to start of timer so
+ *  wrap around of free running counter does not matter.
+ */
+PRIVATE ALWAYS_INLINE uint32_t TimerIsExpired(LPC_TIM_TypeDef* LPC_TIM, Timer* timer)
+{
+	return ((uint32_t)(LPC_TIM->TC - timer->startCount) >= timer->timeoutInUs);
+}
+
 /*
  * Comman ISR Function for all Timer Interrupts.
  *  While all ISR functions do same things on different HW Timer registers,
  *  we can collect in single function and pass timer number to get required
  *  Register
  *
+ *  All match channels of HW Timer share the IRQ so expired channels are
+ *  collected and disarmed first, then their callbacks are called. In this
+ *  way, a callback can start its channel again.
+ *
  * @param timerNo Number of Timer interrupt source
  */
 PRIVATE void TIMER_IRQHandler(TimerNo timerNo)
 {
     /* Get HW TIMER Pointer */
     LPC_TIM_TypeDef* LPC_TIM = HWTimers[timerNo].LPC_TIM;
+	Timer* channels = timerBlocks[timerNo].channels;
+	uint32_t interruptState;
+	uint32_t pendings;
+	uint32_t expireds = 0;
+	uint32_t channel;
+
+	/* MCR is shared with other contexts which start channels */
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	/* Clear Interrupt Pending Flags */
+	pendings = LPC_TIM->IR & (uint32_t)(TIMER_MATCH_INT_PENDINGS_MASK);
+	LPC_TIM->IR = pendings;
+
+	for (channel = 0; channel < NUM_OF_MATCH_CHANNELS; channel++)
+	{
+		if ((LPC_TIM->MCR & TIM_INT_ON_MATCH(channel)) == 0)
+		{
+			/* Channel is not armed */
+		}
+		else if (channels[channel].periodInUs != 0)
+		{
+			/* Periodic timer is re-armed by HW, just inform client */
+			expireds |= (pendings & TIM_IR_CLR(channel));
+		}
+		/*
+		 * Channel is expired if it matched or if its match is lost while
+		 * starting (see StartTimer())
+		 */
+		else if ((pendings & TIM_IR_CLR(channel)) || TimerIsExpired(LPC_TIM, &channels[channel]))
+		{
+			/* One shot timer so disarm channel */
+			LPC_TIM->MCR &= ~TIM_INT_ON_MATCH(channel);
+
+			expireds |= (1 << channel);
+		}
+	}
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+
+	for (channel = 0; expireds != 0; channel++, expireds >>= 1)
+	{
+		if (expireds & 1)
+		{
+			/* Inform external (client) module */
+			channels[channel].callback();
+
+			/*
+			 * If next period is matched while client is informed, client
+			 * overruns its period. Drop that period and count it as missed.
+			 *
+			 * [IMP] Counter is reset by HW on each period so number of
+			 * passed periods is not known. An overrun is counted once.
+			 */
+			if (channels[channel].periodInUs != 0 &&
+				(LPC_TIM->IR & TIM_IR_CLR(channel)))
+			{
+				LPC_TIM->IR = (uint32_t)TIM_IR_CLR(channel);
+				channels[channel].missedPeriods++;
+			}
+		}
+	}
+}
 
-	if ((LPC_TIM->IR) & TIM_IR_CLR(TIM_MR0_INT))
+/*
+ * Set Match Value of Timer Channel to fire an Interrupt.
+ *  Counter is not touched. Match value is set relative to current counter
+ *  or relative to a point after previous start of channel.
+ *
+ * @param timer to be started timer
+ * @param timeoutInUs timeout of timer
+ * @param fromNow BOOL_TRUE to start timer from current counter, BOOL_FALSE
+ *        to start it advanceInUs after its previous start
+ * @param advanceInUs time from previous start to new start
+ */
+PRIVATE ALWAYS_INLINE void StartTimer(Timer* timer, uint32_t timeoutInUs, uint32_t fromNow, uint32_t advanceInUs)
+{
+	LPC_TIM_TypeDef* LPC_TIM = timer->hwTimerInfo->LPC_TIM;
+	uint32_t channel = timer->channel;
+	uint32_t interruptState;
+
+	/* MCR is shared with other channels and ISR */
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	/* One shot timer so counter is not reset on match */
+	LPC_TIM->MCR &= ~TIM_RESET_ON_MATCH(channel);
+	timer->periodInUs = 0;
+
+	if (fromNow == BOOL_TRUE)
+	{
+		timer->startCount = LPC_TIM->TC;
+	}
+	else
 	{
-		/* Inform external (client) module if interrupt source is true*/
-		timers[timerNo].callback();
+		/* Counter is free running so time after previous start is not lost */
+		timer->startCount += advanceInUs;
+	}
+	timer->timeoutInUs = timeoutInUs;
+
+	/*
+	 * Our timer resolution is 1 uS so we can add tiemout value (in uS)
+	 * directly to counter. Wrap around of match value is natural.
+	 */
+	MATCH_REGISTER(LPC_TIM, channel) = timer->startCount + timeoutInUs;
+
+	/* Clear a pending match of previous timeout and arm channel */
+	LPC_TIM->IR = (uint32_t)TIM_IR_CLR(channel);
+	LPC_TIM->MCR |= TIM_INT_ON_MATCH(channel);
 
-		/* Clear Interrupt Pending Flag */
-		LPC_TIM->IR = (uint32_t)TIM_IR_CLR(TIM_MR0_INT);
+	/*
+	 * For very short timeouts, counter may pass match value before it is
+	 * set so match is lost. Let ISR handle such channels.
+	 */
+	if (TimerIsExpired(LPC_TIM, timer))
+	{
+		NVIC_SetPendingIRQ(timer->hwTimerInfo->IRQNo);
 	}
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
 }
 
 /*
- * Set Timer Match Value to fire an Interrupt.
+ * Starts Timer Channel as a periodic timer.
+ *  Counter is reset on match so HW re-arms timer for next period.
  */
-PRIVATE ALWAYS_INLINE void StartTimer(LPC_TIM_TypeDef* LPC_TIM, uint32_t timeoutInUs)
+PRIVATE ALWAYS_INLINE void StartPeriodicTimer(Timer* timer, uint32_t periodInUs)
 {
+	LPC_TIM_TypeDef* LPC_TIM = timer->hwTimerInfo->LPC_TIM;
+	uint32_t channel = timer->channel;
+	uint32_t interruptState;
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	timer->periodInUs = periodInUs;
+	timer->timeoutInUs = periodInUs;
+	timer->missedPeriods = 0;
+	/* Counter restarts from zero on each period */
+	timer->startCount = 0;
+
 	/*
-	 * Our timer resolution is 1 uS so we can set tiemout value (in uS) directly
-	 * as match value
+	 * Counter is reset on next tick after match so match value is one less
+	 * than period.
 	 */
-	LPC_TIM->MR0 = timeoutInUs;
+	MATCH_REGISTER(LPC_TIM, channel) = periodInUs - 1;
 
-	/* Reset Timer and Prescale counters */
+	/* Start first period from now */
 	LPC_TIM->TC = 0;
 	LPC_TIM->PC = 0;
 
-	/* Enable Timer */
-    LPC_TIM->TCR |= TIM_ENABLE;
+	/* Clear a pending match of previous timeout and arm channel */
+	LPC_TIM->IR = (uint32_t)TIM_IR_CLR(channel);
+	LPC_TIM->MCR |= TIM_INT_ON_MATCH(channel) | TIM_RESET_ON_MATCH(channel);
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+}
+
+/*
+ * Time base ISR.
+ *  Just observes counter to catch wrap around and sets next match.
+ */
+PRIVATE void ISR_TimeBase(void)
+{
+	StartTimer(timeBase.timer, TIMEBASE_MATCH_INTERVAL, BOOL_TRUE, 0);
+
+	(void)Drv_Timer_ReadTimeBaseInUs();
 }
 
 /*
@@ -352,57 +593,87 @@ PRIVATE ALWAYS_INLINE void InitializeHWTimer(const HWTimerInfo* hwTimerInfo)
 	LPC_TIM->IR = (uint32_t)TIMER_CLEAR_ALL_INT_PENDINGS_MASK;
 
     /*
-	 * Set match register.
-	 *  - Just interrupt on match
-	 *  - Stop on match. This is because we are one shot timer.
-	 *  - No reset on match
+	 * Clear match controls. Channels are armed when they are started.
+	 *  - No stop on match. Counter is shared by channels.
+	 *  - No reset on match. Counter is shared by channels.
 	 */
-	LPC_TIM->MCR &=~TIM_MCR_CHANNEL_MASKBIT(0);  /* Clear first */
-    LPC_TIM->MCR |= TIM_INT_ON_MATCH(0) | TIM_STOP_ON_MATCH(0);
+	LPC_TIM->MCR &= ~TIM_MCR_MASKBIT;
+
+	/* Counter is free running. It is never stopped again */
+    LPC_TIM->TCR |= TIM_ENABLE;
 }
 
 /***************************** PUBLIC FUNCTIONS *******************************/
 /*
  * Creates a SW Timer which matches with a HW Timer.
  *
- *  There is no special note about internal implementation details.
- *  See header files to function description.
+ *  Just acquires first match channel of HW Timer.
  */
 PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
 {
+	return Drv_Timer_CreateChannel(timerNo, 0, priority, timerCallback);
+}
+
+/*
+ * Creates a SW Timer which matches with a match channel of HW Timer.
+ *
+ *  HW Timer is initialized when its first channel is created. Channels share
+ *  IRQ of HW Timer so IRQ priority is raised to highest requested priority.
+ */
+PUBLIC TimerHandle Drv_Timer_CreateChannel(TimerNo timerNo,
+										   uint32_t channelNo,
+										   DrvTimerPriority priority,
+										   DrvTimerCallback timerCallback)
+{
+	TimerBlock* timerBlock;
 	Timer* timer;
-	IRQn_Type timerIRQNo;
 
 	/* Internal Checks for debug mode */
-	DEBUG_ASSERT_MESSAGE((timerNo < NUM_OF_HW_TIMERS), "Invalid Timer No!");
+	DEBUG_ASSERT_MESSAGE((timerNo < NUM_OF_TIMERS), "Invalid Timer No!");
+	DEBUG_ASSERT_MESSAGE((channelNo < NUM_OF_MATCH_CHANNELS), "Invalid Timer Channel!");
 
 	/*
 	 * Get timer objects to fill client info.
      *  Get here because other internal checks may use timer object
 	 */
-	timer = &timers[timerNo];
+	timerBlock = &timerBlocks[timerNo];
+	timer = &timerBlock->channels[channelNo];
 
 	/* Rest of internal checks */
 	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer) == 0, "Timer is already assigned before!");
 	DEBUG_ASSERT_MESSAGE((priority < DRV_TIMER_PRI_NUM), "Invalid Timer Priority!");
 	DEBUG_ASSERT_MESSAGE(timerCallback != NULL, "Invalid (NULL) Callback!");
+	/* Periodic channel resets counter so other channels can not share its HW Timer */
+	DEBUG_ASSERT_MESSAGE((timerBlock->createdChannels == 0) ||
+						 ((HWTimers[timerNo].LPC_TIM->MCR & (TIMER_RESET_ON_MATCH_MASK)) == 0),
+						 "Periodic Timer needs an exclusive HW Timer");
 
 	/* Save Client Callback to call in case of timer timeout */
 	timer->callback = timerCallback;
 	/* Link HW Info with Timer Objects */
 	timer->hwTimerInfo = &HWTimers[timerNo];
+	timer->channel = channelNo;
 
-	/* Initialize Timer HW Block for selected HW Timer */
-    InitializeHWTimer(timer->hwTimerInfo);
+	if (timerBlock->createdChannels == 0)
+	{
+		/* Initialize Timer HW Block for selected HW Timer */
+		InitializeHWTimer(timer->hwTimerInfo);
+
+		timerBlock->priority = priority;
+	}
+	else if (priority < timerBlock->priority)
+	{
+		/* Lower value is higher priority */
+		timerBlock->priority = priority;
+	}
 
-	/* Calculate Timer IRQ Num. For LPC17xx all of them are sequential */
-	timerIRQNo = (IRQn_Type)(TIMER0_IRQn + timerNo);
+	timerBlock->createdChannels |= (1 << channelNo);
 
 	/* Set interrupt priority using client's priority request */
-	NVIC_SetPriority(timerIRQNo, timerIRQPriorities[priority]);
+	NVIC_SetPriority(timer->hwTimerInfo->IRQNo, timerIRQPriorities[timerBlock->priority]);
 
 	/* We can enable interrupt of specified Timer */
-    NVIC_EnableIRQ(timerIRQNo);
+    NVIC_EnableIRQ(timer->hwTimerInfo->IRQNo);
 
 	/* We initialized timer so we can mark it as validated (initialized) */
 	TIMER_SET_VALIDATION_KEY(timer);
@@ -428,15 +699,116 @@ PUBLIC void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
 	/* Internal Checks for debug mode */
 	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
 
-	/* Start specified HW Timer with timeout value */
-	StartTimer(timer->hwTimerInfo->LPC_TIM, timeoutInUs);
+	/* Start specified Timer Channel with timeout value */
+	StartTimer(timer, timeoutInUs, BOOL_TRUE, 0);
+}
+
+/*
+ * Starts a Timer from its last timeout.
+ *
+ *  Counter is free running so new match value is just previous match value
+ *  plus timeout.
+ */
+PUBLIC void Drv_Timer_StartFromLastTimeout(TimerHandle timerHandle, uint32_t timeoutInUs)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->periodInUs == 0, "Timer is not a one shot Timer");
+
+	/* Start specified Timer Channel from its previous match */
+	StartTimer(timer, timeoutInUs, BOOL_FALSE, timer->timeoutInUs);
+}
+
+/*
+ * Starts a Timer from a point of its current run.
+ *
+ *  Counter is free running so new run just starts given time after
+ *  previous start.
+ */
+PUBLIC void Drv_Timer_StartFromElapsedTime(TimerHandle timerHandle, uint32_t elapsedInUs, uint32_t timeoutInUs)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(timer->periodInUs == 0, "Timer is not a one shot Timer");
+
+	/* Start specified Timer Channel from given point of current run */
+	StartTimer(timer, timeoutInUs, BOOL_FALSE, elapsedInUs);
+}
+
+/*
+ * Starts a Timer in periodic mode.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(periodInUs > 0, "Invalid Timer Period");
+	DEBUG_ASSERT_MESSAGE(timerBlocks[timer->hwTimerInfo - HWTimers].createdChannels == (1UL << timer->channel),
+						 "Periodic Timer needs an exclusive HW Timer");
+
+	/* Start specified Timer Channel with period value */
+	StartPeriodicTimer(timer, periodInUs);
+}
+
+/*
+ * Stops a Timer.
+ *
+ *  Just disarms channel. Counter keeps running for other channels.
+ */
+PUBLIC void Drv_Timer_Stop(TimerHandle timerHandle)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+	LPC_TIM_TypeDef* LPC_TIM;
+	uint32_t interruptState;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+
+	LPC_TIM = timer->hwTimerInfo->LPC_TIM;
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	LPC_TIM->MCR &= ~(TIM_INT_ON_MATCH(timer->channel) | TIM_RESET_ON_MATCH(timer->channel));
+	LPC_TIM->IR = (uint32_t)TIM_IR_CLR(timer->channel);
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+}
+
+/*
+ * Reads missed period count of a periodic Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint32_t Drv_Timer_ReadMissedPeriods(TimerHandle timerHandle)
+{
+	/* Get internal timer using timer handle */
+	Timer* timer = (Timer*)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(timer), "Invalid Timer Handle");
+
+	return timer->missedPeriods;
 }
 
 /*
  * Reads elapsed time in a Timer.
  *
  *  Our resolution is 1 microseconds so 1 tick means 1 us so we can directly
- *  return timer tick counter as elapsed time.
+ *  return difference of counter from start of timer as elapsed time.
  */
 PUBLIC uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
 {
@@ -451,5 +823,51 @@ PUBLIC uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
     LPC_TIM = timer->hwTimerInfo->LPC_TIM;
 
 	/* Return just tick count (1 tick = 1 us) as elapsed time */
-	return (uint32_t)LPC_TIM->TC;
+	return (uint32_t)(LPC_TIM->TC - timer->startCount);
+}
+
+/*
+ * Starts free running time base.
+ *
+ *  Counter of HW Timer is already free running so time base just uses a
+ *  match channel to observe counter at every half of wrap around period.
+ */
+PUBLIC void Drv_Timer_StartTimeBase(TimerNo timerNo)
+{
+	timeBase.timer = (Timer*)Drv_Timer_CreateChannel(timerNo,
+													 TIMEBASE_CHANNEL,
+													 DRV_TIMER_PRI_LOW,
+													 ISR_TimeBase);
+
+	timeBase.LPC_TIM = timeBase.timer->hwTimerInfo->LPC_TIM;
+	timeBase.high = 0;
+	timeBase.startLow = timeBase.LPC_TIM->TC;
+	timeBase.lastLow = timeBase.startLow;
+
+	StartTimer(timeBase.timer, TIMEBASE_MATCH_INTERVAL, BOOL_TRUE, 0);
+}
+
+/*
+ * Reads time base.
+ *
+ *  Counter is read with interrupts disabled and wrap around is detected
+ *  against last observed value so reading is race free.
+ */
+PUBLIC uint64_t Drv_Timer_ReadTimeBaseInUs(void)
+{
+	uint32_t interruptState = Drv_CPUCore_DisableInterrupts();
+	uint32_t low = (uint32_t)timeBase.LPC_TIM->TC;
+	uint64_t time;
+
+	if (low < timeBase.lastLow)
+	{
+		timeBase.high++;
+	}
+	timeBase.lastLow = low;
+
+	time = (((uint64_t)timeBase.high << 32) | low) - timeBase.startLow;
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+
+	return time;
 }
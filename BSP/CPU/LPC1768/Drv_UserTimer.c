@@ -0,0 +1,793 @@
+/*******************************************************************************
+ *
+ * @file Drv_UserTimer.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief User (Software) Timer Driver Implementation.
+ *
+ *			All user timers are multiplexed over a single one shot HW Timer.
+ *			Timers are kept in a hierarchical timing wheel (4 levels of 32
+ *			slots) so start and stop are O(1). A level 0 slot keeps timers
+ *			which expire in a tick, higher level slots keep timers of a range
+ *			of ticks and are cascaded into lower levels when wheel time
+ *			reaches start of their range.
+ *
+ *			Wheel is tickless : HW Timer is always set to nearest wheel event
+ *			(first occupied level 0 slot or cascade of first occupied higher
+ *			level slot) which is found using occupancy bitmaps of levels.
+ *
+ *			Events are processed only in timer interrupt. Starting a timer
+ *			just inserts it into wheel and re-arms HW Timer if new timer
+ *			expires earlier.
+ *
+ *			Callbacks are called in timer interrupt after wheel is processed
+ *			(with interrupts enabled) or deferred to a daemon task (see
+ *			Drv_UserTimer_RunDaemon()).
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_UserTimer.h"
+#include "Drv_Timer.h"
+#include "Drv_CPUCore.h"
+
+#include "LPC17xx.h"
+
+#include "BSPConfig.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Resolution of user timers. Timeouts are rounded up to ticks.
+ */
+#ifndef DRV_USERTIMER_TICK_IN_US
+#define DRV_USERTIMER_TICK_IN_US			(100)
+#endif
+
+/*
+ * Maximum timeout of HW Timer.
+ *
+ *  HW Timer keeps wheel time so it is started even if there is no timer
+ *  event in near future. Must fit in HW Timer range.
+ */
+#ifndef DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US
+#define DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US	(1000000)
+#endif
+
+/* Maximum number of user timers */
+#define NUM_OF_USER_TIMERS					(CPU_TIMER_MAX_TIMER_COUNT)
+
+/* Wheel geometry */
+#define WHEEL_SLOT_BITS						(5)
+#define WHEEL_SLOT_COUNT					(1UL << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK						(WHEEL_SLOT_COUNT - 1)
+#define WHEEL_LEVEL_COUNT					(4)
+
+/* Bit shift of tick to get slot index of a level */
+#define WHEEL_LEVEL_SHIFT(level)			((level) * WHEEL_SLOT_BITS)
+
+/* Range of wheel in ticks. Further timers are parked at end of wheel. */
+#define WHEEL_RANGE_IN_TICKS				(1UL << WHEEL_LEVEL_SHIFT(WHEEL_LEVEL_COUNT))
+
+/*
+ * Checks whether if tick a is before tick b.
+ *  Difference is used so comparison is safe when ticks wrap around.
+ */
+#define TICK_BEFORE(a, b)					((int32_t)((a) - (b)) < 0)
+
+/* Checks whether if a user timer handle is valid */
+#define USER_TIMER_HANDLE_IS_VALID(handle) \
+			(((handle) >= 0) && ((handle) < NUM_OF_USER_TIMERS) && \
+			 (service.timers[(handle)].flags.allocated == BOOL_TRUE))
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * User Timer Object
+ */
+typedef struct UserTimer
+{
+	/* Next timer in wheel slot */
+	struct UserTimer* next;
+	/* Link which points to this timer in slot list for O(1) removal */
+	struct UserTimer** pprev;
+	/* Next timer in callback queue */
+	struct UserTimer* nextQueued;
+
+	/* Client callback */
+	Drv_UserTimerCallback callback;
+
+	/* Expiry time in wheel ticks */
+	uint32_t expiryTick;
+	/* Period in wheel ticks. Zero for one shot timers. */
+	uint32_t periodInTicks;
+
+	/* Position in wheel */
+	uint8_t level;
+	uint8_t slot;
+
+	/* Timer flags */
+	struct
+	{
+		/* Timer is created */
+		uint32_t allocated : 1;
+		/* Timer is started and it is in wheel */
+		uint32_t active : 1;
+		/* Callback is called by daemon task */
+		uint32_t daemon : 1;
+		/* Timer is in a callback queue */
+		uint32_t queued : 1;
+		/* Callback of queued timer should be called */
+		uint32_t pending : 1;
+		uint32_t __reserved : 27;
+	} flags;
+} UserTimer;
+
+/*
+ * Hierarchical Timing Wheel
+ */
+typedef struct
+{
+	/* Timer lists of slots */
+	UserTimer* slots[WHEEL_LEVEL_COUNT][WHEEL_SLOT_COUNT];
+	/* Occupied (non-empty) slots of levels, a bit for each slot */
+	uint32_t occupied[WHEEL_LEVEL_COUNT];
+	/* Wheel time in ticks. All events until this tick are processed. */
+	uint32_t now;
+	/* Elapsed time in actual tick which is not added to wheel time yet */
+	uint32_t remainderInUs;
+} TimerWheel;
+
+/*
+ * Queue of expired timers whose callbacks are called out of wheel processing
+ */
+typedef struct
+{
+	UserTimer* head;
+	UserTimer** tail;
+} TimerQueue;
+
+/*
+ * User Timer Service Data
+ */
+typedef struct
+{
+	/* HW Timer which user timers are multiplexed on */
+	TimerHandle hwTimer;
+
+	/* Timing wheel */
+	TimerWheel wheel;
+
+	/* Timer pool */
+	UserTimer timers[NUM_OF_USER_TIMERS];
+
+	/* Wheel tick which HW Timer expires at (or before) */
+	uint32_t armedTick;
+
+	/* Expired timers whose callbacks are called at end of timer interrupt */
+	TimerQueue isrQueue;
+	/* Expired timers whose callbacks are deferred to daemon task */
+	TimerQueue daemonQueue;
+
+	/* Daemon notification hook */
+	Drv_UserTimerCallback daemonHook;
+} UserTimerService;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * User Timer Service (Internal) Data
+ */
+PRIVATE UserTimerService service;
+
+/**************************** PRIVATE FUNCTIONS *******************************/
+
+/*
+ * Rotates a slot bitmap to right so bit of given slot becomes first bit.
+ */
+PRIVATE ALWAYS_INLINE uint32_t RotateSlots(uint32_t slots, uint32_t slot)
+{
+	return (slot == 0) ? slots : ((slots >> slot) | (slots << (WHEEL_SLOT_COUNT - slot)));
+}
+
+/*
+ * Inserts a timer into wheel according to its expiry time. O(1)
+ *
+ *  Level is selected by distance of expiry so a timer is cascaded at most
+ *  once for each level.
+ */
+PRIVATE void Wheel_Insert(UserTimer* timer)
+{
+	TimerWheel* wheel = &service.wheel;
+	uint32_t delta = timer->expiryTick - wheel->now;
+	uint32_t slotTick = timer->expiryTick;
+	uint32_t level = 0;
+	UserTimer** head;
+
+	if (delta >= WHEEL_RANGE_IN_TICKS)
+	{
+		/* Park at end of wheel, timer is placed again when it is cascaded */
+		delta = WHEEL_RANGE_IN_TICKS - 1;
+		slotTick = wheel->now + delta;
+	}
+
+	while (delta >= (1UL << WHEEL_LEVEL_SHIFT(level + 1)))
+	{
+		level++;
+	}
+
+	timer->level = (uint8_t)level;
+	timer->slot = (uint8_t)((slotTick >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK);
+
+	head = &wheel->slots[level][timer->slot];
+
+	timer->next = *head;
+	if (*head != NULL)
+	{
+		(*head)->pprev = &timer->next;
+	}
+	*head = timer;
+	timer->pprev = head;
+
+	wheel->occupied[level] |= (1UL << timer->slot);
+}
+
+/*
+ * Removes a timer from wheel. O(1)
+ */
+PRIVATE void Wheel_Remove(UserTimer* timer)
+{
+	TimerWheel* wheel = &service.wheel;
+
+	*timer->pprev = timer->next;
+	if (timer->next != NULL)
+	{
+		timer->next->pprev = timer->pprev;
+	}
+
+	if (wheel->slots[timer->level][timer->slot] == NULL)
+	{
+		wheel->occupied[timer->level] &= ~(1UL << timer->slot);
+	}
+}
+
+/*
+ * Finds tick of nearest wheel event.
+ *
+ *  An event is expiry of timers in first occupied level 0 slot or cascade
+ *  of first occupied slot of a higher level.
+ *
+ * @param nextTick tick of nearest event
+ * @return BOOL_TRUE if wheel has an event, otherwise BOOL_FALSE
+ */
+PRIVATE uint32_t Wheel_NextEventTick(uint32_t* nextTick)
+{
+	TimerWheel* wheel = &service.wheel;
+	uint32_t found = BOOL_FALSE;
+	uint32_t level;
+	uint32_t position;
+	uint32_t distance;
+	uint32_t tick;
+
+	for (level = 0; level < WHEEL_LEVEL_COUNT; level++)
+	{
+		if (wheel->occupied[level] == 0)
+		{
+			continue;
+		}
+
+		/* Distance (in slots) of first occupied slot from actual slot */
+		position = (wheel->now >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK;
+		distance = COUNT_TRAILING_ZEROS(RotateSlots(wheel->occupied[level], position));
+
+		if (level == 0)
+		{
+			tick = wheel->now + distance;
+		}
+		else
+		{
+			/* Actual slot of a higher level is already cascaded */
+			if (distance == 0)
+			{
+				distance = WHEEL_SLOT_COUNT;
+			}
+
+			tick = ((wheel->now >> WHEEL_LEVEL_SHIFT(level)) + distance) << WHEEL_LEVEL_SHIFT(level);
+		}
+
+		if ((found == BOOL_FALSE) || TICK_BEFORE(tick, *nextTick))
+		{
+			*nextTick = tick;
+			found = BOOL_TRUE;
+		}
+	}
+
+	return found;
+}
+
+/*
+ * Puts an expired timer into a callback queue. A timer which is already in
+ * queue is not put again so its expiries are coalesced.
+ */
+PRIVATE void QueueTimer(TimerQueue* queue, UserTimer* timer)
+{
+	timer->flags.pending = BOOL_TRUE;
+
+	if (timer->flags.queued == BOOL_FALSE)
+	{
+		timer->flags.queued = BOOL_TRUE;
+		timer->nextQueued = NULL;
+		*queue->tail = timer;
+		queue->tail = &timer->nextQueued;
+	}
+}
+
+/*
+ * Calls callbacks of queued timers.
+ *
+ *  Timers are taken from queue one by one with interrupts disabled and
+ *  callbacks are called with interrupts enabled. A timer which is stopped
+ *  while it is in queue leaves queue without calling its callback.
+ *
+ * @return number of called callbacks
+ */
+PRIVATE uint32_t CallQueuedTimers(TimerQueue* queue)
+{
+	Drv_UserTimerCallback callback;
+	UserTimer* timer;
+	uint32_t interruptState;
+	uint32_t count = 0;
+
+	while (1)
+	{
+		callback = NULL;
+
+		interruptState = Drv_CPUCore_DisableInterrupts();
+
+		timer = queue->head;
+		if (timer != NULL)
+		{
+			queue->head = timer->nextQueued;
+			if (queue->head == NULL)
+			{
+				queue->tail = &queue->head;
+			}
+
+			timer->flags.queued = BOOL_FALSE;
+
+			if (timer->flags.pending == BOOL_TRUE)
+			{
+				timer->flags.pending = BOOL_FALSE;
+				callback = timer->callback;
+			}
+		}
+
+		Drv_CPUCore_RestoreInterrupts(interruptState);
+
+		if (timer == NULL)
+		{
+			break;
+		}
+
+		if (callback != NULL)
+		{
+			callback();
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/*
+ * Handles an expired timer. Callback is not called here, timer is queued
+ * for timer interrupt or daemon task.
+ */
+PRIVATE void ExpireTimer(UserTimer* timer)
+{
+	if (timer->periodInTicks != 0)
+	{
+		/* Next expiry is relative to previous one to avoid drift */
+		timer->expiryTick += timer->periodInTicks;
+		Wheel_Insert(timer);
+	}
+	else
+	{
+		timer->flags.active = BOOL_FALSE;
+	}
+
+	QueueTimer((timer->flags.daemon == BOOL_TRUE) ? &service.daemonQueue : &service.isrQueue, timer);
+}
+
+/*
+ * Processes events of actual wheel tick.
+ *
+ *  Higher level slots which start at this tick are cascaded first so
+ *  timers which expire at this tick are moved into level 0.
+ */
+PRIVATE void Wheel_ProcessTick(void)
+{
+	TimerWheel* wheel = &service.wheel;
+	UserTimer** head;
+	UserTimer* timer;
+	uint32_t level;
+
+	for (level = 1; level < WHEEL_LEVEL_COUNT; level++)
+	{
+		/* Tick is not start of a slot of this level (and higher levels) */
+		if ((wheel->now & ((1UL << WHEEL_LEVEL_SHIFT(level)) - 1)) != 0)
+		{
+			break;
+		}
+
+		/* Cascaded timers are placed into lower levels (never same slot) */
+		head = &wheel->slots[level][(wheel->now >> WHEEL_LEVEL_SHIFT(level)) & WHEEL_SLOT_MASK];
+		while ((timer = *head) != NULL)
+		{
+			Wheel_Remove(timer);
+			Wheel_Insert(timer);
+		}
+	}
+
+	/* Restarted periodic timers never return to actual level 0 slot */
+	head = &wheel->slots[0][wheel->now & WHEEL_SLOT_MASK];
+	while ((timer = *head) != NULL)
+	{
+		Wheel_Remove(timer);
+		ExpireTimer(timer);
+	}
+}
+
+/*
+ * Advances wheel time and processes all events until given tick.
+ */
+PRIVATE void Wheel_Advance(uint32_t targetTick)
+{
+	TimerWheel* wheel = &service.wheel;
+	uint32_t nextTick;
+
+	/* There is no event between events so jump to next event directly */
+	while ((Wheel_NextEventTick(&nextTick) == BOOL_TRUE) &&
+	       !TICK_BEFORE(targetTick, nextTick))
+	{
+		wheel->now = nextTick;
+		Wheel_ProcessTick();
+	}
+
+	wheel->now = targetTick;
+}
+
+/*
+ * Adds elapsed time of HW Timer to wheel time and processes passed events.
+ *
+ *  [IMP] HW Timer must be restarted (see StartHWTimer()) with returned time
+ *  after each update, otherwise same elapsed time is added again.
+ *
+ * @return Elapsed time of HW Timer which is added to wheel time
+ */
+PRIVATE uint32_t UpdateTime(void)
+{
+	TimerWheel* wheel = &service.wheel;
+	uint32_t hwElapsedInUs = Drv_Timer_ReadElapsedTimeInUs(service.hwTimer);
+	uint32_t elapsedInUs = wheel->remainderInUs + hwElapsedInUs;
+
+	wheel->remainderInUs = elapsedInUs % DRV_USERTIMER_TICK_IN_US;
+
+	Wheel_Advance(wheel->now + (elapsedInUs / DRV_USERTIMER_TICK_IN_US));
+
+	return hwElapsedInUs;
+}
+
+/*
+ * Starts HW Timer to expire at nearest wheel event.
+ *
+ *  HW Timer is restarted from the point which wheel time is updated to, not
+ *  from now. So time spent in callbacks and cascades is not lost and wheel
+ *  time does not drift.
+ *
+ * @param consumedInUs Elapsed time of HW Timer which is added to wheel time
+ *        (see UpdateTime()). Zero to re-arm HW Timer without updating time.
+ */
+PRIVATE void StartHWTimer(uint32_t consumedInUs)
+{
+	TimerWheel* wheel = &service.wheel;
+	uint32_t timeoutInUs = DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US;
+	uint32_t nextTick;
+	uint32_t ticks;
+
+	/* First tick which is not before HW Timer expiry */
+	service.armedTick = wheel->now + ((wheel->remainderInUs + DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US +
+									   DRV_USERTIMER_TICK_IN_US - 1) / DRV_USERTIMER_TICK_IN_US);
+
+	if (Wheel_NextEventTick(&nextTick) == BOOL_TRUE)
+	{
+		ticks = nextTick - wheel->now;
+
+		if (ticks < (DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US / DRV_USERTIMER_TICK_IN_US))
+		{
+			service.armedTick = nextTick;
+
+			/* Part of actual tick is already elapsed */
+			timeoutInUs = (ticks * DRV_USERTIMER_TICK_IN_US) - wheel->remainderInUs;
+
+			if ((int32_t)timeoutInUs <= 0)
+			{
+				timeoutInUs = 1;
+			}
+		}
+	}
+
+	/* If timeout is already passed, HW Timer expires immediately */
+	Drv_Timer_StartFromElapsedTime(service.hwTimer, consumedInUs, timeoutInUs);
+}
+
+/*
+ * Converts a timeout to wheel ticks. Time which is elapsed since wheel time
+ * is added so timer never expires earlier than timeout.
+ */
+PRIVATE ALWAYS_INLINE uint32_t TimeoutToTicks(uint32_t timeoutInUs, uint32_t elapsedInUs)
+{
+	uint32_t ticks = (timeoutInUs / DRV_USERTIMER_TICK_IN_US) + (elapsedInUs / DRV_USERTIMER_TICK_IN_US);
+	uint32_t restInUs = (timeoutInUs % DRV_USERTIMER_TICK_IN_US) + (elapsedInUs % DRV_USERTIMER_TICK_IN_US);
+
+	ticks += (restInUs + DRV_USERTIMER_TICK_IN_US - 1) / DRV_USERTIMER_TICK_IN_US;
+
+	return (ticks == 0) ? 1 : ticks;
+}
+
+/*
+ * Starts (or restarts) a timer.
+ *
+ *  Wheel time is not updated so passed events are not processed in caller
+ *  context. Expiry is calculated from wheel time and elapsed time of HW
+ *  Timer instead. If new timer expires before HW Timer, HW Timer is re-armed
+ *  and timer interrupt processes events.
+ */
+PRIVATE void StartTimer(Drv_UserTimerHandle handle, uint32_t timeoutInUs, uint32_t periodInUs)
+{
+	UserTimer* timer;
+	uint32_t interruptState;
+	uint32_t elapsedInUs;
+
+	DEBUG_ASSERT_MESSAGE(USER_TIMER_HANDLE_IS_VALID(handle), "Invalid User Timer Handle");
+
+	timer = &service.timers[handle];
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	if (timer->flags.active == BOOL_TRUE)
+	{
+		Wheel_Remove(timer);
+	}
+
+	elapsedInUs = service.wheel.remainderInUs + Drv_Timer_ReadElapsedTimeInUs(service.hwTimer);
+
+	timer->expiryTick = service.wheel.now + TimeoutToTicks(timeoutInUs, elapsedInUs);
+	timer->periodInTicks = (periodInUs + DRV_USERTIMER_TICK_IN_US - 1) / DRV_USERTIMER_TICK_IN_US;
+	timer->flags.active = BOOL_TRUE;
+
+	Wheel_Insert(timer);
+
+	/* Reference of HW Timer is kept so wheel time is not affected */
+	if (TICK_BEFORE(timer->expiryTick, service.armedTick))
+	{
+		StartHWTimer(0);
+	}
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+}
+
+/*
+ * Interrupt Service Routine (ISR) to handle HW Timer Timeouts
+ *
+ *  Only wheel is processed with interrupts disabled. Callbacks of expired
+ *  timers are collected and called after interrupts are restored.
+ */
+PRIVATE void ISR_UserTimer(void)
+{
+	UserTimer** daemonTail;
+	uint32_t daemonNotify;
+	uint32_t interruptState = Drv_CPUCore_DisableInterrupts();
+
+	daemonTail = service.daemonQueue.tail;
+
+	StartHWTimer(UpdateTime());
+
+	/* Daemon is notified once for all timers which are queued now */
+	daemonNotify = (service.daemonQueue.tail != daemonTail) ? BOOL_TRUE : BOOL_FALSE;
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+
+	(void)CallQueuedTimers(&service.isrQueue);
+
+	if ((daemonNotify == BOOL_TRUE) && (service.daemonHook != NULL))
+	{
+		service.daemonHook();
+	}
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes User Timer service.
+ */
+PUBLIC void Drv_UserTimer_Init(TimerNo hwTimerNo)
+{
+	service.isrQueue.tail = &service.isrQueue.head;
+	service.daemonQueue.tail = &service.daemonQueue.head;
+
+	service.hwTimer = Drv_Timer_Create(hwTimerNo, DRV_TIMER_PRI_NORMAL, ISR_UserTimer);
+
+	/* Wheel time starts now */
+	Drv_Timer_Start(service.hwTimer, DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US);
+	service.armedTick = service.wheel.now + (DRV_USERTIMER_MAX_HW_TIMEOUT_IN_US / DRV_USERTIMER_TICK_IN_US);
+}
+
+/*
+ * Creates a User Timer.
+ */
+PUBLIC Drv_UserTimerHandle Drv_UserTimer_Create(Drv_UserTimerCallback userTimerCB,
+												Drv_UserTimerContext context)
+{
+	Drv_UserTimerHandle handle = DRV_USERTIMER_INVALID_HANDLE;
+	UserTimer* timer;
+	uint32_t interruptState;
+	int32_t i;
+
+	DEBUG_ASSERT_MESSAGE(userTimerCB != NULL, "Invalid (NULL) Callback!");
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	for (i = 0; i < NUM_OF_USER_TIMERS; i++)
+	{
+		timer = &service.timers[i];
+
+		/* A removed timer can be still in a callback queue */
+		if ((timer->flags.allocated == BOOL_FALSE) && (timer->flags.queued == BOOL_FALSE))
+		{
+			timer->callback = userTimerCB;
+			timer->flags.allocated = BOOL_TRUE;
+			timer->flags.active = BOOL_FALSE;
+			timer->flags.pending = BOOL_FALSE;
+			timer->flags.daemon = (context == DRV_USERTIMER_CONTEXT_DAEMON) ? BOOL_TRUE : BOOL_FALSE;
+
+			handle = i;
+			break;
+		}
+	}
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+
+	return handle;
+}
+
+/*
+ * Stops and releases a User Timer.
+ */
+PUBLIC void Drv_UserTimer_Remove(Drv_UserTimerHandle timer)
+{
+	uint32_t interruptState;
+
+	Drv_UserTimer_Stop(timer);
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+	service.timers[timer].flags.allocated = BOOL_FALSE;
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+}
+
+/*
+ * Starts a one shot User Timer.
+ */
+PUBLIC void Drv_UserTimer_Start(Drv_UserTimerHandle timer, uint32_t timeoutInUs)
+{
+	StartTimer(timer, timeoutInUs, 0);
+}
+
+/*
+ * Starts a periodic User Timer.
+ */
+PUBLIC void Drv_UserTimer_StartPeriodic(Drv_UserTimerHandle timer, uint32_t periodInUs)
+{
+	StartTimer(timer, periodInUs, periodInUs);
+}
+
+/*
+ * Stops a User Timer.
+ *
+ *  HW Timer is not restarted, it may expire for a removed wheel event which
+ *  is harmless.
+ */
+PUBLIC void Drv_UserTimer_Stop(Drv_UserTimerHandle handle)
+{
+	UserTimer* timer;
+	uint32_t interruptState;
+
+	DEBUG_ASSERT_MESSAGE(USER_TIMER_HANDLE_IS_VALID(handle), "Invalid User Timer Handle");
+
+	timer = &service.timers[handle];
+
+	interruptState = Drv_CPUCore_DisableInterrupts();
+
+	if (timer->flags.active == BOOL_TRUE)
+	{
+		Wheel_Remove(timer);
+		timer->flags.active = BOOL_FALSE;
+	}
+
+	/* Queued timer leaves its queue without calling its callback */
+	timer->flags.pending = BOOL_FALSE;
+
+	Drv_CPUCore_RestoreInterrupts(interruptState);
+}
+
+/*
+ * Calls deferred callbacks of expired timers.
+ */
+PUBLIC uint32_t Drv_UserTimer_RunDaemon(void)
+{
+	/* Callbacks are called with interrupts enabled */
+	return CallQueuedTimers(&service.daemonQueue);
+}
+
+/*
+ * Sets daemon notification hook.
+ */
+PUBLIC void Drv_UserTimer_SetDaemonHook(Drv_UserTimerCallback hook)
+{
+	service.daemonHook = hook;
+}
+
+/*
+ * Busy waits for given time.
+ *
+ *  Uses CPU cycle counter which is enabled in Drv_CPUCore_Init().
+ */
+PUBLIC void Drv_UserTimer_DelayUs(uint32_t microseconds)
+{
+	uint32_t startCycle = Drv_CPUCore_ReadCycleCounter();
+	uint32_t cycles = microseconds * (SystemCoreClock / 1000000);
+
+	while (Drv_CPUCore_ElapsedCycles(startCycle) < cycles);
+}
+
+/*
+ * Busy waits for given time.
+ */
+PUBLIC void Drv_UserTimer_DelayMs(uint32_t milliseconds)
+{
+	while (milliseconds--)
+	{
+		Drv_UserTimer_DelayUs(1000);
+	}
+}
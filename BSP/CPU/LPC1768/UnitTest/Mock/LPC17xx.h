@@ -61,6 +61,9 @@
 #define SCB_ICSR_PENDSVSET_Pos             28U                                            /*!< SCB ICSR: PENDSVSET Position */
 #define SCB_ICSR_PENDSVSET_Msk             (1UL << SCB_ICSR_PENDSVSET_Pos)                /*!< SCB ICSR: PENDSVSET Mask */
 
+#define DWT_CTRL_CYCCNTENA_Msk             (0x1UL)                                        /*!< DWT CTRL: CYCCNTENA Mask */
+#define CoreDebug_DEMCR_TRCENA_Msk         (1UL << 24U)                                   /*!< CoreDebug DEMCR: TRCENA Mask */
+
 /*
  * splint (Static Code Analysis Tool) gives error if a object is not used but
  * we may not need to use some object in scope of Unit Testing.
@@ -147,6 +150,20 @@ typedef struct
     uint32_t CPACR;                  /*!< Offset: 0x088 (R/W)  Coprocessor Access Control Register */
 } SCB_Type;
 
+typedef struct
+{
+	uint32_t CTRL;                   /*!< Offset: 0x000 (R/W)  Control Register */
+	uint32_t CYCCNT;                 /*!< Offset: 0x004 (R/W)  Cycle Count Register */
+} DWT_Type;
+
+typedef struct
+{
+	uint32_t DHCSR;                  /*!< Offset: 0x000 (R/W)  Debug Halting Control and Status Register */
+	uint32_t DCRSR;                  /*!< Offset: 0x004 ( /W)  Debug Core Register Selector Register */
+	uint32_t DCRDR;                  /*!< Offset: 0x008 (R/W)  Debug Core Register Data Register */
+	uint32_t DEMCR;                  /*!< Offset: 0x00C (R/W)  Debug Exception and Monitor Control Register */
+} CoreDebug_Type;
+
 typedef struct
 {
     uint32_t PINSEL0;
@@ -283,6 +300,8 @@ extern void POS_PendSV_Handler(void);
  * Register Definitions
  */
 MOCK_REG_DEF(SCB_Type, SCB);
+MOCK_REG_DEF(DWT_Type, DWT);
+MOCK_REG_DEF(CoreDebug_Type, CoreDebug);
 MOCK_REG_DEF(LPC_PINCON_TypeDef, LPC_PINCON);
 MOCK_REG_DEF(LPC_GPIO_TypeDef, LPC_GPIO0);
 MOCK_REG_DEF(LPC_TIM_TypeDef, LPC_TIM0);
@@ -310,6 +329,8 @@ SPLINT_SUPPRESS_UNUSED_ERROR
 static INLINE void ResetRegistersAndObjects(void)
 {
 	memset(SCB, 0, sizeof(SCB_Type));
+	memset(DWT, 0, sizeof(DWT_Type));
+	memset(CoreDebug, 0, sizeof(CoreDebug_Type));
 	memset(LPC_PINCON, 0, sizeof(LPC_PINCON_TypeDef));
 	memset(LPC_GPIO0, 0, sizeof(LPC_GPIO_TypeDef));
 	memset(LPC_TIM0, 0, sizeof(LPC_TIM_TypeDef));
@@ -358,6 +379,24 @@ static INLINE void __enable_irq(void)
 	lpcMockObjects.flags.interrupt_disabled = 0;
 }
 
+/*
+ * Mock Implementation for reading PRIMASK (interrupt disable state)
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE uint32_t __get_PRIMASK(void)
+{
+	return lpcMockObjects.flags.interrupt_disabled;
+}
+
+/*
+ * Mock Implementation for writing PRIMASK (interrupt disable state)
+ */
+SPLINT_SUPPRESS_UNUSED_ERROR
+static INLINE void __set_PRIMASK(uint32_t priMask)
+{
+	lpcMockObjects.flags.interrupt_disabled = priMask & 1;
+}
+
 /*
  * Mock Implementation for NVIC_SetPriority
  */
@@ -39,4 +39,9 @@
 
 /********************************* INCLUDES ***********************************/
 
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Debug Assertion */
+#define ENABLE_DEBUG_ASSERT					0
+
 #endif
@@ -0,0 +1,111 @@
+/*******************************************************************************
+ *
+ * @file mock_CPUCore.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock Implementation for CPU Core Driver
+ *
+ * Used by tests of drivers which are built on CPU Core Driver. Keeps nesting
+ * level of critical sections and simulates cycle counter.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_CPUCore.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Mock CPU Core Object
+ */
+typedef struct
+{
+	/* Cycle counter. Moves forward at each elapsed cycle request. */
+	uint32_t cycleCounter;
+	/* Nesting level of critical sections. Zero if interrupts are enabled. */
+	uint32_t criticalSectionLevel;
+} MockCPUCore;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Mock CPU Core
+ */
+static MockCPUCore mockCPUCore;
+
+/********************************** FUNCTIONS *********************************/
+
+/*
+ * Resets mock CPU Core
+ */
+static INLINE void MockCPUCore_Reset(void)
+{
+	memset(&mockCPUCore, 0, sizeof(mockCPUCore));
+}
+
+/*
+ * Mock Implementation of Drv_CPUCore_DisableInterrupts
+ */
+uint32_t Drv_CPUCore_DisableInterrupts(void)
+{
+	return mockCPUCore.criticalSectionLevel++;
+}
+
+/*
+ * Mock Implementation of Drv_CPUCore_RestoreInterrupts
+ */
+void Drv_CPUCore_RestoreInterrupts(uint32_t state)
+{
+	mockCPUCore.criticalSectionLevel = state;
+}
+
+/*
+ * Mock Implementation of Drv_CPUCore_ReadCycleCounter
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void)
+{
+	return mockCPUCore.cycleCounter;
+}
+
+/*
+ * Mock Implementation of Drv_CPUCore_ElapsedCycles
+ *
+ *  Each request takes a cycle so busy waits end.
+ */
+uint32_t Drv_CPUCore_ElapsedCycles(uint32_t startCycle)
+{
+	mockCPUCore.cycleCounter++;
+
+	return mockCPUCore.cycleCounter - startCycle;
+}
@@ -0,0 +1,185 @@
+/*******************************************************************************
+ *
+ * @file mock_Timer.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock Implementation for Timer Driver
+ *
+ * Simulates a one shot HW Timer channel on a free running microsecond
+ * counter. Tests move counter forward and timeout callback is called when
+ * counter reaches end of timeout like an actual match interrupt.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_Timer.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Mock Timer Object
+ */
+typedef struct
+{
+	/* Registered client callback */
+	DrvTimerCallback callback;
+	/* Free running counter in microseconds */
+	uint32_t counter;
+	/* Counter value which actual timeout starts from */
+	uint32_t startCount;
+	/* Actual timeout value */
+	uint32_t timeoutInUs;
+	/* Timer is started and its timeout is not expired yet */
+	uint32_t armed;
+	/* Number of timer start requests from now */
+	uint32_t restartCount;
+	/* Number of timer start requests from a point of current run */
+	uint32_t rearmCount;
+} MockTimer;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Mock Timer. There is only one (user timer) HW timer in tests.
+ */
+static MockTimer mockTimer;
+
+/********************************** FUNCTIONS *********************************/
+
+/*
+ * Resets mock timer
+ */
+static INLINE void MockTimer_Reset(void)
+{
+	memset(&mockTimer, 0, sizeof(mockTimer));
+}
+
+/*
+ * Calls callback if timeout is expired. Callback may restart timer or move
+ * counter (e.g. to simulate a long callback) so check is repeated.
+ */
+static void MockTimer_Expire(void)
+{
+	while ((mockTimer.armed == BOOL_TRUE) &&
+		   ((mockTimer.counter - mockTimer.startCount) >= mockTimer.timeoutInUs))
+	{
+		mockTimer.armed = BOOL_FALSE;
+		mockTimer.callback();
+	}
+}
+
+/*
+ * Moves counter forward and calls timeout callback at each expiry on the
+ * way.
+ */
+static void MockTimer_Advance(uint32_t timeInUs)
+{
+	uint32_t target = mockTimer.counter + timeInUs;
+	uint32_t toExpiry;
+
+	MockTimer_Expire();
+
+	while (mockTimer.armed == BOOL_TRUE)
+	{
+		toExpiry = mockTimer.timeoutInUs - (mockTimer.counter - mockTimer.startCount);
+
+		if (toExpiry > (target - mockTimer.counter))
+		{
+			break;
+		}
+
+		mockTimer.counter += toExpiry;
+		MockTimer_Expire();
+
+		/* Callback may have consumed more time than requested */
+		if ((int32_t)(mockTimer.counter - target) >= 0)
+		{
+			break;
+		}
+	}
+
+	if ((int32_t)(target - mockTimer.counter) > 0)
+	{
+		mockTimer.counter = target;
+	}
+}
+
+/*
+ * Mock Implementation of Drv_Timer_Create
+ */
+TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
+{
+	(void)timerNo;
+	(void)priority;
+
+	mockTimer.callback = timerCallback;
+
+	return (TimerHandle)1;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_Start
+ */
+void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
+{
+	(void)timerHandle;
+
+	mockTimer.startCount = mockTimer.counter;
+	mockTimer.timeoutInUs = timeoutInUs;
+	mockTimer.armed = BOOL_TRUE;
+	mockTimer.restartCount++;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_StartFromElapsedTime
+ */
+void Drv_Timer_StartFromElapsedTime(TimerHandle timerHandle, uint32_t elapsedInUs, uint32_t timeoutInUs)
+{
+	(void)timerHandle;
+
+	mockTimer.startCount += elapsedInUs;
+	mockTimer.timeoutInUs = timeoutInUs;
+	mockTimer.armed = BOOL_TRUE;
+	mockTimer.rearmCount++;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_ReadElapsedTimeInUs
+ */
+uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
+{
+	(void)timerHandle;
+
+	return mockTimer.counter - mockTimer.startCount;
+}
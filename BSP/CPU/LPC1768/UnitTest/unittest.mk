@@ -34,4 +34,6 @@
 #
 ################################################################################
 
-TEST_TARGET_NAME=CPUCore
+# All test targets are run by default. A single target is selected on
+# command line (e.g. TEST_TARGET_NAME=UserTimer)
+TEST_TARGET_NAMES=CPUCore UserTimer
@@ -106,15 +106,16 @@ void taskStartPoint(void* arg)
 /*
  * Tests CPU Init function.
  *
- * CPU_Init() does not do anything(it is an empty function) so nothing to test.
- * Function just called to complete Code Coverage.
+ * CPU_Init() only enables cycle counter for profiling.
  *
  */
 void test_CPU_Init(void)
 {
 	Drv_CPUCore_Init();
 
-	TEST_ASSERT(1);
+	/* Trace unit and its cycle counter must be enabled */
+	TEST_ASSERT((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) != 0);
+	TEST_ASSERT((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0);
 }
 
 /*
@@ -177,6 +178,83 @@ void test_CPU_CS_YieldTo(void)
 	TEST_ASSERT((currentTCB == &newTCB));
 }
 
+/*
+ * Tests that context switching hook is called on context switch
+ */
+static uint32_t csHookCallCount;
+static reg32_t* csHookCurrentTCB;
+
+static void TestCSHook(void)
+{
+	csHookCallCount++;
+	/* Hook must be called after next TCB is selected */
+	csHookCurrentTCB = currentTCB;
+}
+
+void test_CPU_CS_Hook(void)
+{
+	/* Content of This TCB is not important for us. */
+	static reg32_t newTCB;
+
+	csHookCallCount = 0;
+	csHookCurrentTCB = NULL;
+
+	Drv_CPUCore_CSSetHook(TestCSHook);
+	Drv_CPUCore_CSYieldTo(&newTCB);
+
+	TEST_ASSERT((csHookCallCount == 1));
+	TEST_ASSERT((csHookCurrentTCB == &newTCB));
+
+	/* Hook is not called anymore after it is removed */
+	Drv_CPUCore_CSSetHook(NULL);
+	Drv_CPUCore_CSYieldTo(&newTCB);
+
+	TEST_ASSERT((csHookCallCount == 1));
+}
+
+/*
+ * Tests cycle counter and elapsed cycle calculation including wrap around
+ */
+void test_CPU_CycleCounter(void)
+{
+	uint32_t startCycle;
+
+	DWT->CYCCNT = 1000;
+	startCycle = Drv_CPUCore_ReadCycleCounter();
+	TEST_ASSERT((startCycle == 1000));
+
+	DWT->CYCCNT = 1500;
+	TEST_ASSERT((Drv_CPUCore_ElapsedCycles(startCycle) == 500));
+
+	/* Counter wraps around */
+	DWT->CYCCNT = 0xFFFFFFF0UL;
+	startCycle = Drv_CPUCore_ReadCycleCounter();
+	DWT->CYCCNT = 0x10;
+	TEST_ASSERT((Drv_CPUCore_ElapsedCycles(startCycle) == 0x20));
+}
+
+/*
+ * Tests that nested critical sections enable interrupts only at the end of
+ * outermost one
+ */
+void test_CPU_CriticalSection(void)
+{
+	uint32_t outerState;
+	uint32_t innerState;
+
+	lpcMockObjects.flags.interrupt_disabled = 0;
+
+	outerState = Drv_CPUCore_DisableInterrupts();
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 1));
+
+	innerState = Drv_CPUCore_DisableInterrupts();
+	Drv_CPUCore_RestoreInterrupts(innerState);
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 1));
+
+	Drv_CPUCore_RestoreInterrupts(outerState);
+	TEST_ASSERT((lpcMockObjects.flags.interrupt_disabled == 0));
+}
+
 /*
  * Tests Stack Initialization
  */
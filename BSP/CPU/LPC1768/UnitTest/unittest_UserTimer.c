@@ -0,0 +1,395 @@
+/*******************************************************************************
+ *
+ * @file unittest_UserTimer.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for User Timer Driver
+ *
+ *        Run with 'make unittest TEST_MODULE=BSP/CPU/LPC1768' (all tests of
+ *        module) or with 'TEST_TARGET_NAME=UserTimer' (only this test)
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include <string.h>
+
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "Mock/mock_CPUCore.c"
+#include "Mock/mock_Timer.c"
+
+/* Include User Timer source file for WHITE-BOX unit testing */
+#include "../Drv_UserTimer.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Any HW Timer, it is not used by mock timer */
+#define TEST_HW_TIMER_NO					(0)
+
+/* Maximum number of recorded callback calls */
+#define TEST_MAX_NUM_OF_CALLS				(128)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Record of callback calls
+ */
+typedef struct
+{
+	/* Number of callback calls */
+	uint32_t count;
+	/* Counter of HW Timer at each call */
+	uint32_t timesInUs[TEST_MAX_NUM_OF_CALLS];
+	/* Time which is consumed by each callback */
+	uint32_t durationInUs;
+	/* Number of daemon notifications */
+	uint32_t daemonNotifyCount;
+	/* Number of callback calls with interrupts disabled */
+	uint32_t disabledInterruptCount;
+} CallRecord;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Callback calls of tests
+ */
+static CallRecord callRecord;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	MockCPUCore_Reset();
+	MockTimer_Reset();
+
+	memset(&service, 0, sizeof(service));
+	memset(&callRecord, 0, sizeof(callRecord));
+
+	Drv_UserTimer_Init(TEST_HW_TIMER_NO);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* All critical sections must be closed */
+	TEST_ASSERT_EQUAL_UINT32(0, mockCPUCore.criticalSectionLevel);
+}
+
+/*
+ * Test callback which records its calls and consumes given time
+ */
+static void TestCallback(void)
+{
+	if (callRecord.count < TEST_MAX_NUM_OF_CALLS)
+	{
+		callRecord.timesInUs[callRecord.count] = mockTimer.counter;
+	}
+	callRecord.count++;
+
+	if (mockCPUCore.criticalSectionLevel != 0)
+	{
+		callRecord.disabledInterruptCount++;
+	}
+
+	mockTimer.counter += callRecord.durationInUs;
+}
+
+/*
+ * Test daemon hook
+ */
+static void TestDaemonHook(void)
+{
+	callRecord.daemonNotifyCount++;
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests a one shot timer which is kept in first level of wheel.
+ */
+void test_TimerExpiresAtTimeout(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+
+	Drv_UserTimer_Start(timer, 1000);
+
+	TEST_ASSERT_EQUAL_UINT32(0, service.timers[timer].level);
+
+	MockTimer_Advance(999);
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+
+	MockTimer_Advance(1);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(1000, callRecord.timesInUs[0]);
+	TEST_ASSERT(service.timers[timer].flags.active == BOOL_FALSE);
+
+	/* Callback is called after wheel is processed with interrupts enabled */
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.disabledInterruptCount);
+
+	/* One shot timer does not expire again */
+	MockTimer_Advance(10000);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+}
+
+/*
+ * Tests a timer which is kept in a higher level and cascaded down to first
+ * level before its expiry.
+ */
+void test_TimerIsCascadedFromHigherLevels(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+
+	/* 50 ms does not fit in first level, wheel time is not zero */
+	MockTimer_Advance(1234);
+	Drv_UserTimer_Start(timer, 50000);
+
+	TEST_ASSERT(service.timers[timer].level > 0);
+
+	MockTimer_Advance(49999);
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+
+	/* Timer is cascaded down to first level before its expiry */
+	TEST_ASSERT_EQUAL_UINT32(0, service.timers[timer].level);
+
+	/* Timeout is rounded up to ticks */
+	MockTimer_Advance(DRV_USERTIMER_TICK_IN_US);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+	TEST_ASSERT(callRecord.timesInUs[0] >= 1234 + 50000);
+	TEST_ASSERT(callRecord.timesInUs[0] < 1234 + 50000 + DRV_USERTIMER_TICK_IN_US);
+}
+
+/*
+ * Tests a timer which is beyond wheel range. Timer is parked at end of wheel
+ * and it is inserted again until it fits in wheel.
+ */
+void test_FarTimerIsParked(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	uint32_t timeoutInUs = 2 * WHEEL_RANGE_IN_TICKS * DRV_USERTIMER_TICK_IN_US;
+
+	Drv_UserTimer_Start(timer, timeoutInUs);
+
+	/* Timer is parked in last level */
+	TEST_ASSERT_EQUAL_UINT32(WHEEL_LEVEL_COUNT - 1, service.timers[timer].level);
+	TEST_ASSERT_EQUAL_UINT32(2 * WHEEL_RANGE_IN_TICKS, service.timers[timer].expiryTick);
+
+	MockTimer_Advance(timeoutInUs - 1);
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+
+	MockTimer_Advance(1);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(timeoutInUs, callRecord.timesInUs[0]);
+}
+
+/*
+ * Tests a periodic timer which is re-armed from its expiry tick.
+ */
+void test_PeriodicTimerIsRearmed(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	uint32_t i;
+
+	/* Period is longer than first level so each period is cascaded */
+	Drv_UserTimer_StartPeriodic(timer, 50000);
+
+	MockTimer_Advance(1000000);
+
+	TEST_ASSERT_EQUAL_UINT32(20, callRecord.count);
+	for (i = 0; i < callRecord.count; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32((i + 1) * 50000, callRecord.timesInUs[i]);
+	}
+
+	/* Timer is still active for next period */
+	TEST_ASSERT(service.timers[timer].flags.active == BOOL_TRUE);
+}
+
+/*
+ * Tests that time spent in callbacks is not lost. HW Timer is restarted from
+ * point which wheel time is updated to, not from end of callbacks.
+ */
+void test_WheelTimeDoesNotDrift(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	uint32_t i;
+
+	/* A slow callback, not a multiple of tick */
+	callRecord.durationInUs = 130;
+
+	Drv_UserTimer_StartPeriodic(timer, 1000);
+
+	MockTimer_Advance(100000);
+
+	TEST_ASSERT_EQUAL_UINT32(100, callRecord.count);
+	for (i = 0; i < callRecord.count; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32((i + 1) * 1000, callRecord.timesInUs[i]);
+	}
+
+	/* HW Timer is restarted from now only once at init */
+	TEST_ASSERT_EQUAL_UINT32(1, mockTimer.restartCount);
+}
+
+/*
+ * Tests a timer which is started before an expired (but not handled yet)
+ * timer. Expired timer is not processed in caller context.
+ */
+void test_StartDoesNotProcessEvents(void)
+{
+	Drv_UserTimerHandle expired = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+
+	Drv_UserTimer_Start(expired, 1000);
+
+	/* Timer interrupt is pending */
+	mockTimer.counter += 1550;
+
+	Drv_UserTimer_Start(timer, 500);
+
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(0, service.wheel.now);
+
+	/* Timeout is counted from now, not from wheel time */
+	TEST_ASSERT_EQUAL_UINT32(21, service.timers[timer].expiryTick);
+
+	/* Pending interrupt handles only expired timer */
+	MockTimer_Expire();
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+
+	MockTimer_Advance(549);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+
+	MockTimer_Advance(1);
+	TEST_ASSERT_EQUAL_UINT32(2, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(2100, callRecord.timesInUs[1]);
+}
+
+/*
+ * Tests a timer which expires earlier than armed HW Timer. HW Timer is
+ * re-armed without changing wheel time.
+ */
+void test_EarlierTimerRearmsHWTimer(void)
+{
+	Drv_UserTimerHandle later = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	uint32_t rearmCount;
+
+	Drv_UserTimer_Start(later, 10000);
+	MockTimer_Advance(1000);
+
+	Drv_UserTimer_Start(timer, 500);
+
+	/* HW Timer still counts from wheel time */
+	TEST_ASSERT_EQUAL_UINT32(0, mockTimer.startCount);
+	TEST_ASSERT_EQUAL_UINT32(1500, mockTimer.timeoutInUs);
+
+	MockTimer_Advance(500);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(1500, callRecord.timesInUs[0]);
+
+	/* A later timer does not re-arm HW Timer */
+	rearmCount = mockTimer.rearmCount;
+	Drv_UserTimer_Start(timer, 20000);
+	TEST_ASSERT_EQUAL_UINT32(rearmCount, mockTimer.rearmCount);
+
+	MockTimer_Advance(8500);
+	TEST_ASSERT_EQUAL_UINT32(2, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(10000, callRecord.timesInUs[1]);
+}
+
+/*
+ * Tests a stopped timer.
+ */
+void test_StoppedTimerDoesNotExpire(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+
+	Drv_UserTimer_Start(timer, 5000);
+	MockTimer_Advance(2000);
+
+	Drv_UserTimer_Stop(timer);
+	TEST_ASSERT_EQUAL_UINT32(0, service.wheel.occupied[0]);
+
+	MockTimer_Advance(10000);
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+}
+
+/*
+ * Tests a daemon timer which is stopped after it is queued for daemon.
+ */
+void test_StopWhileQueuedSkipsCallback(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_DAEMON);
+
+	Drv_UserTimer_SetDaemonHook(TestDaemonHook);
+
+	Drv_UserTimer_Start(timer, 1000);
+	MockTimer_Advance(1000);
+
+	/* Callback is deferred to daemon */
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.daemonNotifyCount);
+	TEST_ASSERT(service.timers[timer].flags.queued == BOOL_TRUE);
+
+	Drv_UserTimer_Stop(timer);
+
+	/* Timer leaves queue without calling its callback */
+	TEST_ASSERT_EQUAL_UINT32(0, Drv_UserTimer_RunDaemon());
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+	TEST_ASSERT(service.timers[timer].flags.queued == BOOL_FALSE);
+	TEST_ASSERT(service.daemonQueue.head == NULL);
+
+	/* Timer can be used again */
+	Drv_UserTimer_Start(timer, 1000);
+	MockTimer_Advance(1000);
+	TEST_ASSERT_EQUAL_UINT32(1, Drv_UserTimer_RunDaemon());
+	TEST_ASSERT_EQUAL_UINT32(1, callRecord.count);
+}
+
+/*
+ * Tests a daemon timer which is removed while it is queued for daemon.
+ */
+void test_RemovedQueuedTimerIsNotReused(void)
+{
+	Drv_UserTimerHandle timer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_DAEMON);
+	Drv_UserTimerHandle newTimer;
+
+	Drv_UserTimer_Start(timer, 1000);
+	MockTimer_Advance(1000);
+
+	Drv_UserTimer_Remove(timer);
+
+	/* Queued timer object is not given to a new timer until it is dequeued */
+	newTimer = Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR);
+	TEST_ASSERT(newTimer != timer);
+
+	TEST_ASSERT_EQUAL_UINT32(0, Drv_UserTimer_RunDaemon());
+	TEST_ASSERT_EQUAL_UINT32(0, callRecord.count);
+
+	Drv_UserTimer_Remove(newTimer);
+	TEST_ASSERT_EQUAL_INT32(timer, Drv_UserTimer_Create(TestCallback, DRV_USERTIMER_CONTEXT_ISR));
+}
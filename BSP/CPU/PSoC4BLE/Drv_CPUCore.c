@@ -48,6 +48,9 @@
 /* Initial Stack Value for Program Status Register (PSR) . */
 #define TASK_INITIAL_PSR				(0x01000000)
 
+/* SysTick is a 24 bit counter */
+#define SYSTICK_COUNTER_MASK			(0x00FFFFFFUL)
+
 /***************************** TYPE DEFINITIONS *******************************/
 /*
  * Map for Stack Initialization of a Task Stack
@@ -96,6 +99,12 @@ INTERNAL reg32_t* currentTCB;
  */
 PRIVATE reg32_t* nextTCB;
 
+/*
+ * Context switching hook of client.
+ * Called on each context switch if it is set.
+ */
+PRIVATE Drv_CPUCore_CSHook csHook;
+
 /**************************** PRIVATE FUNCTIONS ******************************/
 
 /*
@@ -113,6 +122,26 @@ INTERNAL void SwitchContext(void)
 	currentTCB = nextTCB;
 }
 
+/*
+ * Runs context switching hook of client.
+ *
+ *  Cortex-M0 does not have BASEPRI to mask only kernel interrupts so TCB is
+ *  switched with all interrupts disabled (see SwitchContext()) and hook is
+ *  called after it with interrupts enabled. Hook may take long (e.g. deferred
+ *  works of scheduler) and does not block interrupts.
+ *
+ * This function is marked as Internal because it is called from Assembly
+ * context switching handler.
+ */
+INTERNAL void RunContextSwitchHook(void)
+{
+	/* Let client run its deferred works before switched task starts */
+	if (csHook != NULL)
+	{
+		csHook();
+	}
+}
+
 /*
  *  A task must not exit or return to its caller. If so break all execution.
  */
@@ -138,6 +167,14 @@ void Drv_CPUCore_Init(void)
 
     /* set pendSV interrupt to lowest possible priority */
     NVIC_SetPriority(PendSV_IRQn, 0xff);
+
+    /*
+     * Start SysTick as a free running counter (without interrupt) to use it
+     * as cycle counter for profiling.
+     */
+    SysTick->LOAD = SYSTICK_COUNTER_MASK;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
 }
 
 /*
@@ -197,6 +234,61 @@ void Drv_CPUCore_CSYieldTo(reg32_t* newTCB)
     __DMB();
 }
 
+/*
+ * Sets context switching hook
+ *
+ * @param hook to be called hook on each context switch. NULL removes hook.
+ *
+ * @return none
+ */
+void Drv_CPUCore_CSSetHook(Drv_CPUCore_CSHook hook)
+{
+	csHook = hook;
+}
+
+/*
+ * Disables interrupts to start a critical section.
+ *
+ *  PRIMASK is saved so nested critical sections do not enable interrupts.
+ */
+uint32_t Drv_CPUCore_DisableInterrupts(void)
+{
+	uint32_t state = __get_PRIMASK();
+
+	__disable_irq();
+
+	return state;
+}
+
+/*
+ * Restores interrupt state at the end of a critical section.
+ */
+void Drv_CPUCore_RestoreInterrupts(uint32_t state)
+{
+	__set_PRIMASK(state);
+}
+
+/*
+ * Reads free running CPU cycle counter for profiling.
+ *
+ *  Cortex-M0 does not have a cycle counter (DWT) so 24 bit SysTick counter is
+ *  used which is started as free running in Drv_CPUCore_Init(). SysTick
+ *  counts down so value is inverted to obtain an up counter.
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void)
+{
+	return (SYSTICK_COUNTER_MASK - SysTick->VAL) & SYSTICK_COUNTER_MASK;
+}
+
+/*
+ * Calculates elapsed CPU cycles since a cycle counter value.
+ */
+uint32_t Drv_CPUCore_ElapsedCycles(uint32_t startCycle)
+{
+	/* Counter is 24 bit so mask wrapped subtraction result */
+	return (Drv_CPUCore_ReadCycleCounter() - startCycle) & SYSTICK_COUNTER_MASK;
+}
+
 /*
  * Initializes task stack according to Cortex-M3 Architecture.
  *
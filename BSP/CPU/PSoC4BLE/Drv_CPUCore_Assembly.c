@@ -116,6 +116,7 @@ ASSEMBLY_FUNCTION void POS_PendSV_Handler(void)
 			"	cpsid i								\n"
 			"	bl SwitchContext					\n"
 			"	cpsie i								\n"
+			"	bl RunContextSwitchHook				\n" /* Hook is run with interrupts enabled. */
 			"	pop {r2, r3}						\n" /* lr goes in r3. r2 now holds tcb pointer. */
 			"										\n"
 			"	ldr r1, [r2]						\n"
@@ -16,6 +16,9 @@
  *          Timer counter is reset only when Timer is reset using reset pin.
  *          Timer module creates an interrupts only on match.
  *
+ *          Custom timer has no auto reload so periodic timers are restarted
+ *          using reset pin as the first thing in ISR.
+ *
  *			Timer resolution is 1 microsecond and Timer HW configured according
  *          to this setting in PSoC Creator IDE.
  *
@@ -144,6 +147,12 @@ typedef struct
 
 	/* Client callback function to inform client about Timer Timeout */
 	DrvTimerCallback callback;
+	/* Whether timer is started or stopped */
+	uint32_t running;
+	/* Period of timer. Zero for one shot timers. */
+	uint32_t periodInUs;
+	/* Number of periods which are missed because of overruns */
+	uint32_t missedPeriods;
 } Timer;
 
 /**************************** FUNCTION PROTOTYPES *****************************/
@@ -170,6 +179,8 @@ PRIVATE const uint32_t timerIRQPriorities[] =
 
 CY_ISR(TIMER0_IRQHandler)
 {
+    uint32_t elapsedInUs;
+
     /*
      * Read Status register in order to clear the sticky Terminal Count (TC) bit
 	 * in the status register. Note that the function is not called, but rather
@@ -177,8 +188,45 @@ CY_ISR(TIMER0_IRQHandler)
 	 */
     TIMER0_TIMER_STATUS;
 
+    if (timers[0].running == BOOL_FALSE)
+    {
+        /* Timer is stopped */
+        return;
+    }
+
+    if (timers[0].periodInUs != 0)
+    {
+        /* Restart periodic timer first, so period does not include callback */
+        TIMER0_Reset();
+    }
+    else
+    {
+        /* One shot timer is stopped on match */
+        timers[0].running = BOOL_FALSE;
+    }
+
     /* Call user callback to inform about Timer Timeout */
     timers[0].callback();
+
+    /*
+     * If next periods are matched while client is informed, client overruns
+     * its period. Drop those periods and count all of them as missed.
+     * Counter is reset at start of callback so it gives passed periods.
+     */
+    if (timers[0].periodInUs != 0)
+    {
+        elapsedInUs = TIMER0_ReadCounter();
+
+        if (elapsedInUs >= timers[0].periodInUs)
+        {
+            TIMER0_TIMER_STATUS;
+            TIMER0_IRQn_ClearPending();
+
+            timers[0].missedPeriods += elapsedInUs / timers[0].periodInUs;
+
+            TIMER0_Reset();
+        }
+    }
 }
 
 /***************************** PUBLIC FUNCTIONS *******************************/
@@ -232,6 +280,23 @@ PUBLIC TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority,
 	return (TimerHandle)timer;
 }
 
+/*
+ * Creates a SW Timer which matches with a channel of HW Timer.
+ *
+ *  PSoC Timer component provides just one compare channel so only channel 0
+ *  is supported.
+ */
+PUBLIC TimerHandle Drv_Timer_CreateChannel(TimerNo timerNo,
+										   uint32_t channelNo,
+										   DrvTimerPriority priority,
+										   DrvTimerCallback timerCallback)
+{
+	DEBUG_ASSERT_MESSAGE((channelNo == 0), "Invalid Timer Channel!");
+	(void)channelNo;
+
+	return Drv_Timer_Create(timerNo, priority, timerCallback);
+}
+
 /*
  * Starts a Timer.
  *
@@ -256,6 +321,9 @@ PUBLIC void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
     if (timerNo == 0)
 #endif
     {
+        timers[0].periodInUs = 0;
+        timers[0].running = BOOL_TRUE;
+
         /* Set compare value */
         TIMER0_SetCompareValue(timeoutInUs);
 
@@ -264,6 +332,85 @@ PUBLIC void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
     }
 }
 
+/*
+ * Starts a Timer from its last timeout.
+ *
+ *  [IMP] Custom HW Timer stops on match and it is reset to start so time
+ *  after last timeout is not known. Timer is just started from now.
+ */
+PUBLIC void Drv_Timer_StartFromLastTimeout(TimerHandle timerHandle, uint32_t timeoutInUs)
+{
+    Drv_Timer_Start(timerHandle, timeoutInUs);
+}
+
+/*
+ * Starts a Timer from a point of its current run.
+ *
+ *  [IMP] Custom HW Timer is reset to start so elapsed part of timeout is
+ *  subtracted. Time between reading elapsed time and reset is still lost.
+ */
+PUBLIC void Drv_Timer_StartFromElapsedTime(TimerHandle timerHandle, uint32_t elapsedInUs, uint32_t timeoutInUs)
+{
+    uint32_t lateInUs = Drv_Timer_ReadElapsedTimeInUs(timerHandle) - elapsedInUs;
+
+    Drv_Timer_Start(timerHandle, (timeoutInUs > lateInUs) ? (timeoutInUs - lateInUs) : 1);
+}
+
+/*
+ * Starts a Timer in periodic mode.
+ *
+ *  Timer is restarted in ISR on each period.
+ */
+PUBLIC void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs)
+{
+    (void)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(((Timer*)timerHandle)), "Invalid Timer Handle");
+	DEBUG_ASSERT_MESSAGE(periodInUs > 0, "Invalid Timer Period");
+
+    timers[0].periodInUs = periodInUs;
+    timers[0].missedPeriods = 0;
+    timers[0].running = BOOL_TRUE;
+
+    /* Set compare value */
+    TIMER0_SetCompareValue(periodInUs);
+
+    /* Start first period from now */
+    TIMER0_Reset();
+}
+
+/*
+ * Stops a Timer.
+ *
+ *  Custom timer stops itself on match so just ignore next match.
+ */
+PUBLIC void Drv_Timer_Stop(TimerHandle timerHandle)
+{
+    (void)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(((Timer*)timerHandle)), "Invalid Timer Handle");
+
+    timers[0].running = BOOL_FALSE;
+}
+
+/*
+ * Reads missed period count of a periodic Timer.
+ *
+ *  There is no special note about internal implementation details.
+ *  See header files to function description.
+ */
+PUBLIC uint32_t Drv_Timer_ReadMissedPeriods(TimerHandle timerHandle)
+{
+    (void)timerHandle;
+
+	/* Internal Checks for debug mode */
+	DEBUG_ASSERT_MESSAGE(TIMER_HANDLE_IS_VALID(((Timer*)timerHandle)), "Invalid Timer Handle");
+
+    return timers[0].missedPeriods;
+}
+
 /*
  * Reads elapsed time in a Timer.
  *
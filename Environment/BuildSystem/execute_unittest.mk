@@ -46,6 +46,10 @@ include $(TEST_MODULE)/module.mk
 #
 # Include Specified Unit Test 
 #
+#	IMP : A module which has more than one unit test lists them in
+#	TEST_TARGET_NAMES instead of TEST_TARGET_NAME. All of them are run
+#	unless one is selected on command line (TEST_TARGET_NAME=<TARGET>)
+#
 TEST_DIR = $(TEST_MODULE)/UnitTest
 include $(TEST_DIR)/unittest.mk
 
@@ -147,6 +151,16 @@ SPLINT_FLAGS = \
 #                    		     RULES                                   	   #
 ################################################################################
 
+ifeq ($(TEST_TARGET_NAME),)
+#
+# Default Rule for a module which has more than one unit test
+#	- Runs each unit test in TEST_TARGET_NAMES (see unittest.mk of module)
+#
+default: $(TEST_TARGET_NAMES)
+$(TEST_TARGET_NAMES):
+	$(MAKE) -f $(firstword $(MAKEFILE_LIST)) TEST_MODULE=$(TEST_MODULE) TEST_TARGET_NAME=$@
+.PHONY: $(TEST_TARGET_NAMES)
+else
 #
 # Default Rule
 #	- Runs Unit Test (Unity)
@@ -158,6 +172,7 @@ default: \
 	run_unittest \
 	run_codecovarege \
 	run_codeanalysis
+endif
 
 #
 # Introduction for Tested Module
@@ -44,6 +44,12 @@
 /***************************** TYPE DEFINITIONS *******************************/
 typedef void(*Drv_CPUCore_TaskStartPoint)(void* arg);
 
+/*
+ * Context Switching Hook
+ *  Called by context switching handler for each context switch.
+ */
+typedef void(*Drv_CPUCore_CSHook)(void);
+
 /*************************** FUNCTION DEFINITIONS *****************************/
 /**
 * Initializes actual CPU and its components/peripherals.
@@ -95,4 +101,65 @@ void Drv_CPUCore_CSYieldTo(reg32_t* newTCB);
 reg32_t* Drv_CPUCore_CSInitializeTaskStack(uint8_t* stack, uint32_t stackSize,
 										   Drv_CPUCore_TaskStartPoint startPoint);
 
+/*
+ * Sets context switching hook
+ *
+ *  Hook is called from context switching handler (PendSV) after next TCB is
+ *  selected. Context switching handler has the lowest interrupt priority so
+ *  clients can defer their long running works (which should not be run in
+ *  high priority ISRs) into hook.
+ *
+ * @param hook to be called hook on each context switch. NULL removes hook.
+ *
+ * @return none
+ */
+void Drv_CPUCore_CSSetHook(Drv_CPUCore_CSHook hook);
+
+/*
+ * Disables interrupts to start a critical section.
+ *
+ *  Critical sections can be nested, interrupts are only enabled again when
+ *  outermost critical section is ended.
+ *
+ * @param none
+ *
+ * @return interrupt state before critical section. Must be passed to
+ *         Drv_CPUCore_RestoreInterrupts() at the end of critical section.
+ */
+uint32_t Drv_CPUCore_DisableInterrupts(void);
+
+/*
+ * Restores interrupt state at the end of a critical section.
+ *
+ * @param state interrupt state which is returned by
+ *        Drv_CPUCore_DisableInterrupts()
+ *
+ * @return none
+ */
+void Drv_CPUCore_RestoreInterrupts(uint32_t state);
+
+/*
+ * Reads free running CPU cycle counter for profiling.
+ *
+ *  Width of counter is CPU dependent so use Drv_CPUCore_ElapsedCycles() to
+ *  calculate elapsed cycles instead of subtraction.
+ *
+ * @param none
+ *
+ * @return actual value of cycle counter
+ */
+uint32_t Drv_CPUCore_ReadCycleCounter(void);
+
+/*
+ * Calculates elapsed CPU cycles since a cycle counter value.
+ *
+ *  Handles wrap around of counter once so measured duration must be shorter
+ *  than counter period.
+ *
+ * @param startCycle cycle counter value which is read at start of measurement
+ *
+ * @return elapsed CPU cycles
+ */
+uint32_t Drv_CPUCore_ElapsedCycles(uint32_t startCycle);
+
 #endif	/* __DRV_CPUCORE_H */
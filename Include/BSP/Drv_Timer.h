@@ -7,7 +7,12 @@
  * @brief Timer Driver Interface.
  *
  * 			Timer module provides one shot timers and you need to set timer for
- *			each time.
+ *			each time. Timers can also be started as periodic timers which
+ *			are re-armed by HW.
+ *
+ *			A HW Timer may provide more than one timer (match) channel. All
+ *			channels share counter and interrupt of HW Timer but they are
+ *			independent timers (e.g. LPC17xx provides 4 channels per HW Timer).
  *
  * @see https://github.com/P-LATFORM/P-OS/wiki
  *
@@ -96,6 +101,27 @@ TimerHandle Drv_Timer_Create(TimerNo timerNo,
 							 DrvTimerPriority priority,
                              DrvTimerCallback timerCallback);
 
+/*
+ * Creates a SW Timer which matches with a channel of a HW Timer.
+ *
+ *  Same as Drv_Timer_Create() but client specifies match channel of HW Timer
+ *  as well. Drv_Timer_Create() acquires channel 0. Channels of a HW Timer
+ *  share its interrupt so interrupt priority is highest priority which is
+ *  requested by its channels.
+ *
+ * @param timerNo 		to be acquired HW Timer Number.
+ * @param channelNo		to be acquired channel of HW Timer. Channel count is
+ *						CPU dependent.
+ * @param priority 		Timer Priorty
+ * @param timerCallback	Client callback to inform client about Timer Timeout.
+ *
+ * @return Timer Handle to manage timer.
+ */
+TimerHandle Drv_Timer_CreateChannel(TimerNo timerNo,
+									uint32_t channelNo,
+									DrvTimerPriority priority,
+									DrvTimerCallback timerCallback);
+
 /*
  * Starts a Timer.
  *
@@ -114,11 +140,95 @@ TimerHandle Drv_Timer_Create(TimerNo timerNo,
  */
 void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs);
 
+/*
+ * Starts a Timer from its last timeout.
+ *
+ *   Same as Drv_Timer_Start() but timeout is counted from last timeout of
+ *   timer instead of now. When it is called in timer callback, consecutive
+ *   timeouts do not drift with interrupt latency and callback execution
+ *   time. If timeout is already elapsed, client is informed as soon as
+ *   possible.
+ *
+ *   Timer must be started by Drv_Timer_Start() before.
+ *
+ * @param timerHandle	Handle of to be started Timer
+ * @param timeoutInUs 	Timer Timeout value from last timeout in microseconds.
+ *
+ * @return none
+ */
+void Drv_Timer_StartFromLastTimeout(TimerHandle timerHandle, uint32_t timeoutInUs);
+
+/*
+ * Starts a Timer from a point of its current run.
+ *
+ *   Same as Drv_Timer_Start() but timeout is counted from given elapsed time
+ *   of current run (see Drv_Timer_ReadElapsedTimeInUs()) instead of now. A
+ *   client which keeps its own time using elapsed time does not lose time
+ *   between reading elapsed time and starting timer again. If timeout is
+ *   already elapsed, client is informed as soon as possible.
+ *
+ *   Timer must be started by Drv_Timer_Start() before.
+ *
+ * @param timerHandle	Handle of to be started Timer
+ * @param elapsedInUs	Elapsed time of current run which new run starts from.
+ * @param timeoutInUs 	Timer Timeout value in microseconds.
+ *
+ * @return none
+ */
+void Drv_Timer_StartFromElapsedTime(TimerHandle timerHandle, uint32_t elapsedInUs, uint32_t timeoutInUs);
+
+/*
+ * Starts a Timer in periodic mode.
+ *
+ *   Client code is informed using its callback on each period. Timer is
+ *   re-armed by HW so periods do not drift with interrupt latency. Timer runs
+ *   until Drv_Timer_Stop() is called or it is started by Drv_Timer_Start()
+ *   as a one shot timer.
+ *
+ *   Period is restarted from now if timer is already started. HW counter is
+ *   reset on each period so periodic timer must be the only created channel
+ *   of its HW Timer.
+ *
+ * @param timerHandle	Handle of to be started Timer
+ * @param periodInUs 	Timer Period in microseconds. Must be higher than zero.
+ *
+ * @return none
+ */
+void Drv_Timer_StartPeriodic(TimerHandle timerHandle, uint32_t periodInUs);
+
+/*
+ * Stops a Timer.
+ *
+ *   Timer callback is not called until timer is started again.
+ *
+ * @param timerHandle	Handle of to be stopped Timer
+ *
+ * @return none
+ */
+void Drv_Timer_Stop(TimerHandle timerHandle);
+
+/*
+ * Reads missed period count of a periodic Timer.
+ *
+ *   If callback of a period overruns into next periods, those periods are
+ *   dropped (their callbacks are not called) and counted as missed.
+ *
+ *   [IMP] If HW resets its counter on each period (e.g. LPC1768), number of
+ *   passed periods is not known and an overrun is counted once even if it
+ *   lasts more than one period.
+ *
+ * @param timerHandle	Handle of periodic Timer
+ *
+ * @return Number of missed periods since Timer is started in periodic mode.
+ */
+uint32_t Drv_Timer_ReadMissedPeriods(TimerHandle timerHandle);
+
 /*
  * Reads elapsed time in a Timer.
  *
  *   This function just return elapsed time from timer start even if timer is
- *   not started.
+ *   not started. For periodic timers, elapsed time is from start of current
+ *   period.
  *
  * @param timerHandle	Handle to get Elapsed Time of Timer
  *
@@ -126,4 +236,28 @@ void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs);
  */
 uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle);
 
+/*
+ * Starts free running microsecond time base on a HW Timer.
+ *
+ *  HW counter is never stopped or reset and it is extended to 64 bits in
+ *  SW so time base never wraps around in practice. Time base acquires last
+ *  channel of HW Timer so other channels can still be used by clients.
+ *
+ * @param timerNo		to be acquired HW Timer Number.
+ *
+ * @return none
+ */
+void Drv_Timer_StartTimeBase(TimerNo timerNo);
+
+/*
+ * Reads time base.
+ *
+ *  Can be called from any context (including ISRs).
+ *
+ * @param none
+ *
+ * @return Time since time base is started in microseconds.
+ */
+uint64_t Drv_Timer_ReadTimeBaseInUs(void);
+
 #endif	/* __DRV_TIMER_H */
@@ -37,23 +37,137 @@
 #define __DRV_USERTIMER_H
 
 /********************************* INCLUDES ***********************************/
+#include "Drv_Timer.h"
 
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
-#define DRV_TIMER_INVALID_HANDLE        (-1)
+#define DRV_USERTIMER_INVALID_HANDLE    (-1)
 
 /***************************** TYPE DEFINITIONS *******************************/
-typedef int32_t Drv_TimerHandle;
-typedef void (*Drv_TimerCallback)(void);
+typedef int32_t Drv_UserTimerHandle;
+typedef void (*Drv_UserTimerCallback)(void);
+
+/*
+ * Callback contexts of User Timers
+ */
+typedef enum
+{
+	/* Callback is called in timer interrupt. Must be short. */
+	DRV_USERTIMER_CONTEXT_ISR,
+	/*
+	 * Callback is deferred and called by daemon task
+	 * (see Drv_UserTimer_RunDaemon())
+	 */
+	DRV_USERTIMER_CONTEXT_DAEMON
+} Drv_UserTimerContext;
 
 /*************************** FUNCTION DEFINITIONS *****************************/
-void Drv_Timer_Init(void);
-Drv_TimerHandle Drv_Timer_Create(Drv_TimerCallback userTimerCB);
-void Drv_Timer_Remove(Drv_TimerHandle timer);
-void Drv_Timer_Start(Drv_TimerHandle timer, uint32_t timeout);
-void Drv_Timer_Stop(Drv_TimerHandle timer, uint32_t timeout);
-void Drv_Timer_DelayUs(uint32_t microseconds);
-void Drv_Timer_DelayMs(uint32_t milliseconds);
+
+/*
+ * Initializes User Timer service.
+ *
+ *  All user timers are multiplexed over a single HW Timer.
+ *
+ * @param hwTimerNo HW Timer to be used for user timers (e.g. SYSTEM_TIMER_USER)
+ *
+ * @return none
+ */
+void Drv_UserTimer_Init(TimerNo hwTimerNo);
+
+/*
+ * Creates a User Timer.
+ *
+ * @param userTimerCB callback to be called when timer expires
+ * @param context context which callback is called in
+ *
+ * @return handle of timer or DRV_USERTIMER_INVALID_HANDLE if there is no free
+ *         timer (see CPU_TIMER_MAX_TIMER_COUNT)
+ */
+Drv_UserTimerHandle Drv_UserTimer_Create(Drv_UserTimerCallback userTimerCB,
+										 Drv_UserTimerContext context);
+
+/*
+ * Stops and releases a User Timer. Handle can not be used anymore.
+ *
+ * @param timer handle of timer
+ *
+ * @return none
+ */
+void Drv_UserTimer_Remove(Drv_UserTimerHandle timer);
+
+/*
+ * Starts a one shot User Timer. Restarts timer if it is already started.
+ *
+ * @param timer handle of timer
+ * @param timeoutInUs timeout in microseconds. Timeout is rounded up to
+ *        resolution of user timers (see DRV_USERTIMER_TICK_IN_US)
+ *
+ * @return none
+ */
+void Drv_UserTimer_Start(Drv_UserTimerHandle timer, uint32_t timeoutInUs);
+
+/*
+ * Starts a periodic User Timer. Restarts timer if it is already started.
+ *
+ *  Expiries are scheduled relative to previous expiry so they do not drift.
+ *
+ * @param timer handle of timer
+ * @param periodInUs period in microseconds
+ *
+ * @return none
+ */
+void Drv_UserTimer_StartPeriodic(Drv_UserTimerHandle timer, uint32_t periodInUs);
+
+/*
+ * Stops a User Timer. A deferred callback which is not called yet is
+ * cancelled too.
+ *
+ * @param timer handle of timer
+ *
+ * @return none
+ */
+void Drv_UserTimer_Stop(Drv_UserTimerHandle timer);
+
+/*
+ * Calls deferred callbacks of expired timers (DRV_USERTIMER_CONTEXT_DAEMON).
+ *
+ *  A (low priority) daemon task should call this function periodically or
+ *  when it is notified using daemon hook (see Drv_UserTimer_SetDaemonHook()).
+ *
+ * @param none
+ *
+ * @return number of called callbacks
+ */
+uint32_t Drv_UserTimer_RunDaemon(void);
+
+/*
+ * Sets hook which is called in timer interrupt when a deferred callback is
+ * queued. Hook can be used to wake up daemon task.
+ *
+ * @param hook daemon notification hook. NULL to disable.
+ *
+ * @return none
+ */
+void Drv_UserTimer_SetDaemonHook(Drv_UserTimerCallback hook);
+
+/*
+ * Busy waits for given time. Does not use HW timer so can be used in any
+ * context.
+ *
+ * @param microseconds time to wait
+ *
+ * @return none
+ */
+void Drv_UserTimer_DelayUs(uint32_t microseconds);
+
+/*
+ * Busy waits for given time.
+ *
+ * @param milliseconds time to wait
+ *
+ * @return none
+ */
+void Drv_UserTimer_DelayMs(uint32_t milliseconds);
 
 #endif	/* __DRV_USERTIMER_H */
@@ -64,6 +64,10 @@
     #define TYPEDEF_STRUCT_PACKED	typedef struct
     #define NO_INLINE
 
+	/* There is no portable intrinsic so use (slow) generic implementations */
+	#define COUNT_LEADING_ZEROS(value)		CountLeadingZeros(value)
+	#define COUNT_TRAILING_ZEROS(value)		CountTrailingZeros(value)
+
 #elif defined(__ARMCC_VERSION)
 
 	#define INLINE                  __inline
@@ -73,6 +77,10 @@
     #define TYPEDEF_STRUCT_PACKED	PACKED typedef struct
     #define NO_INLINE               __attribute__((noinline))
 
+	/* CLZ instruction. Trailing zeros are counted on reversed bits (RBIT) */
+	#define COUNT_LEADING_ZEROS(value)		__clz(value)
+	#define COUNT_TRAILING_ZEROS(value)		__clz(__rbit(value))
+
 #else /* GCC */
 
 	/*
@@ -96,6 +104,15 @@
     #define TYPEDEF_STRUCT_PACKED	typedef struct PACKED
     #define NO_INLINE
 
+	/*
+	 * GCC builtins are compiled into CLZ (and RBIT) instructions on ARMv7-M.
+	 * CMSIS (cmsis_gcc.h) also defines __CLZ as __builtin_clz.
+	 *
+	 * [IMP] Result is undefined for zero value.
+	 */
+	#define COUNT_LEADING_ZEROS(value)		((uint32_t)__builtin_clz(value))
+	#define COUNT_TRAILING_ZEROS(value)		((uint32_t)__builtin_ctz(value))
+
 #endif
 
 #ifndef ENDLESS_WHILE_LOOP
@@ -125,4 +142,37 @@
 typedef volatile uint32_t reg32_t;
 /*************************** FUNCTION DEFINITIONS *****************************/
 
+#if defined(WIN32)
+/*
+ * Generic implementations of bit scan operations.
+ *
+ *  [IMP] Value must not be zero (same as CPU intrinsics).
+ */
+static INLINE uint32_t CountLeadingZeros(uint32_t value)
+{
+	uint32_t count = 0;
+
+	while ((value & 0x80000000UL) == 0)
+	{
+		value <<= 1;
+		count++;
+	}
+
+	return count;
+}
+
+static INLINE uint32_t CountTrailingZeros(uint32_t value)
+{
+	uint32_t count = 0;
+
+	while ((value & 1) == 0)
+	{
+		value >>= 1;
+		count++;
+	}
+
+	return count;
+}
+#endif /* WIN32 */
+
 #endif	/* __POS_TYPES_H */
@@ -50,8 +50,45 @@
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
+#if (OS_ENABLE_TIME_SERVICES == 1)
+/* Number of slots of sleep wheel, a bit for each slot in a 32-bit word */
+#define SLEEP_WHEEL_SIZE                (32)
+
+/* Length of a slot of sleep wheel */
+#define SLEEP_SLOT_LENGTH_IN_US         ((uint64_t)1 << KERNEL_SLEEP_SLOT_SHIFT)
+
+/* Slot of a time and start time of that slot */
+#define SLEEP_SLOT(timeInUs)            ((uint32_t)((timeInUs) >> KERNEL_SLEEP_SLOT_SHIFT) & (SLEEP_WHEEL_SIZE - 1))
+#define SLEEP_SLOT_START(timeInUs)      ((timeInUs) & ~(SLEEP_SLOT_LENGTH_IN_US - 1))
+
+/* Time timer is not armed for a wake up */
+#define SLEEP_WHEEL_NOT_ARMED           (~(uint64_t)0)
+#endif
 
 /***************************** TYPE DEFINITIONS *******************************/
+#if (OS_ENABLE_TIME_SERVICES == 1)
+/*
+ * Timing wheel of sleeping tasks.
+ *
+ *  A task sleeps in slot of its wake up time. Each slot keeps its tasks in
+ *  sleep order so tasks with same wake up time are woken in FIFO order.
+ */
+typedef struct
+{
+    /* First and last sleeping tasks of slots */
+    TCB* head[SLEEP_WHEEL_SIZE];
+    TCB* tail[SLEEP_WHEEL_SIZE];
+
+    /* Slots which have sleeping tasks */
+    uint32_t busySlots;
+
+    /* Start time of first slot which is not expired completely */
+    uint64_t slotTimeInUs;
+
+    /* Time which time timer is armed for */
+    uint64_t armedTimeInUs;
+} SleepWheel;
+#endif
 
 /**************************** FUNCTION PROTOTYPES *****************************/
 /* 
@@ -81,6 +118,24 @@ PRIVATE TCB kernelTaskPool[NUM_OF_USER_TASKS];
  */
 PRIVATE TCB idleTaskTCB;
 
+/*
+ * Running task (TCB) and number of context switches
+ */
+PRIVATE TCB* runningTCB;
+PRIVATE uint32_t contextSwitchCount;
+
+#if (OS_ENABLE_TIME_SERVICES == 1)
+/*
+ * Kernel time timer to wake up sleeping tasks
+ */
+PRIVATE KernelTimerHandle timeTimer;
+
+/*
+ * Sleeping tasks
+ */
+PRIVATE SleepWheel sleepWheel = { { NULL }, { NULL }, 0, 0, SLEEP_WHEEL_NOT_ARMED };
+#endif
+
 /**************************** PRIVATE FUNCTIONS ******************************/
 
 /*
@@ -91,20 +146,246 @@ PRIVATE TCB idleTaskTCB;
  */
 PRIVATE void ContextSwitch_Callback(TCB* nextTCB)
 {
+    /* Resuming running task is not a context switch */
+    if (nextTCB != runningTCB)
+    {
+        runningTCB = nextTCB;
+        contextSwitchCount++;
+    }
+
     /* Just switch to next TCB which specified from scheduler */
     Kernel_SwitchTo((reg32_t*)nextTCB);
 }
 
+#if (OS_ENABLE_TIME_SERVICES == 1)
+/*
+ * Returns absolute time since start of scheduling.
+ */
+PRIVATE ALWAYS_INLINE uint64_t CurrentTime(void)
+{
+    return Kernel_ReadTimeBase();
+}
+
+/*
+ * Returns time of next expiry of time timer.
+ *
+ *  It is earliest wake up time in first busy slot. If tasks of slot sleep
+ *  for next rotations, timer expires at end of slot to check next slots.
+ *  Only a slot is visited so it is bounded by tasks of a slot.
+ *
+ * @param none
+ * @return time of next expiry. Wheel must have a sleeping task.
+ */
+PRIVATE ALWAYS_INLINE uint64_t NextExpiryTime(void)
+{
+    uint32_t firstSlot = SLEEP_SLOT(sleepWheel.slotTimeInUs);
+    uint32_t busySlots = sleepWheel.busySlots;
+    uint32_t distance;
+    uint64_t expiryTime;
+    TCB* tcb;
+
+    /* Rotate busy slots so first slot is bit zero */
+    busySlots = (busySlots >> firstSlot) | (busySlots << ((SLEEP_WHEEL_SIZE - firstSlot) & (SLEEP_WHEEL_SIZE - 1)));
+    distance = COUNT_TRAILING_ZEROS(busySlots);
+
+    /* End of first busy slot */
+    expiryTime = sleepWheel.slotTimeInUs + ((uint64_t)(distance + 1) << KERNEL_SLEEP_SLOT_SHIFT);
+
+    for (tcb = sleepWheel.head[(firstSlot + distance) & (SLEEP_WHEEL_SIZE - 1)]; tcb != NULL; tcb = tcb->nextSleeping)
+    {
+        if (tcb->wakeUpTimeInUs < expiryTime)
+        {
+            expiryTime = tcb->wakeUpTimeInUs;
+        }
+    }
+
+    return expiryTime;
+}
+
+/*
+ * Starts time timer to expire at next wake up time.
+ *
+ *  Time is kept by time base so timer is only used for wake ups and it is
+ *  restarted by an intermediate timeout if wake up is too far.
+ *
+ *  [IMP] Must be called with interrupts disabled or from timer ISR.
+ */
+PRIVATE void RestartTimeTimer(void)
+{
+    uint64_t now;
+    uint64_t expiryTime;
+    uint32_t timeout = KERNEL_TIME_MAX_TIMEOUT_IN_US;
+
+    if (sleepWheel.busySlots != 0)
+    {
+        now = CurrentTime();
+        expiryTime = NextExpiryTime();
+
+        if (now < expiryTime)
+        {
+            if ((expiryTime - now) < timeout)
+            {
+                timeout = (uint32_t)(expiryTime - now);
+            }
+        }
+        else
+        {
+            /* Already due, expire as soon as possible */
+            timeout = 1;
+        }
+
+        sleepWheel.armedTimeInUs = now + timeout;
+
+        Kernel_StartTimeTimer(timeTimer, timeout);
+    }
+    else
+    {
+        sleepWheel.armedTimeInUs = SLEEP_WHEEL_NOT_ARMED;
+    }
+}
+
+/*
+ * Inserts a task into slot of its wake up time. Constant time.
+ */
+PRIVATE ALWAYS_INLINE void InsertSleepingTask(TCB* tcb, uint64_t now)
+{
+    uint32_t slot = SLEEP_SLOT(tcb->wakeUpTimeInUs);
+
+    /* Slots of empty wheel start from now */
+    if (sleepWheel.busySlots == 0)
+    {
+        sleepWheel.slotTimeInUs = SLEEP_SLOT_START(now);
+    }
+
+    tcb->nextSleeping = NULL;
+
+    if (sleepWheel.head[slot] == NULL)
+    {
+        sleepWheel.head[slot] = tcb;
+        sleepWheel.busySlots |= (1UL << slot);
+    }
+    else
+    {
+        sleepWheel.tail[slot]->nextSleeping = tcb;
+    }
+
+    sleepWheel.tail[slot] = tcb;
+}
+
+/*
+ * Wakes up tasks of a slot whose wake up times are passed. Tasks which sleep
+ * for next rotations are kept in slot.
+ */
+PRIVATE ALWAYS_INLINE void ExpireSlot(uint32_t slot, uint64_t now)
+{
+    TCB** link = &sleepWheel.head[slot];
+    TCB* tail = NULL;
+    TCB* tcb;
+
+    while ((tcb = *link) != NULL)
+    {
+        if (tcb->wakeUpTimeInUs <= now)
+        {
+            *link = tcb->nextSleeping;
+            tcb->nextSleeping = NULL;
+
+            Scheduler_SetTaskState(tcb, OSTaskState_Ready);
+        }
+        else
+        {
+            tail = tcb;
+            link = &tcb->nextSleeping;
+        }
+    }
+
+    sleepWheel.tail[slot] = tail;
+
+    if (sleepWheel.head[slot] == NULL)
+    {
+        sleepWheel.busySlots &= ~(1UL << slot);
+    }
+}
+
+/*
+ * Puts running task into sleep until given absolute time. Task is not put
+ * into sleep if time is already passed. Kernel should yield after this call.
+ *
+ *  [IMP] Must be called with interrupts disabled.
+ */
+PRIVATE void SleepUntil(TCB* tcb, uint64_t wakeUpTimeInUs, uint64_t now)
+{
+    if (now < wakeUpTimeInUs)
+    {
+        tcb->wakeUpTimeInUs = wakeUpTimeInUs;
+        InsertSleepingTask(tcb, now);
+
+        Scheduler_SetTaskState(tcb, OSTaskState_Waiting);
+
+        /* Timer is already armed for an earlier expiry */
+        if (wakeUpTimeInUs < sleepWheel.armedTimeInUs)
+        {
+            RestartTimeTimer();
+        }
+    }
+}
+
+/*
+ * Interrupt Service Routine (ISR) to handle Kernel Time Timer Timeouts
+ *
+ *  Wakes up all tasks whose wake up times are passed. Only busy slots from
+ *  last expiry to now are visited and a slot is visited once even if more
+ *  than a rotation is passed. Scheduler may preempt running task for a woken
+ *  task.
+ */
+void ISR_KernelTimeTimer(void) NO_INLINE;
+void ISR_KernelTimeTimer(void)
+{
+    uint64_t now = CurrentTime();
+    uint64_t nowSlotTime = SLEEP_SLOT_START(now);
+    uint32_t slot;
+    uint32_t i;
+
+    for (i = 0; (i < SLEEP_WHEEL_SIZE) && (sleepWheel.slotTimeInUs <= nowSlotTime); i++)
+    {
+        slot = SLEEP_SLOT(sleepWheel.slotTimeInUs);
+
+        if (sleepWheel.busySlots & (1UL << slot))
+        {
+            ExpireSlot(slot, now);
+        }
+
+        sleepWheel.slotTimeInUs += SLEEP_SLOT_LENGTH_IN_US;
+    }
+
+    /* Slot of now is not expired completely */
+    sleepWheel.slotTimeInUs = nowSlotTime;
+
+    RestartTimeTimer();
+}
+#endif
+
 /*
  * Idle System Task Code Block 
  *
  */
 PRIVATE KERNEL_TASK_START_POINT(IdleTaskFunc)
 {
+    /*
+     * Kernel starts scheduling with idle task so yield to let scheduler
+     * select first user task (and arm its timers if it is preemptive).
+     */
+    OS_Yield();
+
     while (1)
     {
-        /* For now just yield */
+#if (OS_SCHEDULER == OS_SCHEDULER_COOPARATIVE)
+        /* Cooparative scheduler needs a yield to switch to user tasks */
         OS_Yield();
+#endif
+        /*
+         * Preemptive schedulers run idle task for its burst (if there is no
+         * ready task) and preempt it so nothing to do for now.
+         */
     }
 }
 
@@ -133,6 +414,14 @@ PRIVATE ALWAYS_INLINE void InitializeNewTask(TCB* newTCB)
  */
 PRIVATE ALWAYS_INLINE void StartScheduling(void)
 {
+	/* Kernel starts with idle task */
+	runningTCB = &idleTaskTCB;
+
+#if (OS_ENABLE_TIME_SERVICES == 1)
+	/* Kernel time starts with scheduling, first jobs are released now */
+	Kernel_StartTimeBase(SYSTEM_TIMER_KERNEL_TIMEBASE);
+#endif
+
 	Kernel_StartContextSwitching((reg32_t*)&idleTaskTCB);
 }
 
@@ -189,6 +478,13 @@ PRIVATE ALWAYS_INLINE void InitializeKernel(void)
 	/* Initialize Scheduler */
 	Scheduler_Init(kernelTaskPool, &idleTaskTCB, ContextSwitch_Callback);
 
+#if (OS_ENABLE_TIME_SERVICES == 1)
+	/* Create timer to keep kernel time and wake up sleeping tasks */
+	timeTimer = Kernel_CreateTimeTimer(SYSTEM_TIMER_KERNEL_TIME,
+	                                   KERNEL_TIMER_PRIORITY,
+	                                   ISR_KernelTimeTimer);
+#endif
+
 	/* Initialize User Space */
 	OS_InitializeUserSpace();
 }
@@ -199,6 +495,27 @@ PRIVATE ALWAYS_INLINE void InitializeHW(void)
 	Kernel_InitializeCPU();
 }
 
+/*
+ * Finds TCB of a user task.
+ *
+ * @param userTask User Task which is passed using OS_USER_TASK_PREFIX() macro
+ * @return TCB of user task or NULL if it is not a startup application
+ */
+PRIVATE TCB* FindUserTaskTCB(void* userTask)
+{
+    uint32_t taskIndex;
+
+    for (taskIndex = 0; taskIndex < NUM_OF_USER_TASKS; taskIndex++)
+    {
+        if (kernelTaskPool[taskIndex].userTaskInfo == (UserTaskBaseType*)userTask)
+        {
+            return &kernelTaskPool[taskIndex];
+        }
+    }
+
+    return NULL;
+}
+
 /***************************** PUBLIC FUNCTIONS *******************************/
 PUBLIC void OS_Yield(void)
 {
@@ -209,6 +526,253 @@ PUBLIC void OS_Yield(void)
     Scheduler_Yield();
 }
 
+/*
+ * Yields running task and donates rest of its burst to another task.
+ */
+PUBLIC void OS_YieldTo(void* userTask)
+{
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+    TCB* tcb = NULL;
+
+    if (userTask != NULL)
+    {
+        tcb = FindUserTaskTCB(userTask);
+
+        /* Unknown tasks can not get donation */
+        if (tcb == NULL)
+        {
+            Scheduler_Yield();
+            return;
+        }
+    }
+
+    Scheduler_YieldTo(tcb);
+#else
+    (void)userTask;
+
+    Scheduler_Yield();
+#endif
+}
+
+/*
+ * Changes priority of a user task at runtime.
+ */
+PUBLIC uint32_t OS_TaskSetPriority(void* userTask, uint32_t priority)
+{
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+    TCB* tcb;
+
+    /* Priority is also used as weight of task so it is bounded */
+    if (priority >= OS_TASK_PRIORITY_MAX)
+    {
+        return BOOL_FALSE;
+    }
+
+    tcb = FindUserTaskTCB(userTask);
+
+    return (tcb != NULL) ? Scheduler_SetTaskPriority(tcb, priority) : BOOL_FALSE;
+#else
+    (void)userTask;
+    (void)priority;
+
+    return BOOL_FALSE;
+#endif
+}
+
+/*
+ * Blocks running task for given time.
+ */
+PUBLIC void OS_Delay(uint32_t delayInUs)
+{
+#if (OS_ENABLE_TIME_SERVICES == 1)
+    uint32_t interruptState = Kernel_DisableInterrupts();
+    uint64_t now = CurrentTime();
+
+    SleepUntil(runningTCB, now + delayInUs, now);
+
+    /* Context switch is performed when interrupts are restored */
+    Scheduler_Yield();
+
+    Kernel_RestoreInterrupts(interruptState);
+#else
+    (void)delayInUs;
+
+    Scheduler_Yield();
+#endif
+}
+
+/*
+ * Blocks running task until given absolute time.
+ */
+PUBLIC void OS_DelayUntil(uint64_t wakeUpTimeInUs)
+{
+#if (OS_ENABLE_TIME_SERVICES == 1)
+    uint32_t interruptState = Kernel_DisableInterrupts();
+
+    SleepUntil(runningTCB, wakeUpTimeInUs, CurrentTime());
+
+    /* Context switch is performed when interrupts are restored */
+    Scheduler_Yield();
+
+    Kernel_RestoreInterrupts(interruptState);
+#else
+    (void)wakeUpTimeInUs;
+
+    Scheduler_Yield();
+#endif
+}
+
+/*
+ * Returns kernel time.
+ */
+PUBLIC uint64_t OS_GetTimeUs(void)
+{
+#if (OS_ENABLE_TIME_SERVICES == 1)
+    /* Time base can be read in any context */
+    return CurrentTime();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Waits for next release of running periodic task.
+ */
+PUBLIC void OS_WaitNextPeriod(void)
+{
+#if (OS_ENABLE_TIME_SERVICES == 1) && (OS_SCHEDULER != OS_SCHEDULER_EDF)
+    TCB* tcb = runningTCB;
+    uint32_t periodInUs = tcb->userTaskInfo->periodInUs;
+    uint32_t deadlineInUs = tcb->userTaskInfo->deadlineInUs;
+    uint32_t interruptState;
+    uint64_t deadline;
+    uint64_t now;
+
+    /* Aperiodic tasks do not have releases */
+    if (periodInUs == 0)
+    {
+        Scheduler_Yield();
+        return;
+    }
+
+    if ((deadlineInUs == 0) || (deadlineInUs > periodInUs))
+    {
+        deadlineInUs = periodInUs;
+    }
+
+    interruptState = Kernel_DisableInterrupts();
+
+    now = CurrentTime();
+
+    /* Current job is completed, check its deadline */
+    deadline = tcb->releaseTimeInUs + deadlineInUs;
+    if (deadline < now)
+    {
+        tcb->deadlineMissCount++;
+
+        if ((now - deadline) > tcb->maxLatenessInUs)
+        {
+            tcb->maxLatenessInUs = (uint32_t)(now - deadline);
+        }
+    }
+
+    /*
+     * Next release is computed from previous release (not from now) so
+     * releases do not drift. Releases whose deadlines are already passed
+     * are skipped and counted as missed.
+     */
+    tcb->releaseTimeInUs += periodInUs;
+    while ((tcb->releaseTimeInUs + deadlineInUs) < now)
+    {
+        tcb->releaseTimeInUs += periodInUs;
+        tcb->deadlineMissCount++;
+    }
+
+    SleepUntil(tcb, tcb->releaseTimeInUs, now);
+
+    /* Context switch is performed when interrupts are restored */
+    Scheduler_Yield();
+
+    Kernel_RestoreInterrupts(interruptState);
+#else
+    /* EDF releases jobs itself, yield completes current job */
+    Scheduler_Yield();
+#endif
+}
+
+/*
+ * Returns number of missed deadlines of a periodic user task.
+ */
+PUBLIC uint32_t OS_GetDeadlineMissCount(void* userTask)
+{
+    TCB* tcb = FindUserTaskTCB(userTask);
+
+    return (tcb != NULL) ? tcb->deadlineMissCount : 0;
+}
+
+/*
+ * Returns worst observed lateness of a periodic user task.
+ */
+PUBLIC uint32_t OS_GetMaxLatenessInUs(void* userTask)
+{
+    TCB* tcb = FindUserTaskTCB(userTask);
+
+    return (tcb != NULL) ? tcb->maxLatenessInUs : 0;
+}
+
+/*
+ * Returns number of context switches since kernel is started.
+ */
+PUBLIC uint32_t OS_GetContextSwitchCount(void)
+{
+    return contextSwitchCount;
+}
+
+/*
+ * Returns round time which is chosen by scheduler for a user task.
+ */
+PUBLIC uint32_t OS_GetRoundTimeInUs(void* userTask)
+{
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+    TCB* tcb = FindUserTaskTCB(userTask);
+
+    return (tcb != NULL) ? Scheduler_GetRoundSetPoint(tcb) : 0;
+#else
+    (void)userTask;
+
+    return 0;
+#endif
+}
+
+/*
+ * Reads convergence statistics of round time regulator of a user task.
+ */
+PUBLIC uint32_t OS_GetRegulatorStatistics(void* userTask, OSRegulatorStatistics* statistics)
+{
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+    TCB* tcb = FindUserTaskTCB(userTask);
+
+    return (tcb != NULL) ? Scheduler_GetRegulatorStatistics(tcb, statistics) : BOOL_FALSE;
+#else
+    (void)userTask;
+    (void)statistics;
+
+    return BOOL_FALSE;
+#endif
+}
+
+/*
+ * Sets callback to be notified when a best-effort task is shed or restored.
+ */
+PUBLIC void OS_SetOverloadCallback(OSOverloadCallback callback)
+{
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+    Scheduler_SetOverloadCallback(callback);
+#else
+    (void)callback;
+#endif
+}
+
 /*
  * Kernel Start point.
  * Kernel is the owner of main function to start itself after system power-up. 
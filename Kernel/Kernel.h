@@ -74,6 +74,8 @@
 #define OS_SCHEDULER_COOPARATIVE			(3)
 #define OS_SCHEDULER_PREEMPTIVE				(4)
 #define OS_SCHEDULER_ADAPTIVE				(5)
+#define OS_SCHEDULER_STRIDE					(6)
+#define OS_SCHEDULER_CYCLIC					(7)
 
 /*
  * OS Task Creation Types
@@ -103,14 +105,126 @@
  * 
  */
 #define OS_USER_TASK(TaskName, StartPoint, StackSize, Priority) \
+			OS_PERIODIC_USER_TASK(TaskName, StartPoint, StackSize, Priority, 0, 0)
+
+/*
+ * Periodic User Task
+ *
+ * Same as OS_USER_TASK but also specifies timing parameters of a periodic
+ * task. Deadline aware schedulers (e.g. EDF) use these parameters for
+ * admission test and deadlines. Task waits for its next release using
+ * OS_WaitNextPeriod(). A task is aperiodic if its period is zero.
+ *
+ * @param TaskName Name of user task.
+ * @param StartPoint Start point (function) for user tasks.
+ * @param StackSize Stack Size of User Task.
+ * @param Priority of Tasks.
+ * @param PeriodInUs Period of task in microseconds. Relative deadline of a
+ *		  job is equal to period.
+ * @param WcetInUs Worst Case Execution Time of a job in microseconds.
+ *
+ */
+#define OS_PERIODIC_USER_TASK(TaskName, StartPoint, StackSize, Priority, PeriodInUs, WcetInUs) \
+			OS_PERIODIC_DEADLINE_USER_TASK(TaskName, StartPoint, StackSize, Priority, PeriodInUs, PeriodInUs, WcetInUs)
+
+/*
+ * Periodic User Task with Constrained Deadline
+ *
+ * Same as OS_PERIODIC_USER_TASK but relative deadline of a job can be shorter
+ * than period.
+ *
+ * @param TaskName Name of user task.
+ * @param StartPoint Start point (function) for user tasks.
+ * @param StackSize Stack Size of User Task.
+ * @param Priority of Tasks.
+ * @param PeriodInUs Period of task in microseconds.
+ * @param DeadlineInUs Relative deadline of a job in microseconds. Must not be
+ *		  longer than period.
+ * @param WcetInUs Worst Case Execution Time of a job in microseconds.
+ *
+ */
+#define OS_PERIODIC_DEADLINE_USER_TASK(TaskName, StartPoint, StackSize, Priority, PeriodInUs, DeadlineInUs, WcetInUs) \
+			OS_USER_TASK_DEFINITION(TaskName, StartPoint, StackSize, Priority, Priority, PeriodInUs, DeadlineInUs, WcetInUs, 0, 0, 0)
+
+/*
+ * Latency Sensitive User Task
+ *
+ * Same as OS_USER_TASK but also specifies maximum response latency of task.
+ * Adaptive scheduler derives its round time from latencies of ready tasks.
+ *
+ * @param TaskName Name of user task.
+ * @param StartPoint Start point (function) for user tasks.
+ * @param StackSize Stack Size of User Task.
+ * @param Priority of Tasks.
+ * @param MaxLatencyInUs Maximum time in microseconds which task can wait for
+ *		  CPU while it is ready. Zero if task does not have a latency target.
+ *
+ */
+#define OS_LATENCY_USER_TASK(TaskName, StartPoint, StackSize, Priority, MaxLatencyInUs) \
+			OS_USER_TASK_DEFINITION(TaskName, StartPoint, StackSize, Priority, Priority, 0, 0, 0, MaxLatencyInUs, 0, 0)
+
+/*
+ * User Task with Preemption Threshold
+ *
+ * Same as OS_USER_TASK but running task can only be preempted by tasks whose
+ * priorities are higher than its preemption threshold. Tasks which share data
+ * can be non-preemptive to each other using same threshold. Only fixed
+ * priority preemptive scheduler uses thresholds.
+ *
+ * @param TaskName Name of user task.
+ * @param StartPoint Start point (function) for user tasks.
+ * @param StackSize Stack Size of User Task.
+ * @param Priority of Tasks.
+ * @param PreemptionThreshold Priority of task while it runs. Must not be
+ *		  lower than Priority.
+ *
+ */
+#define OS_THRESHOLD_USER_TASK(TaskName, StartPoint, StackSize, Priority, PreemptionThreshold) \
+			OS_USER_TASK_DEFINITION(TaskName, StartPoint, StackSize, Priority, PreemptionThreshold, 0, 0, 0, 0, 0, 0)
+
+/*
+ * User Task with Bandwidth Reservation
+ *
+ * Same as OS_USER_TASK but task is given a Constant Bandwidth Server (CBS)
+ * reservation. Task can run at most BudgetInUs in each server period and is
+ * throttled when budget is exhausted. Reservation is independent of timing
+ * parameters of periodic tasks so aperiodic tasks can also be reserved. Only
+ * adaptive scheduler uses reservations (see AS_ENABLE_RESERVATIONS).
+ *
+ * @param TaskName Name of user task.
+ * @param StartPoint Start point (function) for user tasks.
+ * @param StackSize Stack Size of User Task.
+ * @param Priority of Tasks.
+ * @param BudgetInUs Maximum execution time of task in a server period in
+ *		  microseconds.
+ * @param ServerPeriodInUs Server period in microseconds.
+ *
+ */
+#define OS_RESERVED_USER_TASK(TaskName, StartPoint, StackSize, Priority, BudgetInUs, ServerPeriodInUs) \
+			OS_USER_TASK_DEFINITION(TaskName, StartPoint, StackSize, Priority, Priority, 0, 0, 0, 0, BudgetInUs, ServerPeriodInUs)
+
+/*
+ * User Task Definition with all parameters.
+ *
+ * Other user task macros are shortcuts of this definition.
+ *
+ */
+#define OS_USER_TASK_DEFINITION(TaskName, StartPoint, StackSize, Priority, PreemptionThreshold, PeriodInUs, DeadlineInUs, WcetInUs, MaxLatencyInUs, BudgetInUs, ServerPeriodInUs) \
 typedef struct \
 { \
     OSUserTaskStartPoint __task; \
     uint32_t __priority; \
+    uint32_t __preemptionThreshold; \
+    uint32_t __periodInUs; \
+    uint32_t __deadlineInUs; \
+    uint32_t __wcetInUs; \
+    uint32_t __maxLatencyInUs; \
+    uint32_t __budgetInUs; \
+    uint32_t __serverPeriodInUs; \
     uint32_t __stackSize; \
     uint8_t __stack[StackSize]; \
 } TaskName##Type; \
-static TaskName##Type TaskName = { StartPoint, Priority, StackSize, { 0 } };
+static TaskName##Type TaskName = { StartPoint, Priority, PreemptionThreshold, PeriodInUs, DeadlineInUs, WcetInUs, MaxLatencyInUs, BudgetInUs, ServerPeriodInUs, StackSize, { 0 } };
 
 /*
  * Prefix for User Task. 
@@ -149,6 +263,115 @@ static TaskName##Type TaskName = { StartPoint, Priority, StackSize, { 0 } };
 #define OS_STARTUP_APPLICATIONS(...) \
 static void* startupApplications[] = { __VA_ARGS__ };
 
+/*
+ * Scheduling Group
+ *
+ * @param TaskCount Number of tasks in group.
+ * @param RoundSetPointInUs Round time set point of group. Zero selects
+ *        nominal round time (TaskCount * nominal burst).
+ */
+#define OS_SCHEDULING_GROUP(TaskCount, RoundSetPointInUs) \
+			{ TaskCount, RoundSetPointInUs }
+
+/*
+ * Static Scheduling Groups
+ *
+ * Partitions startup applications into scheduling groups for hierarchical
+ * Adaptive scheduling (see AS_ENABLE_SCHEDULING_GROUPS). Groups take
+ * consecutive tasks in OS_STARTUP_APPLICATIONS order and first group has the
+ * highest priority. Tasks of a lower group are run only if there is no ready
+ * task in higher groups.
+ *
+ * e.g.
+ *		OS_SCHEDULING_GROUPS
+ *		(
+ *			OS_SCHEDULING_GROUP(2, 2000),	// First two tasks, 2ms round
+ *			OS_SCHEDULING_GROUP(3, 0)		// Remaining tasks, nominal round
+ *		)
+ *
+ * @param ... List of Scheduling Groups (see OS_SCHEDULING_GROUP)
+ *
+ */
+#define OS_SCHEDULING_GROUPS(...) \
+static const OSSchedulingGroup schedulingGroups[] = { __VA_ARGS__ };
+
+/*
+ * Best-Effort Tasks
+ *
+ * Declares tasks which can be shed by Adaptive scheduler under sustained
+ * overload (see AS_ENABLE_OVERLOAD_MANAGEMENT). Tasks are listed in
+ * criticality order, first task is the least critical one and it is shed
+ * first. Shed tasks are restored in reverse order when overload is over.
+ * Tasks which are not listed are critical and never shed.
+ *
+ * e.g.
+ *		OS_BEST_EFFORT_TASKS
+ *		(
+ *			OS_USER_TASK_PREFIX(LoggerTask),	// Shed first
+ *			OS_USER_TASK_PREFIX(DisplayTask)
+ *		)
+ *
+ * @param ... List of User Tasks. Pass tasks using OS_USER_TASK_PREFIX() macro.
+ *
+ */
+#define OS_BEST_EFFORT_TASKS(...) \
+static void* const bestEffortTasks[] = { __VA_ARGS__ };
+
+/*
+ * Cyclic Executive Slot
+ *
+ * A task runs in a slot of a minor frame. Slot must fit into its minor frame
+ * and minor frame must be in major frame, otherwise build fails with a
+ * negative array size error.
+ *
+ * @param MinorFrame Index of minor frame of slot.
+ * @param UserTask User Task which runs in slot. Pass task using
+ *		  OS_USER_TASK_PREFIX() macro.
+ * @param OffsetInUs Start of slot from start of its minor frame.
+ * @param DurationInUs Duration of slot in microseconds.
+ *
+ */
+#define OS_CYCLIC_SLOT(MinorFrame, UserTask, OffsetInUs, DurationInUs) \
+			{ (UserTask), \
+			  ((MinorFrame) * cyclicMinorFrameInUs) + (OffsetInUs) + \
+			  OS_CYCLIC_SLOT_CHECK(MinorFrame, OffsetInUs, DurationInUs), \
+			  (DurationInUs) }
+
+/*
+ * Build time check of a slot. Evaluates to zero if slot fits.
+ */
+#define OS_CYCLIC_SLOT_CHECK(MinorFrame, OffsetInUs, DurationInUs) \
+			(0 * sizeof(char[(((MinorFrame) < cyclicMinorFrameCount) && \
+							  ((DurationInUs) > 0) && \
+							  (((OffsetInUs) + (DurationInUs)) <= cyclicMinorFrameInUs)) ? 1 : -1]))
+
+/*
+ * Static Cyclic Executive Schedule
+ *
+ * Declares time-triggered schedule of Cyclic scheduler. Major frame is
+ * MinorFrameCount minor frames and it is repeated forever. Slots must be
+ * listed in time order and must not overlap, otherwise system is halted at
+ * startup. CPU runs idle task between slots.
+ *
+ * e.g.
+ *		OS_CYCLIC_SCHEDULE
+ *		(
+ *			1000, 2,	// 1ms minor frames, 2ms major frame
+ *			OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(SensorTask), 0, 300),
+ *			OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(ControlTask), 300, 400),
+ *			OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(SensorTask), 0, 300),
+ *			OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(LoggerTask), 500, 200)
+ *		)
+ *
+ * @param MinorFrameInUs Length of a minor frame in microseconds.
+ * @param MinorFrameCount Number of minor frames in major frame.
+ * @param ... List of Slots (see OS_CYCLIC_SLOT)
+ *
+ */
+#define OS_CYCLIC_SCHEDULE(MinorFrameInUs, MinorFrameCount, ...) \
+enum { cyclicMinorFrameInUs = (MinorFrameInUs), cyclicMinorFrameCount = (MinorFrameCount) }; \
+static const OSCyclicSlot cyclicSchedule[] = { __VA_ARGS__ };
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*
@@ -167,6 +390,74 @@ typedef enum
 /* User Task Signature */
 typedef void(*OSUserTaskStartPoint)(void*);
 
+/*
+ * Scheduling Group Definition (see OS_SCHEDULING_GROUPS)
+ */
+typedef struct
+{
+	/* Number of (consecutive) tasks in group */
+	uint32_t taskCount;
+	/* Round time set point of group */
+	uint32_t roundSetPointInUs;
+} OSSchedulingGroup;
+
+/*
+ * Cyclic Executive Slot (see OS_CYCLIC_SLOT)
+ */
+typedef struct
+{
+	/* User task which runs in slot */
+	void* userTask;
+	/* Start time of slot in major frame */
+	uint32_t startInUs;
+	/* Duration of slot */
+	uint32_t durationInUs;
+} OSCyclicSlot;
+
+/*
+ * Overload Events
+ */
+typedef enum
+{
+	OSOverloadEvent_TaskShed = 0,	/* Task is not run anymore because of overload */
+	OSOverloadEvent_TaskRestored	/* Overload is over and task is run again */
+} OSOverloadEvent;
+
+/*
+ * Overload Notification Callback
+ *
+ * @param userTask User Task which is shed or restored
+ * @param event overload event
+ */
+typedef void(*OSOverloadCallback)(void* userTask, OSOverloadEvent event);
+
+/*
+ * Convergence Statistics of a Round Time Regulator (Adaptive Scheduler)
+ *
+ *  A disturbance starts when round error leaves settling band and it is
+ *  settled when error stays in band for a few rounds. Settling times are
+ *  counted in rounds.
+ */
+typedef struct
+{
+	/* Number of regulated rounds */
+	uint32_t rounds;
+	/* Number of disturbances */
+	uint32_t disturbances;
+	/* Settling time of last settled disturbance */
+	uint32_t lastSettlingRounds;
+	/* Worst case settling time */
+	uint32_t maxSettlingRounds;
+	/* Sum of settling times of settled disturbances */
+	uint32_t totalSettlingRounds;
+	/* Sum of absolute round errors in microseconds */
+	uint64_t sumOfAbsErrorsInUs;
+	/* Actual KRR gain of regulator in Q16.16 format */
+	int32_t krrQ16;
+	/* Estimated plant gain in Q16.16 format. Zero if gains are not tuned. */
+	int32_t plantGainQ16;
+} OSRegulatorStatistics;
+
 /*************************** FUNCTION DEFINITIONS *****************************/
 
 /*
@@ -177,6 +468,154 @@ typedef void(*OSUserTaskStartPoint)(void*);
  */
 void OS_Yield(void);
 
+/*
+ * Yields running task and donates unused part of its time slice.
+ *
+ *  If userTask is given, it runs immediately for the rest of the burst of
+ *  running task without losing its own burst. If userTask is NULL, rest of
+ *  the burst is kept as (bounded) credit for the next burst of running task.
+ *
+ *  Only Adaptive scheduler supports donation (see AS_ENABLE_SLICE_DONATION),
+ *  other schedulers just yield.
+ *
+ * @param userTask User Task to donate. Pass task using OS_USER_TASK_PREFIX()
+ *        macro. NULL to keep rest of the burst as credit.
+ * @return none
+ */
+void OS_YieldTo(void* userTask);
+
+/*
+ * Changes priority of a user task at runtime.
+ *
+ *  Only Adaptive scheduler supports priority changes (see
+ *  AS_ENABLE_RUNTIME_PRIORITY). New priority changes CPU shares of tasks in
+ *  group of task and takes effect when actual round is closed.
+ *
+ * @param userTask User Task. Pass task using OS_USER_TASK_PREFIX() macro.
+ * @param priority new priority of task. Must be less than OS_TASK_PRIORITY_MAX.
+ * @return BOOL_TRUE if priority is changed, otherwise BOOL_FALSE
+ */
+uint32_t OS_TaskSetPriority(void* userTask, uint32_t priority);
+
+/*
+ * Blocks running task for given time.
+ *
+ *  Task is moved to waiting state and woken up by kernel time timer so
+ *  sleeping tasks do not consume CPU. Needs kernel time services (see
+ *  OS_ENABLE_TIME_SERVICES), otherwise this is just a yield.
+ *
+ * @param delayInUs delay in microseconds
+ * @return none
+ */
+void OS_Delay(uint32_t delayInUs);
+
+/*
+ * Blocks running task until given absolute time (see OS_GetTimeUs()).
+ *
+ *  Unlike OS_Delay(), wake up times do not drift when a task sleeps in a
+ *  loop with a fixed increment. Returns immediately (after a yield) if time
+ *  is already passed.
+ *
+ * @param wakeUpTimeInUs absolute wake up time in microseconds
+ * @return none
+ */
+void OS_DelayUntil(uint64_t wakeUpTimeInUs);
+
+/*
+ * Returns kernel time since start of scheduling.
+ *
+ *  Time is read from a free running 64 bit time base so it is monotonic
+ *  and it does not wrap around. Can be used for timestamps in any context
+ *  (including ISRs). Always zero if kernel time services are disabled.
+ *
+ * @param none
+ * @return kernel time in microseconds
+ */
+uint64_t OS_GetTimeUs(void);
+
+/*
+ * Waits for next release of running periodic task.
+ *
+ *  Releases are absolute (first release + n * period) so waiting does not
+ *  accumulate drift. If task is late, deadline misses are counted and
+ *  skipped releases are not run. EDF scheduler releases jobs itself so
+ *  this is a yield (job completion) for EDF. Other schedulers need kernel
+ *  time services (see OS_ENABLE_TIME_SERVICES), otherwise and for aperiodic
+ *  tasks, this is just a yield.
+ *
+ * @param none
+ * @return none
+ */
+void OS_WaitNextPeriod(void);
+
+/*
+ * Returns number of missed deadlines of a periodic user task.
+ *
+ *  Deadlines are tracked by EDF scheduler or by OS_WaitNextPeriod() if
+ *  kernel time services are enabled, otherwise always zero.
+ *
+ * @param userTask User Task. Pass task using OS_USER_TASK_PREFIX() macro.
+ * @return number of missed deadlines
+ */
+uint32_t OS_GetDeadlineMissCount(void* userTask);
+
+/*
+ * Returns worst observed lateness (completion time - deadline) of a periodic
+ * user task.
+ *
+ * @param userTask User Task. Pass task using OS_USER_TASK_PREFIX() macro.
+ * @return worst lateness in microseconds, zero if task never missed deadline
+ */
+uint32_t OS_GetMaxLatenessInUs(void* userTask);
+
+/*
+ * Returns number of context switches since kernel is started.
+ *
+ *  Only switches to a different task are counted, a yield which resumes
+ *  same task is not a context switch.
+ *
+ * @param none
+ * @return number of context switches
+ */
+uint32_t OS_GetContextSwitchCount(void);
+
+/*
+ * Returns round time which is chosen by scheduler for a user task.
+ *
+ *  Only Adaptive scheduler runs tasks in rounds so other schedulers always
+ *  return zero.
+ *
+ * @param userTask User Task. Pass task using OS_USER_TASK_PREFIX() macro.
+ * @return round time set point (of task group) in microseconds
+ */
+uint32_t OS_GetRoundTimeInUs(void* userTask);
+
+/*
+ * Reads convergence statistics of round time regulator of a user task.
+ *
+ *  Only Adaptive scheduler has a regulator and statistics are collected if
+ *  AS_ENABLE_REGULATOR_STATISTICS is enabled.
+ *
+ * @param userTask User Task. Pass task using OS_USER_TASK_PREFIX() macro.
+ * @param statistics statistics of regulator (of task group)
+ * @return BOOL_TRUE if statistics are available, otherwise BOOL_FALSE
+ */
+uint32_t OS_GetRegulatorStatistics(void* userTask, OSRegulatorStatistics* statistics);
+
+/*
+ * Sets callback to be notified when a best-effort task is shed or restored
+ * because of overload (see OS_BEST_EFFORT_TASKS).
+ *
+ *  [IMP] Callback is called in interrupt context so it must be short.
+ *
+ *  Only Adaptive scheduler detects overloads so callback is never called
+ *  for other schedulers.
+ *
+ * @param callback overload notification callback. NULL to disable.
+ * @return none
+ */
+void OS_SetOverloadCallback(OSOverloadCallback callback);
+
 /*
  * IMP : User space have to implement this function.
  * Kernel uses this function to initialize User Space Area before starts User Tasks
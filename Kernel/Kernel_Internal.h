@@ -99,6 +99,52 @@
  */
 #define KERNEL_TIMER_PRIORITY           DRV_TIMER_PRI_HIGH
 
+/*
+ * Kernel Time Services
+ *
+ *  Kernel keeps 64 bit absolute time using a free running time base on a
+ *  HW timer (SYSTEM_TIMER_KERNEL_TIMEBASE) and wakes up sleeping tasks
+ *  (see OS_Delay()) and periodic tasks at their absolute release times
+ *  (see OS_WaitNextPeriod()) using a HW timer (SYSTEM_TIMER_KERNEL_TIME).
+ *  Both may be same HW Timer if driver provides more than one channel. EDF
+ *  scheduler also uses time base for its release times.
+ *
+ *  1 : Kernel time services are enabled (SYSTEM_TIMER_KERNEL_TIME and
+ *      SYSTEM_TIMER_KERNEL_TIMEBASE are mandatory)
+ *  0 : No time services, delays and OS_WaitNextPeriod() are just yields
+ */
+#ifndef OS_ENABLE_TIME_SERVICES
+#define OS_ENABLE_TIME_SERVICES				0
+#endif
+
+#if (OS_ENABLE_TIME_SERVICES == 1) && \
+	(!defined(SYSTEM_TIMER_KERNEL_TIME) || !defined(SYSTEM_TIMER_KERNEL_TIMEBASE))
+#error "SYSTEM_TIMER_KERNEL_TIME and SYSTEM_TIMER_KERNEL_TIMEBASE must be defined for kernel time services!"
+#endif
+
+/*
+ * Maximum timeout of kernel time timer.
+ *
+ *  Far wake ups are reached by intermediate timeouts. Must fit in timer
+ *  range.
+ */
+#ifndef KERNEL_TIME_MAX_TIMEOUT_IN_US
+#define KERNEL_TIME_MAX_TIMEOUT_IN_US		(1000000)
+#endif
+
+/*
+ * Slot length of sleep wheel (2^KERNEL_SLEEP_SLOT_SHIFT microseconds).
+ *
+ *  Sleeping tasks are hashed into 32 slots by their wake up times so a task
+ *  is put into sleep in constant time. Tasks which sleep longer than a
+ *  rotation of wheel stay in their slots for next rotations. Wake up times
+ *  are exact, slot length just balances visited slots and spurious timer
+ *  expiries for far wake ups.
+ */
+#ifndef KERNEL_SLEEP_SLOT_SHIFT
+#define KERNEL_SLEEP_SLOT_SHIFT				(10)
+#endif
+
 /*
  * Following defines are just wrapper definitions and covers Driver Layer APIs.
  *  A generic OS architecture should not dependent to external modules
@@ -124,9 +170,34 @@
 /* Wrapper function definition to start Timer */
 #define Kernel_StartPreemptionTimer     Drv_Timer_Start
 
+/* Wrapper function definition to start Timer from its last timeout */
+#define Kernel_ContinuePreemptionTimer  Drv_Timer_StartFromLastTimeout
+
 /* Wrapper function definitions to get time stamp */
 #define Kernel_GetPreemptionTimeStamp   Drv_Timer_ReadElapsedTimeInUs
 
+/* Wrapper function definitions for kernel time timer */
+#define Kernel_CreateTimeTimer          Drv_Timer_Create
+#define Kernel_StartTimeTimer           Drv_Timer_Start
+
+/* Wrapper function definitions for kernel time base */
+#define Kernel_StartTimeBase            Drv_Timer_StartTimeBase
+#define Kernel_ReadTimeBase             Drv_Timer_ReadTimeBaseInUs
+
+/* Wrapper function definitions for kernel critical sections */
+#define Kernel_DisableInterrupts        Drv_CPUCore_DisableInterrupts
+#define Kernel_RestoreInterrupts        Drv_CPUCore_RestoreInterrupts
+
+/* Wrapper function definition to set context switching hook */
+#define Kernel_SetContextSwitchHook     Drv_CPUCore_CSSetHook
+
+/* Wrapper function definition to halt system on a fatal error */
+#define Kernel_Halt                     Drv_CPUCore_Halt
+
+/* Wrapper function definitions to read cycle counter for profiling */
+#define Kernel_ReadCycleCounter         Drv_CPUCore_ReadCycleCounter
+#define Kernel_ElapsedCycles            Drv_CPUCore_ElapsedCycles
+
 /********************************* VARIABLES *******************************/
 
 /*
@@ -163,6 +234,38 @@ typedef struct
      * User Task Priority
      */
     uint32_t priority;
+    /*
+     * Preemption threshold of User Task. Only tasks with higher priorities
+     * can preempt task while it runs. Same as priority by default.
+     */
+    uint32_t preemptionThreshold;
+    /*
+     * Period of User Task in microseconds. Zero for aperiodic tasks.
+     */
+    uint32_t periodInUs;
+    /*
+     * Relative deadline of a job of User Task in microseconds. Not longer
+     * than period. Zero for aperiodic tasks.
+     */
+    uint32_t deadlineInUs;
+    /*
+     * Worst Case Execution Time (WCET) of a job of User Task in microseconds
+     */
+    uint32_t wcetInUs;
+    /*
+     * Maximum response latency of User Task in microseconds. Zero if task
+     * does not have a latency target.
+     */
+    uint32_t maxLatencyInUs;
+    /*
+     * Bandwidth reservation budget of User Task in a server period in
+     * microseconds. Zero if task is not reserved.
+     */
+    uint32_t budgetInUs;
+    /*
+     * Server period of bandwidth reservation in microseconds
+     */
+    uint32_t serverPeriodInUs;
 	/*
 	 * Stack size of User Task
 	 */
@@ -206,6 +309,34 @@ typedef struct TCB
 	 * User defined task Information.
 	 */
 	UserTaskBaseType* userTaskInfo;
+
+	/*
+	 * Number of missed deadlines of task.
+	 *  Updated by deadline aware schedulers.
+	 */
+	uint32_t deadlineMissCount;
+
+	/*
+	 * Worst observed lateness of task in microseconds.
+	 */
+	uint32_t maxLatenessInUs;
+
+#if (OS_ENABLE_TIME_SERVICES == 1)
+	/*
+	 * Absolute release time of current job of a periodic task.
+	 */
+	uint64_t releaseTimeInUs;
+
+	/*
+	 * Absolute time to wake up task if it is sleeping.
+	 */
+	uint64_t wakeUpTimeInUs;
+
+	/*
+	 * Next task in slot of sleep wheel (in sleep order).
+	 */
+	struct TCB* nextSleeping;
+#endif
 } TCB;
 /*************************** FUNCTION DEFINITIONS *****************************/
 
@@ -64,7 +64,8 @@
 #include "postypes.h"
 
 /***************************** MACRO DEFINITIONS ******************************/
-#if OS_TASK_CREATION == OS_TASK_CREATION_STATIC
+/* Regulator is re-initialized for dynamically created tasks */
+#if (OS_TASK_CREATION == OS_TASK_CREATION_STATIC)
 
 #define AS_ENABLE_REINIT_REGULATOR          0
 
@@ -77,6 +78,28 @@
 /* Task count */
 #define TASK_COUNT                          NUM_OF_USER_TASKS
 
+#if AS_ENABLE_SCHEDULING_GROUPS
+/* Number of scheduling groups which are declared by user */
+#define GROUP_COUNT                         (sizeof(schedulingGroups) / sizeof(OSSchedulingGroup))
+#else
+/* All tasks are in a single group */
+#define GROUP_COUNT                         (1)
+#endif /* AS_ENABLE_SCHEDULING_GROUPS */
+
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+/* Number of best-effort tasks which are declared by user */
+#define BEST_EFFORT_TASK_COUNT              (sizeof(bestEffortTasks) / sizeof(void*))
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+/* Maximum task count. Each task is represented by a bit in a task set. */
+#define AS_MAX_TASK_COUNT                   (32)
+
+/* Task Set which includes all tasks */
+#define TASK_SET_ALL                        ((TaskSet)(0xFFFFFFFFUL >> (AS_MAX_TASK_COUNT - TASK_COUNT)))
+
+/* Bit (in task sets) of a task in task list */
+#define TASK_BIT(task)                      ((TaskSet)1 << ((task) - scheduler.taskList))
+
 /*
  * Boundary check for burst value and return burst value in valid range
  *
@@ -97,8 +120,59 @@
  */
 #define AS_PARAMETER_CHECK(...)
 
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+/*
+ * Burst values are converted to time using 32 bit Q16.16 multiplication so
+ * burst time must fit in 16 bit integer part.
+ */
+#if AS_BURST_MAX_IN_US > 0xFFFF
+#error "AS_BURST_MAX_IN_US is too high for fixed point regulator!"
+#endif
+
+/* Multiplication factor in Q16.16 format */
+#define AS_MULT_FACTOR_Q                    AS_Q(AS_MULT_FACTOR)
+#endif /* AS_ENABLE_FIXED_POINT_REGULATOR */
+
+/* Context switching hook is required for deferred and pipelined works */
+#define AS_ENABLE_CS_HOOK \
+            (AS_ENABLE_DEFERRED_REGULATOR || AS_ENABLE_PIPELINED_SCHEDULING)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
+/*
+ * Task Set.
+ *  Each bit represents a task in task list (bit n for n.th task). Sets are
+ *  updated on state transitions so scheduler finds ready tasks in constant
+ *  time without visiting task list.
+ */
+typedef uint32_t TaskSet;
+
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+/* Regulator factor (e.g. alpha) in Q16.16 format */
+typedef int32_t RegulatorFactor;
+#else
+/* Regulator factor (e.g. alpha) in floating point */
+typedef float RegulatorFactor;
+#endif /* AS_ENABLE_FIXED_POINT_REGULATOR */
+
+/*
+ * Measurements of a Task in a Round
+ */
+typedef struct
+{
+    /* Actual (Measured) Processing (Burst) Time of Task */
+	uint32_t tProcess;
+#if AS_ENABLE_SLICE_DONATION
+    /*
+     * Time which is given up (donated or kept as credit) by task. Counted as
+     * processed time so voluntary yields are not seen as low demand.
+     */
+    uint32_t tYielded;
+    /* Credit which is used by task. Not counted because it is given up before. */
+    uint32_t tCredit;
+#endif /* AS_ENABLE_SLICE_DONATION */
+} RoundMeasurements;
+
 /*
  * Controller State Variables/Parameters
  *
@@ -108,8 +182,13 @@
  */
 typedef struct
 {
-    /* Actual (Measured) Processing (Burst) Time of Task */
-	uint32_t tProcess;
+    /*
+     * Measurements of last two rounds. Actual round is measured into the set
+     * which is selected by group of task (see SchedulingGroup.measuredSet)
+     * and regulator reads the other one so closing a round does not copy
+     * measurements of tasks.
+     */
+    RoundMeasurements measurements[2];
     /* Set point for burst time */
 	uint32_t tProcessSetPoint;
     /* Previous burst time */
@@ -117,10 +196,34 @@ typedef struct
     /*
      * Task's alpha to distrubute burst correction onto tasks.
      *  See section 5.2.2 (Outer loop) in [1] for details.
+     *
+     *  Calculated at initialization and recalculated by regulator when it is
+     *  re-initialized (e.g. on priority changes) so priority changes do not
+     *  visit all tasks of group.
      */
-	float alpha;
+	RegulatorFactor alpha;
 } TaskStateVariables;
 
+#if AS_ENABLE_RESERVATIONS
+/*
+ * Constant Bandwidth Server (CBS) Reservation of a Task
+ */
+typedef struct
+{
+    /* Maximum budget in a server period. Zero if task is not reserved. */
+    uint32_t budgetInUs;
+    /* Server period */
+    uint32_t periodInUs;
+    /* Remaining budget in current server period */
+    uint32_t remainingInUs;
+    /* Server deadline (scheduler time). Budget is replenished at deadline. */
+    uint32_t deadline;
+} Reservation;
+#endif /* AS_ENABLE_RESERVATIONS */
+
+/* Scheduling Group (Forward Declaration) */
+struct SchedulingGroup;
+
 /*
  * Task Information
  *
@@ -140,9 +243,27 @@ typedef struct TaskInfo
     /* Controller State Variables for Task */
     TaskStateVariables stateVariables;
 
+#if AS_ENABLE_RESERVATIONS
+    /* Bandwidth reservation of task */
+    Reservation reservation;
+#endif /* AS_ENABLE_RESERVATIONS */
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    /* Remaining burst of a preempted task. Zero if task is not preempted. */
+    uint32_t remainingBurstInUs;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+#if AS_ENABLE_SLICE_DONATION
+    /* Credit which is added to next burst of task */
+    uint32_t burstCreditInUs;
+#endif /* AS_ENABLE_SLICE_DONATION */
+
     /* Task State */
     OSTaskState state;
 
+    /* Scheduling group of task */
+    struct SchedulingGroup* group;
+
     /*
      * Task Control Block (TCB) Reference.
      *  Kernel interests only TCB for context switching, when scheduler finds
@@ -170,6 +291,177 @@ typedef struct
     int32_t errRoundOld;
 } SchedulerStateVariables;
 
+/*
+ * Outer Loop (PI Controller) Gains
+ *
+ *  Fixed gains of paper unless self-tuning is enabled.
+ */
+typedef struct
+{
+    /* KRR */
+    RegulatorFactor krr;
+    /* KRR * ZRR */
+    RegulatorFactor krrZrr;
+} RegulatorGains;
+
+#if AS_ENABLE_SELF_TUNING
+/*
+ * Plant Gain Estimator
+ *
+ *  Least squares estimation of plant gain with forgetting factor :
+ *
+ *    g = sum(bc(k - 1) * (Tr(k) - Tr(k - 1))) / sum(bc(k - 1)^2)
+ */
+typedef struct
+{
+    /* Weighted sum of burst correction * round time change */
+    int64_t sumXY;
+    /* Weighted sum of squares of burst correction */
+    int64_t sumXX;
+    /* Measured round time of previous round */
+    uint32_t tRoundOld;
+} PlantEstimator;
+#endif /* AS_ENABLE_SELF_TUNING */
+
+#if AS_ENABLE_REGULATOR_STATISTICS
+/*
+ * Regulator Statistics
+ */
+typedef struct
+{
+    /* Results which are provided to user */
+    OSRegulatorStatistics results;
+    /* Indicates whether if a disturbance is not settled yet */
+    uint32_t settling;
+    /* Rounds since last disturbance */
+    uint32_t disturbanceRounds;
+    /* Consecutive rounds whose errors are in settling band */
+    uint32_t inBandRounds;
+} RegulatorStatistics;
+#endif /* AS_ENABLE_REGULATOR_STATISTICS */
+
+/*
+ * Regulator Inputs
+ *
+ *  Measurements of a completed round. Round is closed in Burst Timer ISR and
+ *  measurements are saved here so regulator can be run later (deferred) while
+ *  next round is being measured.
+ */
+typedef struct
+{
+    /* Measured time of completed round */
+    uint32_t tRound;
+    /* Tasks which are not run in completed round */
+    TaskSet notRunTasks;
+    /* First task of next round which is started before regulator is run */
+    TaskInfo* firstTask;
+} RegulatorInputs;
+
+/*
+ * Scheduling Group
+ *
+ *  Consecutive tasks in task list which are run in a round. Each group has
+ *  its own regulator (outer loop) state.
+ */
+typedef struct SchedulingGroup
+{
+    /*
+     * Group flags. Kept as separate words (not bit fields) because they are
+     * written from different contexts (ISRs, regulator and tasks) and a bit
+     * field write is a read-modify-write of shared word.
+     */
+    /* Indicates whether if all ready tasks are saturated or not*/
+    volatile uint32_t allReadyTasksSaturated;
+    /* Indicates whether if there is a request to re-init regulator */
+    volatile uint32_t reInitRegulator;
+    /* Indicates whether if round set point is fixed by user */
+    volatile uint32_t fixedSetPoint;
+#if AS_ENABLE_RUNTIME_PRIORITY
+    /* Indicates whether if priorities of group tasks are changed */
+    volatile uint32_t prioritiesChanged;
+#endif /* AS_ENABLE_RUNTIME_PRIORITY */
+
+    /* Set of tasks in group */
+    TaskSet tasks;
+    /* First task of group in task list */
+    TaskInfo* taskListBegin;
+    /* End of group tasks (first task of next group) in task list */
+    TaskInfo* taskListEnd;
+
+    /* Max Round Time of group */
+    int32_t maxRoundTime;
+
+    /* Sum of priorities (weights) of tasks in group to calculate alphas */
+    uint32_t sumOfPriorities;
+
+    SchedulerStateVariables stateVariables;
+
+    /* Gains of outer loop */
+    RegulatorGains gains;
+
+    /* Inputs of regulator which are saved when a round is closed */
+    RegulatorInputs regulatorInputs;
+
+    /*
+     * Measurement set (0 or 1) of tasks which actual round is measured into.
+     *  Flipped when a round is closed so other set keeps closed round.
+     */
+    uint32_t measuredSet;
+
+#if AS_ENABLE_SELF_TUNING
+    PlantEstimator estimator;
+#endif /* AS_ENABLE_SELF_TUNING */
+
+#if AS_ENABLE_REGULATOR_STATISTICS
+    RegulatorStatistics statistics;
+#endif /* AS_ENABLE_REGULATOR_STATISTICS */
+
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    /* Consecutive rounds which overrun set point */
+    uint32_t overloadRounds;
+    /* Consecutive rounds which have spare time while a task is shed */
+    uint32_t recoveryRounds;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+#if AS_ENABLE_DEFERRED_REGULATOR
+    /*
+     * Indicates that a round is closed but its regulator is not run yet.
+     *  Not a bit field because it is written from ISR and context switching
+     *  hook which may preempt each other.
+     */
+    volatile uint32_t regulatorPending;
+#endif /* AS_ENABLE_DEFERRED_REGULATOR */
+} SchedulingGroup;
+
+#if AS_ENABLE_PIPELINED_SCHEDULING
+/*
+ * Prepared Scheduling Decision
+ *
+ *  Prepared in context switching hook and committed in Burst Timer ISR.
+ */
+typedef struct
+{
+    /* Prepared next task. NULL if there is no valid decision. */
+    TaskInfo* volatile task;
+    /* Burst time of prepared task */
+    uint32_t burstTime;
+} PreparedDecision;
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
+
+#if AS_ENABLE_ISR_PROFILING
+/*
+ * Profiling Results
+ *  Worst case durations in CPU cycles.
+ */
+typedef struct
+{
+    /* Worst case duration of Burst Timer ISR */
+    uint32_t burstTimerISRMaxCycles;
+    /* Worst case duration of regulator */
+    uint32_t regulatorMaxCycles;
+} SchedulerProfile;
+#endif /* AS_ENABLE_ISR_PROFILING */
+
 /*
  * Scheduler Data Structure.
  */
@@ -182,10 +474,10 @@ typedef struct
 		uint32_t initialized : 1;
         /* Indicates whether if current task is idle or not */
 		uint32_t taskIsIdle : 1;
-        /* Indicates whether if all ready tasks are saturated or not*/
-		uint32_t allReadyTasksSaturated : 1;
-        /* Indicates whether if there is a request to re-init regulator */
-		uint32_t reInitRegulator : 1;
+        /* Indicates whether if current task continues its burst in round */
+		uint32_t burstContinued : 1;
+        /* Indicates whether if current task runs a donated burst */
+		uint32_t burstDonated : 1;
         uint32_t __reserved : 28;
 	} flags;
 
@@ -204,8 +496,69 @@ typedef struct
 	TaskInfo idleTask;
     /* Reference to Current (Running) task*/
     TaskInfo* currentTask;
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Set of ready tasks */
+    TaskSet readyTasks;
+    /* Number of ready tasks */
+    uint32_t readyTaskCount;
+    /* Set of tasks which are not run in current round yet */
+    TaskSet roundPendingTasks;
+    /* Set of tasks whose bursts are saturated (reached to maximum burst) */
+    TaskSet saturatedTasks;
+
+    /* Burst time of running task */
+    uint32_t burstTime;
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    /* Set of latency sensitive tasks which preempt running task on wake-up */
+    TaskSet urgentTasks;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+#if AS_ENABLE_SLICE_DONATION
+    /* Time which is given up by running task at the end of its burst */
+    uint32_t burstYielded;
+    /* Credit which is used in burst of running task */
+    uint32_t burstCreditUsed;
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+#if AS_ENABLE_RESERVATIONS
+    /* Set of tasks which exhausted their budgets and wait for replenishment */
+    TaskSet throttledTasks;
+    /*
+     * Scheduler time in microseconds. Sum of all bursts including idle.
+     *  Wraps around so compared using TimeIsReached().
+     */
+    uint32_t now;
+#endif /* AS_ENABLE_RESERVATIONS */
+
+    /* Scheduling groups in priority order (first group is the highest) */
+    SchedulingGroup groups[GROUP_COUNT];
+
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    /* Set of tasks which are shed because of overload */
+    TaskSet shedTasks;
+    /* Best-effort tasks in shedding order (least critical first) */
+    TaskInfo* sheddingOrder[BEST_EFFORT_TASK_COUNT];
+    /* Application callback to notify shed and restored tasks */
+    OSOverloadCallback overloadCallback;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+#if AS_ENABLE_PIPELINED_SCHEDULING
+    /* Next task decision which is prepared while current task runs */
+    PreparedDecision preparedDecision;
+    /*
+     * Changed whenever scheduling state (ready or round pending task sets)
+     * changes. A decision is discarded if state changes during preparation.
+     */
+    volatile uint32_t stateVersion;
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
 
-    SchedulerStateVariables stateVariables;
+#if AS_ENABLE_ISR_PROFILING
+    /* Profiling results which can be watched using a debugger */
+    SchedulerProfile profile;
+#endif /* AS_ENABLE_ISR_PROFILING */
 } SchedulerData;
 /**************************** FUNCTION PROTOTYPES *****************************/
 
@@ -222,23 +575,51 @@ PRIVATE SchedulerData scheduler;
 PRIVATE const TaskInfo* const LAST_TASK = &scheduler.taskList[TASK_COUNT];
 
 /*
- * Max Round Time
+ * Compile time check for task count. Task sets can keep limited number of tasks.
  */
-PRIVATE const int32_t MaxRoundTime = AS_BURST_MAX_IN_US * TASK_COUNT;
+typedef char ASTaskCountCheck[(TASK_COUNT <= AS_MAX_TASK_COUNT) ? 1 : -1];
 
 /**************************** PRIVATE FUNCTIONS ******************************/
 
+#if AS_ENABLE_ISR_PROFILING
+/*
+ * Updates a worst case duration using a measurement
+ *
+ * @param maxCycles worst case duration to be updated
+ * @param startCycle cycle counter value at the start of measurement
+ *
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void UpdateMaxCycles(uint32_t* maxCycles, uint32_t startCycle)
+{
+    uint32_t cycles = Kernel_ElapsedCycles(startCycle);
+
+    if (cycles > *maxCycles)
+    {
+        *maxCycles = cycles;
+    }
+}
+#endif /* AS_ENABLE_ISR_PROFILING */
+
 /*
  * Interrupt Service Routine (ISR) to handle Timer Timouts
  */
 void ISR_BurstTimer(void) NO_INLINE;
 void ISR_BurstTimer(void)
 {
+#if AS_ENABLE_ISR_PROFILING
+    uint32_t startCycle = Kernel_ReadCycleCounter();
+#endif /* AS_ENABLE_ISR_PROFILING */
+
     /*
      * Running task's burst time is ended and preempted.
      * Therfore, yield to next task
      */
     Scheduler_Yield();
+
+#if AS_ENABLE_ISR_PROFILING
+    UpdateMaxCycles(&scheduler.profile.burstTimerISRMaxCycles, startCycle);
+#endif /* AS_ENABLE_ISR_PROFILING */
 }
 
 /*
@@ -251,183 +632,1145 @@ void ISR_BurstTimer(void)
  */
 PRIVATE ALWAYS_INLINE void SetBurstTimer(uint32_t burstTimeInUs)
 {
+    /* Keep burst time to find unused part of burst */
+    scheduler.burstTime = burstTimeInUs;
+
 	/* Set timer for IDLE Task Burst */
     Kernel_StartPreemptionTimer(scheduler.timer, burstTimeInUs);
 }
 
-#if AS_ENABLE_REINIT_REGULATOR
 /*
- * Resets Regulator and state variables
+ * Updates saturation flag of a group using ready and saturated task sets.
  *
- * @param none
+ *  All ready tasks are saturated if there is no ready task out of saturated
+ *  task set. Constant time so called whenever one of the sets is changed.
+ *
+ * @param group group whose saturation flag is updated
  * @return none
  */
-PRIVATE ALWAYS_INLINE void ResetRegulator(void)
+PRIVATE ALWAYS_INLINE void UpdateSaturationFlag(SchedulingGroup* group)
 {
-    SchedulerStateVariables* state = &scheduler.stateVariables;
+    TaskSet readyTasks = scheduler.readyTasks & group->tasks;
 
-    state->tRound = 0;
-    state->errRoundOld = 0;
-    state->burstCorrectionOld = 0;
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    /* Shed tasks are not run so they do not affect regulator */
+    readyTasks &= ~scheduler.shedTasks;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+    group->allReadyTasksSaturated =
+        (readyTasks != 0) &&
+        ((readyTasks & ~scheduler.saturatedTasks) == 0);
+}
+
+/*
+ * Updates saturation state of a task after its burst is calculated.
+ *
+ * @param task task whose burst is updated
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void UpdateTaskSaturation(TaskInfo* task)
+{
+    if (task->stateVariables.tBurstOld >= (uint32_t)(AS_BURST_MAX_IN_US * AS_MULT_FACTOR))
+    {
+        scheduler.saturatedTasks |= TASK_BIT(task);
+    }
+    else
+    {
+        scheduler.saturatedTasks &= ~TASK_BIT(task);
+    }
 }
-#endif
 
 /*
- * Runs internal regulator to tune system parameters.
+ * Invalidates prepared decision because scheduling state is changed.
  *
- *  Called at the begining of the round.
+ *  Called in ISRs (or with interrupts disabled) on each state change.
  *
  * @param none
  * @return none
  */
-PRIVATE ALWAYS_INLINE void RunRegulator(void)
+PRIVATE ALWAYS_INLINE void InvalidatePreparedDecision(void)
 {
-    /* Shortcuts to state variables*/
-    SchedulerStateVariables* state = &scheduler.stateVariables;
-    TaskStateVariables* taskState;
-    float nextRoundTime;
-	TaskInfo* task;
-	int32_t errorTProcess = 0;
-	int32_t burst = 0;
-    int32_t errRound = 0;
-    int32_t burstCorrection = 0;
+#if AS_ENABLE_PIPELINED_SCHEDULING
+    scheduler.stateVersion++;
+    scheduler.preparedDecision.task = NULL;
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
+}
 
-#if AS_ENABLE_REINIT_REGULATOR
-	if (scheduler.flags.reInitRegulator == BOOL_FALSE)
-#endif /* AS_ENABLE_REINIT_REGULATOR */
-	{
-        /*
-         * Calculate burst correction in PI controller (outer loop)
-         *
-         *   bc(k) = bc(k - 1) +
-         *           KRR * ( Tr0(k - 1) - Tr(k-1) ) -
-         *           KRR * ZRR * (Tr0(k - 2) - Tr(k - 2))
-         *
-         */
+/*
+ * Returns tasks which can be run. Ready tasks which are not throttled or
+ * shed.
+ *
+ * @param none
+ * @return set of eligible tasks
+ */
+PRIVATE ALWAYS_INLINE TaskSet EligibleTasks(void)
+{
+    TaskSet eligibleTasks = scheduler.readyTasks;
 
-        /* Get Round Error : Tr0(k - 1) - Tr(k-1) */
-		errRound = state->tRoundSetPoint - state->tRound;
+#if AS_ENABLE_RESERVATIONS
+    eligibleTasks &= ~scheduler.throttledTasks;
+#endif /* AS_ENABLE_RESERVATIONS */
 
-		burstCorrection = state->burstCorrectionOld +
-                          (int32_t)( (AS_KRR * errRound) - (AS_KRR * AS_ZRR * state->errRoundOld));
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    eligibleTasks &= ~scheduler.shedTasks;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
 
-        /* Apply Saturations */
-		if (scheduler.flags.allReadyTasksSaturated == BOOL_TRUE)
-        {
-            /* Clear flag first */
-            scheduler.flags.allReadyTasksSaturated = BOOL_FALSE;
+    return eligibleTasks;
+}
 
-            /*
-             * Miosix Note : If all inner regulators reached upper saturation,
-             * allow only a decrease in the burst correction.
-             */
-            if (burstCorrection < state->burstCorrectionOld)
-			{
-				state->burstCorrectionOld = burstCorrection;
-			}
-		}
-		else
-		{
-            /* Save burst correction value for next iteration in I Controller */
-			state->burstCorrectionOld = burstCorrection;
-		}
+#if AS_ENABLE_RESERVATIONS
+/*
+ * Checks whether if scheduler time reached to a time or not.
+ *
+ * @param time time to be checked
+ * @return BOOL_TRUE if time is reached, otherwise BOOL_FALSE
+ */
+PRIVATE ALWAYS_INLINE uint32_t TimeIsReached(uint32_t time)
+{
+    return ((int32_t)(scheduler.now - time) >= 0) ? BOOL_TRUE : BOOL_FALSE;
+}
 
-        /* Boundary check and fix for burst correction */
-		state->burstCorrectionOld =
-            MATH_MIN((int32_t)MATH_MAX(state->burstCorrectionOld, -(int32_t)state->tRound), MaxRoundTime);
+/*
+ * Starts a new server period with full budget.
+ *
+ * @param task reserved task
+ * @param deadline new server deadline
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ReplenishBudget(TaskInfo* task, uint32_t deadline)
+{
+    task->reservation.remainingInUs = task->reservation.budgetInUs;
+    task->reservation.deadline = deadline;
+}
 
-        /* Calculate Next Round time using burst correction value */
-		nextRoundTime = (float)(state->tRound + state->burstCorrectionOld);
+/*
+ * Charges a reserved task for its burst.
+ *
+ *  Task is throttled until its server deadline if its budget is exhausted.
+ *
+ * @param task task which is run
+ * @param tProcess measured burst time of task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ChargeBudget(TaskInfo* task, uint32_t tProcess)
+{
+    Reservation* reservation = &task->reservation;
 
-        /* Save Round Error for next iteration in Controller */
-		state->errRoundOld = errRound;
+    if (reservation->budgetInUs != 0)
+    {
+        if (tProcess < reservation->remainingInUs)
+        {
+            reservation->remainingInUs -= tProcess;
+        }
+        else
+        {
+            reservation->remainingInUs = 0;
+            scheduler.throttledTasks |= TASK_BIT(task);
+        }
+    }
+}
 
-        /* Reset (actual/measured)round time */
-		state->tRound = 0;
+/*
+ * Replenishes budgets of throttled tasks whose server deadlines are reached.
+ *
+ *  Hard CBS rule : Budget is recharged and deadline is postponed by a period.
+ *
+ * @param none
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ReplenishBudgets(void)
+{
+    TaskSet throttledTasks = scheduler.throttledTasks;
+    TaskInfo* task;
 
-        /* Visit all tasks to calculate their burst times */
-        for (task = &scheduler.taskList[0]; task != LAST_TASK; task++)
-		{
-            taskState = &task->stateVariables;
+    while (throttledTasks != 0)
+    {
+        task = &scheduler.taskList[COUNT_TRAILING_ZEROS(throttledTasks)];
+        throttledTasks &= throttledTasks - 1;
 
-            /*
-             * Calculate set point for process (burst) time.
-             * Each task has its alpha and round time is shared between task
-             * using alpha.
-             *
-             *   Tt(k) = a(k) * (Tr(k) + bc(k))
-             */
-            taskState->tProcessSetPoint = (uint32_t)(taskState->alpha * nextRoundTime);
+        if (TimeIsReached(task->reservation.deadline) == BOOL_TRUE)
+        {
+            ReplenishBudget(task, task->reservation.deadline + task->reservation.periodInUs);
 
+            /* A task which is blocked for long time may be still behind */
+            if (TimeIsReached(task->reservation.deadline) == BOOL_TRUE)
+            {
+                ReplenishBudget(task, scheduler.now + task->reservation.periodInUs);
+            }
 
-            /*
-             * Calculate Burst Time in I Controller (Inner Loop)
-             *
-             *   b(k) = b(k - 1) + kI (Tt0(k - 1) - Tt(k - 1))
-             */
-            /* Process (Burst) Time Error Tt0(k - 1) - Tt(k - 1) */
-			errorTProcess = taskState->tProcessSetPoint - taskState->tProcess;
+            scheduler.throttledTasks &= ~TASK_BIT(task);
 
-            /* Task Burst Time for next Round */
-			burst = taskState->tBurstOld + errorTProcess;
+            /* Eligible task set is changed */
+            InvalidatePreparedDecision();
+        }
+    }
+}
 
-            /* Boundary check for burst time */
-			taskState->tBurstOld = AS_BURST_BOUNDARY_FIX(burst);
-		}
-	}
-#if AS_ENABLE_REINIT_REGULATOR
-	else
-	{
-        /* Clear flag first */
-		scheduler.flags.reInitRegulator = BOOL_FALSE;
+/*
+ * Limits idle burst to wake up at earliest replenishment of throttled tasks.
+ *
+ * @param burstTime idle burst time
+ * @return limited idle burst time
+ */
+PRIVATE ALWAYS_INLINE uint32_t LimitIdleBurst(uint32_t burstTime)
+{
+    TaskSet throttledTasks = scheduler.throttledTasks;
+    TaskInfo* task;
+    uint32_t timeToDeadline;
 
-		/* Reset Regulator first in case of reinitialization of regulator */
-        ResetRegulator();
+    while (throttledTasks != 0)
+    {
+        task = &scheduler.taskList[COUNT_TRAILING_ZEROS(throttledTasks)];
+        throttledTasks &= throttledTasks - 1;
 
-        /* Visit all tasks to calculate their burst times */
-		for (task = &scheduler.taskList[0]; task != LAST_TASK; task++)
-		{
-            taskState = &task->stateVariables;
+        /* Deadlines of throttled tasks are not reached yet */
+        timeToDeadline = task->reservation.deadline - scheduler.now;
 
-            /* Reset Process set point to initial value using Round Set Point */
-			taskState->tProcessSetPoint = (uint32_t)(taskState->alpha * state->tRoundSetPoint);
+        if (timeToDeadline < burstTime)
+        {
+            burstTime = timeToDeadline;
+        }
+    }
 
-            /* Reset to initial Burst value*/
-			burst = (int32_t)(taskState->tProcessSetPoint * AS_MULT_FACTOR);
+    return burstTime;
+}
 
-            /* Boundary check for burst time */
+/*
+ * Updates reservation of a woken task.
+ *
+ *  CBS wake-up rule : If remaining budget cannot be consumed until deadline
+ *  without exceeding reserved bandwidth (q >= (d - t) * Q / T), a new server
+ *  period is started from now.
+ *
+ * @param task woken task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void WakeUpReservation(TaskInfo* task)
+{
+    Reservation* reservation = &task->reservation;
+
+    if ((reservation->budgetInUs != 0) &&
+        ((scheduler.throttledTasks & TASK_BIT(task)) == 0))
+    {
+        if ((TimeIsReached(reservation->deadline) == BOOL_TRUE) ||
+            (((uint64_t)reservation->remainingInUs * reservation->periodInUs) >=
+             ((uint64_t)(reservation->deadline - scheduler.now) * reservation->budgetInUs)))
+        {
+            ReplenishBudget(task, scheduler.now + reservation->periodInUs);
+        }
+    }
+}
+#endif /* AS_ENABLE_RESERVATIONS */
+
+/*
+ * Calculates alpha of a task.
+ *
+ *  alpha = TaskPriority / TotalPriority
+ *
+ * @param priority priority (weight) of task
+ * @param sumOfPriorities sum of priorities (weights) of all tasks
+ *
+ * @return alpha of task
+ */
+PRIVATE ALWAYS_INLINE RegulatorFactor CalculateAlpha(uint32_t priority, uint32_t sumOfPriorities)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    return (RegulatorFactor)((priority << AS_Q_SHIFT) / sumOfPriorities);
+#else
+    return ((float)priority) / sumOfPriorities;
+#endif
+}
+
+/*
+ * Calculates change of burst correction in PI controller (outer loop)
+ *
+ *   KRR * ( Tr0(k - 1) - Tr(k-1) ) - KRR * ZRR * (Tr0(k - 2) - Tr(k - 2))
+ *
+ * @param gains gains of controller
+ * @param errRound Round Error : Tr0(k - 1) - Tr(k-1)
+ * @param errRoundOld Previous Round Error : Tr0(k - 2) - Tr(k - 2)
+ *
+ * @return Change of burst correction
+ */
+PRIVATE ALWAYS_INLINE int32_t CalculateBurstCorrectionDelta(RegulatorGains* gains, int32_t errRound, int32_t errRoundOld)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    int64_t delta = ((int64_t)gains->krr * errRound) - ((int64_t)gains->krrZrr * errRoundOld);
+
+    /*
+     * Round towards zero like float to integer conversion. Shifting a negative
+     * value rounds towards minus infinity so shift absolute value.
+     */
+    return (delta < 0) ? -(int32_t)((-delta) >> AS_Q_SHIFT) : (int32_t)(delta >> AS_Q_SHIFT);
+#else
+    return (int32_t)((gains->krr * errRound) - (gains->krrZrr * errRoundOld));
+#endif
+}
+
+/*
+ * Calculates set point for process (burst) time of a task
+ *
+ *   Tt(k) = a(k) * (Tr(k) + bc(k))
+ *
+ * @param alpha alpha of task
+ * @param roundTime next round time (Tr(k) + bc(k)). Never negative.
+ *
+ * @return set point for process time
+ */
+PRIVATE ALWAYS_INLINE uint32_t CalculateProcessSetPoint(RegulatorFactor alpha, int32_t roundTime)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    return (uint32_t)(((uint64_t)alpha * (uint32_t)roundTime) >> AS_Q_SHIFT);
+#else
+    return (uint32_t)(alpha * (float)roundTime);
+#endif
+}
+
+/*
+ * Converts burst value of regulator to burst time.
+ *
+ *  Inner integral regulator keeps burst value scaled by AS_MULT_FACTOR.
+ *  Called for each context switch so must be cheap.
+ *
+ * @param burst burst value (tBurstOld) of a task
+ *
+ * @return burst time in microseconds
+ */
+PRIVATE ALWAYS_INLINE uint32_t BurstToTime(uint32_t burst)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    /* burst <= AS_BURST_MAX_IN_US * AS_MULT_FACTOR so 32 bit is enough */
+    return (burst * (uint32_t)AS_KPI_Q) >> AS_Q_SHIFT;
+#else
+    return burst / AS_MULT_FACTOR;
+#endif
+}
+
+/*
+ * Returns burst time of a task limited with its remaining budget.
+ *
+ * @param task task to be run
+ * @return burst time of task in microseconds
+ */
+PRIVATE ALWAYS_INLINE uint32_t TaskBurstTime(TaskInfo* task)
+{
+    uint32_t burstTime = BurstToTime(task->stateVariables.tBurstOld);
+
+#if AS_ENABLE_SLICE_DONATION
+    /* Credit of task is added to its burst */
+    burstTime = MATH_MIN(burstTime + task->burstCreditInUs, AS_BURST_MAX_IN_US);
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    /* Preempted task only continues its burst */
+    if (task->remainingBurstInUs != 0)
+    {
+        burstTime = task->remainingBurstInUs;
+    }
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+#if AS_ENABLE_RESERVATIONS
+    if ((task->reservation.budgetInUs != 0) && (task->reservation.remainingInUs < burstTime))
+    {
+        burstTime = task->reservation.remainingInUs;
+    }
+#endif /* AS_ENABLE_RESERVATIONS */
+
+    return burstTime;
+}
+
+#if AS_ENABLE_SLICE_DONATION
+/*
+ * Consumes credit of a task when its burst is started.
+ *
+ * @param task started task
+ * @param burstTime burst time of task including credit
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ConsumeCredit(TaskInfo* task, uint32_t burstTime)
+{
+    uint32_t baseBurstTime = BurstToTime(task->stateVariables.tBurstOld);
+
+    /* Burst may be limited so only used part of credit is counted */
+    scheduler.burstCreditUsed = (burstTime > baseBurstTime) ? (burstTime - baseBurstTime) : 0;
+    task->burstCreditInUs = 0;
+}
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+/*
+ * Returns measurements of a task in actual round of its group.
+ *
+ * @param task task whose measurements are returned
+ * @return measurements of actual round
+ */
+PRIVATE ALWAYS_INLINE RoundMeasurements* ActualMeasurements(TaskInfo* task)
+{
+    return &task->stateVariables.measurements[task->group->measuredSet];
+}
+
+/*
+ * Returns processed time of a task in a round for regulator.
+ *
+ * @param measurements measurements of task in round
+ * @return processed time
+ */
+PRIVATE ALWAYS_INLINE int32_t ProcessedTime(RoundMeasurements* measurements)
+{
+#if AS_ENABLE_SLICE_DONATION
+    /* Given up time is a part of its share, used credit is a part of previous share */
+    return (int32_t)(measurements->tProcess + measurements->tYielded) - (int32_t)measurements->tCredit;
+#else
+    return (int32_t)measurements->tProcess;
+#endif /* AS_ENABLE_SLICE_DONATION */
+}
+
+#if AS_ENABLE_REINIT_REGULATOR
+/*
+ * Converts process time to burst value of regulator.
+ *
+ * @param tProcess process (burst) time in microseconds
+ *
+ * @return burst value (scaled by AS_MULT_FACTOR)
+ */
+PRIVATE ALWAYS_INLINE int32_t TimeToBurst(uint32_t tProcess)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    return (int32_t)(((uint64_t)tProcess * AS_MULT_FACTOR_Q) >> AS_Q_SHIFT);
+#else
+    return (int32_t)(tProcess * AS_MULT_FACTOR);
+#endif
+}
+
+/*
+ * Resets Regulator and state variables of a group
+ *
+ * @param group group whose regulator is reset
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ResetRegulator(SchedulingGroup* group)
+{
+    SchedulerStateVariables* state = &group->stateVariables;
+
+    state->tRound = 0;
+    state->errRoundOld = 0;
+    state->burstCorrectionOld = 0;
+}
+#endif
+
+#if AS_ENABLE_DYNAMIC_ROUND_SET_POINT
+/*
+ * Derives round time set point of a group from latency targets of its ready
+ * tasks.
+ *
+ *  A ready task waits at most a round for its next burst so round time must
+ *  not exceed the tightest latency. But each task in round costs a context
+ *  switch so round time must be long enough to keep switching overhead under
+ *  the limit :
+ *
+ *    (ReadyTaskCount * SwitchCost) / RoundTime <= MaxOverhead
+ *
+ * @param group group whose set point is updated
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void UpdateRoundSetPoint(SchedulingGroup* group)
+{
+    TaskSet readyTasks = scheduler.readyTasks & group->tasks;
+    uint32_t minLatency = 0xFFFFFFFFUL;
+    uint32_t readyTaskCount = 0;
+    uint32_t latency;
+    uint32_t roundTime;
+    TaskInfo* task;
+
+    if (group->fixedSetPoint == BOOL_TRUE)
+    {
+        return;
+    }
+
+    for (task = group->taskListBegin; task != group->taskListEnd; task++)
+    {
+        if (readyTasks & TASK_BIT(task))
+        {
+            readyTaskCount++;
+
+            latency = task->tcb->userTaskInfo->maxLatencyInUs;
+            if ((latency != 0) && (latency < minLatency))
+            {
+                minLatency = latency;
+            }
+        }
+    }
+
+    /* Nominal set point is used if there is no latency target */
+    if (minLatency == 0xFFFFFFFFUL)
+    {
+        group->stateVariables.tRoundSetPoint =
+            (uint32_t)(group->taskListEnd - group->taskListBegin) * AS_BURST_NOMINAL_IN_US;
+        return;
+    }
+
+    /* Shortest round which keeps switching overhead under the limit */
+    roundTime = (readyTaskCount * AS_CONTEXT_SWITCH_COST_IN_US * 100) / AS_MAX_SWITCH_OVERHEAD_PERCENT;
+
+    roundTime = MATH_MAX(roundTime, minLatency);
+
+    /* Bursts of tasks are limited so round time is also limited */
+    roundTime = MATH_MAX(roundTime, readyTaskCount * AS_BURST_MIN_IN_US);
+    roundTime = MATH_MIN(roundTime, readyTaskCount * AS_BURST_MAX_IN_US);
+
+    group->stateVariables.tRoundSetPoint = roundTime;
+}
+#endif /* AS_ENABLE_DYNAMIC_ROUND_SET_POINT */
+
+#if AS_ENABLE_SELF_TUNING
+/*
+ * Tunes outer loop gains of a group using its estimated plant gain.
+ *
+ *  Fixed gains are designed for nominal plant gain (KPI) so KRR is scaled to
+ *  keep loop gain at nominal value :
+ *
+ *    KRR(k) = KRR * KPI / g(k)
+ *
+ *  Gains are kept if plant gain can not be estimated (e.g. round time does
+ *  not follow burst corrections).
+ *
+ * @param group group whose round is closed
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void TuneGains(SchedulingGroup* group)
+{
+    PlantEstimator* estimator = &group->estimator;
+    /* Burst correction which is applied to measured round */
+    int64_t x = group->stateVariables.burstCorrectionOld;
+    /* Response of round time to burst correction */
+    int64_t y = (int64_t)group->regulatorInputs.tRound - estimator->tRoundOld;
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    int64_t krr;
+#else
+    float krr;
+#endif
+
+    estimator->tRoundOld = group->regulatorInputs.tRound;
+
+    /*
+     * Saturated tasks can not follow burst correction and small corrections
+     * are dominated by noise so these rounds do not say anything about plant.
+     */
+    if ((group->allReadyTasksSaturated == BOOL_TRUE) ||
+        ((x < AS_SELF_TUNING_MIN_EXCITATION_IN_US) && (x > -AS_SELF_TUNING_MIN_EXCITATION_IN_US)))
+    {
+        return;
+    }
+
+    estimator->sumXY += (x * y) - (estimator->sumXY >> AS_SELF_TUNING_FORGET_SHIFT);
+    estimator->sumXX += (x * x) - (estimator->sumXX >> AS_SELF_TUNING_FORGET_SHIFT);
+
+    if (estimator->sumXY <= 0)
+    {
+        return;
+    }
+
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    krr = (AS_Q(AS_KRR * AS_KPI) * estimator->sumXX) / estimator->sumXY;
+    krr = MATH_MIN(MATH_MAX(krr, AS_SELF_TUNING_KRR_MIN_Q), AS_SELF_TUNING_KRR_MAX_Q);
+
+    group->gains.krr = (RegulatorFactor)krr;
+    group->gains.krrZrr = (RegulatorFactor)((krr * AS_ZRR_Q) >> AS_Q_SHIFT);
+#else
+    krr = (AS_KRR * AS_KPI) * (float)estimator->sumXX / (float)estimator->sumXY;
+    krr = MATH_MIN(MATH_MAX(krr, AS_SELF_TUNING_KRR_MIN), AS_SELF_TUNING_KRR_MAX);
+
+    group->gains.krr = krr;
+    group->gains.krrZrr = krr * AS_ZRR;
+#endif
+}
+#endif /* AS_ENABLE_SELF_TUNING */
+
+#if AS_ENABLE_REGULATOR_STATISTICS
+/*
+ * Updates convergence statistics of a group with error of a closed round.
+ *
+ *  A disturbance starts when error leaves settling band. It is settled when
+ *  error stays in band for AS_SETTLING_ROUNDS rounds and its settling time is
+ *  number of rounds until the first of these rounds.
+ *
+ * @param group group whose round is closed
+ * @param errRound Round Error of closed round
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void UpdateStatistics(SchedulingGroup* group, int32_t errRound)
+{
+    RegulatorStatistics* statistics = &group->statistics;
+    OSRegulatorStatistics* results = &statistics->results;
+    uint32_t absError = (errRound < 0) ? (uint32_t)-errRound : (uint32_t)errRound;
+    uint32_t inBand = ((uint64_t)absError * 100) <=
+                      ((uint64_t)group->stateVariables.tRoundSetPoint * AS_SETTLING_BAND_PERCENT);
+    uint32_t settlingRounds;
+
+    results->rounds++;
+    results->sumOfAbsErrorsInUs += absError;
+
+    if (statistics->settling == BOOL_TRUE)
+    {
+        statistics->disturbanceRounds++;
+        statistics->inBandRounds = inBand ? (statistics->inBandRounds + 1) : 0;
+
+        if (statistics->inBandRounds == AS_SETTLING_ROUNDS)
+        {
+            settlingRounds = statistics->disturbanceRounds - (AS_SETTLING_ROUNDS - 1);
+
+            results->lastSettlingRounds = settlingRounds;
+            results->maxSettlingRounds = MATH_MAX(results->maxSettlingRounds, settlingRounds);
+            results->totalSettlingRounds += settlingRounds;
+
+            statistics->settling = BOOL_FALSE;
+        }
+    }
+    else if (inBand == BOOL_FALSE)
+    {
+        results->disturbances++;
+
+        statistics->settling = BOOL_TRUE;
+        statistics->disturbanceRounds = 0;
+        statistics->inBandRounds = 0;
+    }
+}
+#endif /* AS_ENABLE_REGULATOR_STATISTICS */
+
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+/*
+ * Sheds a task or restores a shed task and notifies application.
+ *
+ * @param task best-effort task
+ * @param shed BOOL_TRUE to shed task, BOOL_FALSE to restore it
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ShedTask(TaskInfo* task, uint32_t shed)
+{
+    /*
+     * Regulator runs in context switching handler but ready task set and
+     * prepared decision are also changed by ISRs, so eligible task set is
+     * changed in a critical section like in RunRegulator().
+     */
+    uint32_t interruptState = Kernel_DisableInterrupts();
+
+    if (shed == BOOL_TRUE)
+    {
+        scheduler.shedTasks |= TASK_BIT(task);
+    }
+    else
+    {
+        scheduler.shedTasks &= ~TASK_BIT(task);
+    }
+
+    /* Eligible task set is changed */
+    UpdateSaturationFlag(task->group);
+    InvalidatePreparedDecision();
+
+    Kernel_RestoreInterrupts(interruptState);
+
+    /* Application is notified with interrupts enabled */
+
+    if (scheduler.overloadCallback != NULL)
+    {
+        scheduler.overloadCallback(task->tcb->userTaskInfo,
+                                   shed ? OSOverloadEvent_TaskShed : OSOverloadEvent_TaskRestored);
+    }
+}
+
+/*
+ * Detects sustained overload of a group and sheds (or restores) its
+ * best-effort tasks.
+ *
+ *  One task is shed (least critical first) for each overload window so
+ *  only required load is shed. Tasks are restored in reverse order, one for
+ *  each recovery window.
+ *
+ * @param group group whose round is closed
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void ManageOverload(SchedulingGroup* group)
+{
+    uint64_t roundTime = (uint64_t)group->regulatorInputs.tRound * 100;
+    uint64_t setPoint = group->stateVariables.tRoundSetPoint;
+    uint32_t i;
+
+    if ((roundTime > setPoint * (100 + AS_OVERLOAD_MARGIN_PERCENT)) ||
+        ((group->allReadyTasksSaturated == BOOL_TRUE) && (roundTime > setPoint * 100)))
+    {
+        group->recoveryRounds = 0;
+
+        if (++group->overloadRounds >= AS_OVERLOAD_WINDOW_ROUNDS)
+        {
+            group->overloadRounds = 0;
+
+            for (i = 0; i < BEST_EFFORT_TASK_COUNT; i++)
+            {
+                if ((scheduler.sheddingOrder[i]->group == group) &&
+                    ((scheduler.shedTasks & TASK_BIT(scheduler.sheddingOrder[i])) == 0))
+                {
+                    ShedTask(scheduler.sheddingOrder[i], BOOL_TRUE);
+                    break;
+                }
+            }
+        }
+    }
+    else
+    {
+        group->overloadRounds = 0;
+
+        if ((scheduler.shedTasks & group->tasks) &&
+            (roundTime <= setPoint * (100 - AS_RECOVERY_MARGIN_PERCENT)))
+        {
+            if (++group->recoveryRounds >= AS_RECOVERY_WINDOW_ROUNDS)
+            {
+                group->recoveryRounds = 0;
+
+                for (i = BEST_EFFORT_TASK_COUNT; i > 0; i--)
+                {
+                    if (scheduler.shedTasks & TASK_BIT(scheduler.sheddingOrder[i - 1]) & group->tasks)
+                    {
+                        ShedTask(scheduler.sheddingOrder[i - 1], BOOL_FALSE);
+                        break;
+                    }
+                }
+            }
+        }
+        else
+        {
+            group->recoveryRounds = 0;
+        }
+    }
+}
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+/*
+ * Runs internal regulator of a group to tune system parameters.
+ *
+ *  Uses measurements of last closed round (regulator inputs) so it can be run
+ *  at the begining of the round or deferred until context switching hook.
+ *
+ * @param group group whose round is closed
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void RunRegulator(SchedulingGroup* group)
+{
+    /* Shortcuts to state variables*/
+    SchedulerStateVariables* state = &group->stateVariables;
+    RegulatorInputs* inputs = &group->regulatorInputs;
+    TaskStateVariables* taskState;
+    /* Measurement set of closed round. Other set is measured now. */
+    uint32_t closedSet = group->measuredSet ^ 1;
+    int32_t tProcessed;
+    int32_t nextRoundTime;
+	TaskInfo* task;
+	int32_t errorTProcess = 0;
+	int32_t burst = 0;
+    int32_t errRound = 0;
+    int32_t burstCorrection = 0;
+    uint32_t interruptState;
+#if AS_ENABLE_RUNTIME_PRIORITY
+    uint32_t prioritiesChanged;
+#endif /* AS_ENABLE_RUNTIME_PRIORITY */
+#if AS_ENABLE_ISR_PROFILING
+    uint32_t startCycle = Kernel_ReadCycleCounter();
+#endif /* AS_ENABLE_ISR_PROFILING */
+
+#if AS_ENABLE_RUNTIME_PRIORITY
+    /*
+     * Clear flag first so a priority change during the update is taken in
+     * next round.
+     */
+    prioritiesChanged = group->prioritiesChanged;
+    group->prioritiesChanged = BOOL_FALSE;
+#endif /* AS_ENABLE_RUNTIME_PRIORITY */
+
+#if AS_ENABLE_REINIT_REGULATOR
+	if (group->reInitRegulator == BOOL_FALSE)
+#endif /* AS_ENABLE_REINIT_REGULATOR */
+	{
+        /*
+         * Calculate burst correction in PI controller (outer loop)
+         *
+         *   bc(k) = bc(k - 1) +
+         *           KRR * ( Tr0(k - 1) - Tr(k-1) ) -
+         *           KRR * ZRR * (Tr0(k - 2) - Tr(k - 2))
+         *
+         */
+
+        /* Get Round Error : Tr0(k - 1) - Tr(k-1) */
+		errRound = state->tRoundSetPoint - inputs->tRound;
+
+#if AS_ENABLE_REGULATOR_STATISTICS
+        UpdateStatistics(group, errRound);
+#endif /* AS_ENABLE_REGULATOR_STATISTICS */
+
+#if AS_ENABLE_SELF_TUNING
+        /* Gains are tuned using response to previous burst correction */
+        TuneGains(group);
+#endif /* AS_ENABLE_SELF_TUNING */
+
+		burstCorrection = state->burstCorrectionOld +
+                          CalculateBurstCorrectionDelta(&group->gains, errRound, state->errRoundOld);
+
+        /*
+         * Apply Saturations.
+         *  Saturation flag is kept up to date on state transitions and burst
+         *  updates so no need to visit tasks here.
+         */
+		if (group->allReadyTasksSaturated == BOOL_TRUE)
+        {
+            /*
+             * Miosix Note : If all inner regulators reached upper saturation,
+             * allow only a decrease in the burst correction.
+             */
+            if (burstCorrection < state->burstCorrectionOld)
+			{
+				state->burstCorrectionOld = burstCorrection;
+			}
+		}
+		else
+		{
+            /* Save burst correction value for next iteration in I Controller */
+			state->burstCorrectionOld = burstCorrection;
+		}
+
+        /* Boundary check and fix for burst correction */
+		state->burstCorrectionOld =
+            MATH_MIN((int32_t)MATH_MAX(state->burstCorrectionOld, -(int32_t)inputs->tRound), group->maxRoundTime);
+
+        /* Calculate Next Round time using burst correction value */
+		nextRoundTime = (int32_t)inputs->tRound + state->burstCorrectionOld;
+
+        /* Save Round Error for next iteration in Controller */
+		state->errRoundOld = errRound;
+
+        /* Visit all tasks of group to calculate their burst times */
+        for (task = group->taskListBegin; task != group->taskListEnd; task++)
+		{
+            taskState = &task->stateVariables;
+
+#if AS_ENABLE_RUNTIME_PRIORITY
+            /*
+             * Shares follow new priorities in the same visit. Bursts and PI
+             * state are kept so regulator moves tasks to new shares smoothly.
+             */
+            if (prioritiesChanged == BOOL_TRUE)
+            {
+                taskState->alpha = CalculateAlpha(task->tcb->userTaskInfo->priority + 1, group->sumOfPriorities);
+            }
+#endif /* AS_ENABLE_RUNTIME_PRIORITY */
+
+            /*
+             * Calculate set point for process (burst) time.
+             * Each task has its alpha and round time is shared between task
+             * using alpha.
+             *
+             *   Tt(k) = a(k) * (Tr(k) + bc(k))
+             */
+            taskState->tProcessSetPoint = CalculateProcessSetPoint(taskState->alpha, nextRoundTime);
+
+
+            /*
+             * Calculate Burst Time in I Controller (Inner Loop)
+             *
+             *   b(k) = b(k - 1) + kI (Tt0(k - 1) - Tt(k - 1))
+             */
+            /*
+             * Processed time of task in closed round. If task is not run in
+             * round (e.g. it is not ready), its set keeps an older round so
+             * it is just zero.
+             */
+            tProcessed = (inputs->notRunTasks & TASK_BIT(task)) ?
+                         0 : ProcessedTime(&taskState->measurements[closedSet]);
+
+            /* Process (Burst) Time Error Tt0(k - 1) - Tt(k - 1) */
+			errorTProcess = (int32_t)taskState->tProcessSetPoint - tProcessed;
+
+            /* Task Burst Time for next Round */
+			burst = taskState->tBurstOld + errorTProcess;
+
+            /* Boundary check for burst time */
 			taskState->tBurstOld = AS_BURST_BOUNDARY_FIX(burst);
+
+            /* Keep saturated task set up to date */
+            UpdateTaskSaturation(task);
+		}
+	}
+#if AS_ENABLE_REINIT_REGULATOR
+	else
+	{
+        /* Clear flag first */
+		group->reInitRegulator = BOOL_FALSE;
+
+		/* Reset Regulator first in case of reinitialization of regulator */
+        ResetRegulator(group);
+
+        /* Visit all tasks of group to calculate their burst times */
+		for (task = group->taskListBegin; task != group->taskListEnd; task++)
+		{
+            taskState = &task->stateVariables;
+
+            /* Priorities (weights) of tasks of group may be changed */
+            taskState->alpha = CalculateAlpha(task->tcb->userTaskInfo->priority + 1, group->sumOfPriorities);
+
+            /* Reset Process set point to initial value using Round Set Point */
+			taskState->tProcessSetPoint = CalculateProcessSetPoint(taskState->alpha, (int32_t)state->tRoundSetPoint);
+
+            /* Reset to initial Burst value*/
+			burst = TimeToBurst(taskState->tProcessSetPoint);
+
+            /* Boundary check for burst time */
+			taskState->tBurstOld = AS_BURST_BOUNDARY_FIX(burst);
+
+            /* Keep saturated task set up to date */
+            UpdateTaskSaturation(task);
 		}
 	}
 #endif /* AS_ENABLE_REINIT_REGULATOR */
 
+    /*
+     * Saturated task set may be changed. Ready task set is changed by ISRs so
+     * flag is updated in a critical section not to overwrite their update.
+     */
+    interruptState = Kernel_DisableInterrupts();
+    UpdateSaturationFlag(group);
+    Kernel_RestoreInterrupts(interruptState);
+
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    /* Closed round is checked against set point of the round */
+    ManageOverload(group);
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+
+#if AS_ENABLE_DYNAMIC_ROUND_SET_POINT
+    /* Set point of next round for current ready tasks */
+    UpdateRoundSetPoint(group);
+#endif /* AS_ENABLE_DYNAMIC_ROUND_SET_POINT */
+
+#if AS_ENABLE_ISR_PROFILING
+    UpdateMaxCycles(&scheduler.profile.regulatorMaxCycles, startCycle);
+#endif /* AS_ENABLE_ISR_PROFILING */
 }
 
 /*
- * Find a (next) ready task from Task Pool.
- *  It is also set the preemption timer for next tasks
+ * Closes actual round of a group and saves its measurements for regulator.
  *
- * @param setBurstTimer Flag to set Burst Timer for preemption or not.
+ *  Called in Burst Timer ISR when all ready tasks of group are run. Regulator
+ *  is run here or deferred to context switching hook according to
+ *  configuration.
+ *
+ * @param group group whose round is closed
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void CloseRound(SchedulingGroup* group)
+{
+#if AS_ENABLE_DEFERRED_REGULATOR
+    /*
+     * If regulator of previous round is still not completed (round is shorter
+     * than regulator execution), measurements of this round are discarded to
+     * keep inputs of running regulator consistent.
+     */
+    if (group->regulatorPending == BOOL_FALSE)
+#endif /* AS_ENABLE_DEFERRED_REGULATOR */
+    {
+        group->regulatorInputs.tRound = group->stateVariables.tRound;
+        group->regulatorInputs.notRunTasks = scheduler.roundPendingTasks & group->tasks;
+
+        /*
+         * Measurements of tasks are kept in their set and next round is
+         * measured into other set while regulator runs. Constant time, tasks
+         * are not visited.
+         */
+        group->measuredSet ^= 1;
+
+#if AS_ENABLE_DEFERRED_REGULATOR
+        group->regulatorPending = BOOL_TRUE;
+#endif /* AS_ENABLE_DEFERRED_REGULATOR */
+    }
+
+    /* Reset (actual/measured)round time */
+    group->stateVariables.tRound = 0;
+
+    /* New round for all tasks of group */
+    scheduler.roundPendingTasks |= group->tasks;
+
+#if !AS_ENABLE_DEFERRED_REGULATOR
+    /* Run regulator to tune system parameters */
+    RunRegulator(group);
+#endif /* AS_ENABLE_DEFERRED_REGULATOR */
+}
+
+/*
+ * Returns highest priority group which has an eligible task.
+ *
+ *  Groups are consecutive in task list in priority order so group of first
+ *  eligible task is the highest priority group.
+ *
+ * @param eligibleTasks set of eligible tasks. Must not be empty.
+ * @return highest priority group which has an eligible task
+ */
+PRIVATE ALWAYS_INLINE SchedulingGroup* HighestEligibleGroup(TaskSet eligibleTasks)
+{
+    return scheduler.taskList[COUNT_TRAILING_ZEROS(eligibleTasks)].group;
+}
+
+#if AS_ENABLE_PIPELINED_SCHEDULING
+/*
+ * Prepares next task and its burst time while current task runs.
+ *
+ *  Only next task in current round is prepared. Round closing and idle task
+ *  selection are left to Burst Timer ISR.
+ *
+ *  Preparation may be preempted by an ISR which changes scheduling state so
+ *  decision is published first and discarded if state version is changed.
+ *
+ * @param none
  * @return none
+ */
+PRIVATE ALWAYS_INLINE void PrepareNextTask(void)
+{
+    uint32_t version = scheduler.stateVersion;
+    TaskSet eligibleTasks = EligibleTasks();
+    TaskSet candidateTasks = 0;
+    TaskInfo* nextTask;
+
+    if (eligibleTasks != 0)
+    {
+        /* Only pending tasks of highest priority group in current round */
+        candidateTasks = eligibleTasks & scheduler.roundPendingTasks &
+                         HighestEligibleGroup(eligibleTasks)->tasks;
+    }
+
+    if (candidateTasks != 0)
+    {
+        nextTask = &scheduler.taskList[COUNT_TRAILING_ZEROS(candidateTasks)];
+
+        /* Burst time first, ISR only reads it if task is published */
+        scheduler.preparedDecision.burstTime = TaskBurstTime(nextTask);
+        scheduler.preparedDecision.task = nextTask;
+
+        if (version != scheduler.stateVersion)
+        {
+            /* State is changed during preparation so decision is stale */
+            scheduler.preparedDecision.task = NULL;
+        }
+    }
+}
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
+
+#if AS_ENABLE_CS_HOOK
+/*
+ * Context switching hook to run deferred works.
+ *
+ *  Called from context switching handler which has the lowest interrupt
+ *  priority so these works do not extend Burst Timer ISR.
+ *
+ * @param none
+ * @return none
+ */
+PRIVATE void ContextSwitchHook(void)
+{
+#if AS_ENABLE_DEFERRED_REGULATOR
+    SchedulingGroup* group;
+
+    uint32_t interruptState;
+
+    for (group = &scheduler.groups[0]; group != &scheduler.groups[GROUP_COUNT]; group++)
+    {
+        if (group->regulatorPending == BOOL_TRUE)
+        {
+            RunRegulator(group);
+
+            /* Burst Timer ISR must not switch task while its burst is restarted */
+            interruptState = Kernel_DisableInterrupts();
+
+            /*
+             * First task of new round is started with its previous burst
+             * because regulator was not run yet. Restart its burst with the
+             * new one.
+             */
+            if (scheduler.currentTask == group->regulatorInputs.firstTask)
+            {
+#if AS_ENABLE_SLICE_DONATION
+                uint32_t burstTime;
+
+                /* Used credit is added to new burst again */
+                scheduler.currentTask->burstCreditInUs = scheduler.burstCreditUsed;
+                burstTime = TaskBurstTime(scheduler.currentTask);
+                ConsumeCredit(scheduler.currentTask, burstTime);
+
+                SetBurstTimer(burstTime);
+#else
+                SetBurstTimer(TaskBurstTime(scheduler.currentTask));
+#endif /* AS_ENABLE_SLICE_DONATION */
+            }
+
+            group->regulatorPending = BOOL_FALSE;
+
+            Kernel_RestoreInterrupts(interruptState);
+        }
+    }
+#endif /* AS_ENABLE_DEFERRED_REGULATOR */
+
+#if AS_ENABLE_PIPELINED_SCHEDULING
+    /* Bursts are up to date so next task can be prepared */
+    PrepareNextTask();
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
+}
+#endif /* AS_ENABLE_CS_HOOK */
+
+/*
+ * Ends burst of current task and updates its measurements.
  *
+ * @param none
+ * @return measured burst time of current task
  */
-PRIVATE void FindNextTask(uint32_t setBurstTimer)
+PRIVATE ALWAYS_INLINE uint32_t EndBurst(void)
 {
-    TaskInfo* nextTask;
     uint32_t tProcess;
-	uint32_t nextBurstTime;
+
+	/* Measure actual burst time */
+    tProcess = Kernel_GetPreemptionTimeStamp(scheduler.timer);
 
 	/* Do not evaluate idle task */
     if (scheduler.flags.taskIsIdle == 0)
 	{
-	/* Measure actual burst time */
-        tProcess = Kernel_GetPreemptionTimeStamp(scheduler.timer);
-
-        /* Save burst time into task */
-        scheduler.currentTask->stateVariables.tProcess = tProcess;
+        RoundMeasurements* measurements = ActualMeasurements(scheduler.currentTask);
 
-        /* Add burst time to obtain actual round time */
-		scheduler.stateVariables.tRound += tProcess;
+#if AS_ENABLE_SLICE_DONATION
+        if (scheduler.flags.burstDonated == BOOL_TRUE)
+        {
+            /* Donated burst is a part of donor's share, not the running task */
+            scheduler.flags.burstDonated = BOOL_FALSE;
+        }
+        else
+#endif /* AS_ENABLE_SLICE_DONATION */
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+        if (scheduler.flags.burstContinued == BOOL_TRUE)
+        {
+            /* Task is preempted in this round so burst is sum of its parts */
+            measurements->tProcess += tProcess;
+#if AS_ENABLE_SLICE_DONATION
+            measurements->tYielded += scheduler.burstYielded;
+            measurements->tCredit += scheduler.burstCreditUsed;
+#endif /* AS_ENABLE_SLICE_DONATION */
+        }
+        else
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+        {
+            /* Save burst time into task */
+            measurements->tProcess = tProcess;
+#if AS_ENABLE_SLICE_DONATION
+            measurements->tYielded = scheduler.burstYielded;
+            measurements->tCredit = scheduler.burstCreditUsed;
+#endif /* AS_ENABLE_SLICE_DONATION */
+        }
+
+        /* Add burst time to obtain actual round time of task group */
+		scheduler.currentTask->group->stateVariables.tRound += tProcess;
+
+#if AS_ENABLE_RESERVATIONS
+        ChargeBudget(scheduler.currentTask, tProcess);
+#endif /* AS_ENABLE_RESERVATIONS */
 	}
     else
     {
@@ -435,87 +1778,218 @@ PRIVATE void FindNextTask(uint32_t setBurstTimer)
         scheduler.flags.taskIsIdle = BOOL_FALSE;
     }
 
-    /* Start with current task to find next task */
-    nextTask = scheduler.currentTask;
+#if AS_ENABLE_RESERVATIONS
+    /* Idle bursts are also counted to keep scheduler time */
+    scheduler.now += tProcess;
 
-	while (1)
-	{
-		/* Get next in the task list */
-        nextTask++;
+    ReplenishBudgets();
+#endif /* AS_ENABLE_RESERVATIONS */
 
-        /* If we reach the last task, we need to re-evaluate task list. */
-        if (nextTask == LAST_TASK)
-		{
+#if AS_ENABLE_SLICE_DONATION
+    scheduler.burstYielded = 0;
+    scheduler.burstCreditUsed = 0;
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+    return tProcess;
+}
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+/*
+ * Preempts running task to run a woken latency sensitive task immediately.
+ *
+ *  Preempted task is put back into its round with its remaining burst so it
+ *  does not lose its share. Its process time is accumulated when it
+ *  continues so regulator sees its whole burst in the round.
+ *
+ * @param task woken task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void PreemptRunningTask(TaskInfo* task)
+{
+    TaskInfo* preemptedTask = scheduler.currentTask;
+    uint32_t burstTime = scheduler.burstTime;
+    uint32_t keepBurst = !scheduler.flags.taskIsIdle;
+    uint32_t tProcess;
+
+#if AS_ENABLE_SLICE_DONATION
+    /* Donation is over if donated burst is preempted */
+    keepBurst = keepBurst && !scheduler.flags.burstDonated;
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+    tProcess = EndBurst();
+
+    if ((keepBurst == BOOL_TRUE) && (tProcess < burstTime))
+    {
+        /* Continue preempted burst in this round */
+        preemptedTask->remainingBurstInUs = burstTime - tProcess;
+        scheduler.roundPendingTasks |= TASK_BIT(preemptedTask);
+    }
+
+    /*
+     * If woken task is already run in this round (e.g. it blocked before its
+     * burst ended), new burst is also a part of its burst in this round.
+     */
+    scheduler.flags.burstContinued = (task->remainingBurstInUs != 0) ||
+                                     ((scheduler.roundPendingTasks & TASK_BIT(task)) == 0);
+
+    /* Task is run in current round */
+    scheduler.roundPendingTasks &= ~TASK_BIT(task);
+
+    scheduler.currentTask = task;
+    burstTime = TaskBurstTime(task);
+
+#if AS_ENABLE_SLICE_DONATION
+    if (task->remainingBurstInUs == 0)
+    {
+        ConsumeCredit(task, burstTime);
+    }
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+    SetBurstTimer(burstTime);
+    task->remainingBurstInUs = 0;
+
+    /* Round pending tasks are changed */
+    InvalidatePreparedDecision();
+
+    /* Notify kernel and pass woken task (TCB) */
+    scheduler.csCallback(task->tcb);
+}
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+/*
+ * Selects next task using task sets.
+ *
+ *  Ready tasks are kept in task sets so next task is found in constant time
+ *  without visiting task list. Next task is selected from highest priority
+ *  group which has an eligible task. Closes the round of group if all ready
+ *  tasks of group are run.
+ *
+ * @param burstTime burst time of selected task
+ *
+ * @return selected task
+ */
+PRIVATE ALWAYS_INLINE TaskInfo* SelectNextTask(uint32_t* burstTime)
+{
+    TaskInfo* nextTask = &scheduler.idleTask;
+    TaskSet eligibleTasks = EligibleTasks();
+    TaskSet candidateTasks = 0;
+    SchedulingGroup* group = NULL;
+    uint32_t roundClosed = BOOL_FALSE;
+
+    if (eligibleTasks != 0)
+    {
+        group = HighestEligibleGroup(eligibleTasks);
+
+        /* Ready tasks of group which are not run in current round yet */
+        candidateTasks = eligibleTasks & group->tasks & scheduler.roundPendingTasks;
+    }
+
+    if (candidateTasks == 0)
+    {
+        if (eligibleTasks == 0)
+        {
             /*
-             * TODO
-             * 	- Find ready task count.
-             * 	  If there is no ready task, run the idle task.
-             *
-             * 	  TODO For now, do not run idle task until support task states.
-             *
-             * 	- Find out whether all threads are saturated or not.
-             * 	  if All task's tBurstOld value is higher than BURST_MAX_IN_US,
-             * 	  it means all tasks are saturated and this information should
-             * 	  be passed to regulator.
-             *
-             * 	  [IMP] : This block works for each round so cost of finding
-             * 	  ready task count and saturation check is amortized to number
-             * 	  of tasks. On the other hand, even if it is amortized, it still
-             *    increases the grown rate asymptotically by n so it adds
-             *    additional cost for context switching at the beginning of each
-             *    round. Instead, we may distribute these findings to each
-             *    context switching or we may find out a way which does not need
-             *    to visit all task to get ready task count or saturations.
+             * If there is no ready (and not throttled) task, we run idle
+             * task. Round is not completed because there is no measurement
+             * for regulator.
              */
+            nextTask = &scheduler.idleTask;
 
-            if (0) /* Do not run idle task until */
-            //TODO if (NUM of READ TASKS EQUALS TO 0)
-            {
-				/* If there is no ready task, we run idle task */
-                nextTask = &scheduler.idleTask;
+            /* Set Burst Time for Idle Task */
+            *burstTime = AS_IDLE_THREAD_BURST_IN_US;
 
-				/* Set Burst Time for Idle Task */
-                nextBurstTime = AS_IDLE_THREAD_BURST_IN_US;
+#if AS_ENABLE_RESERVATIONS
+            /* Do not delay replenishment of throttled tasks */
+            *burstTime = LimitIdleBurst(*burstTime);
+#endif /* AS_ENABLE_RESERVATIONS */
 
-                /* Notify about IDLE Task */
-				scheduler.flags.taskIsIdle = BOOL_TRUE;
+            /* Notify about IDLE Task */
+            scheduler.flags.taskIsIdle = BOOL_TRUE;
+        }
+        else
+        {
+            /* All ready tasks of group are run so round is completed. */
+            CloseRound(group);
+            roundClosed = BOOL_TRUE;
 
-                /* next task (idle) is found so break to search */
-				break;
-			}
+            candidateTasks = eligibleTasks & group->tasks;
+        }
+    }
+
+    if (candidateTasks != 0)
+    {
+        /* Run ready tasks in task list order in a round */
+        nextTask = &scheduler.taskList[COUNT_TRAILING_ZEROS(candidateTasks)];
 
-			/* Round is completed, turn back to first task for new round*/
-            nextTask = &scheduler.taskList[0];
+        /* Task is run in current round */
+        scheduler.roundPendingTasks &= ~TASK_BIT(nextTask);
 
-			/* Run regulator to tune system parameters */
-            RunRegulator();
-		}
+        /* Calculate Burst Time for Next Task */
+        *burstTime = TaskBurstTime(nextTask);
 
-        /*
-         * TODO [IMP] Until we support task state feature, all task are in
-         * ready state for now.
-         */
-		if (nextTask->state == OSTaskState_Ready)
-		{
-			/* Calculate Burst Time for Next Task */
-            nextBurstTime = nextTask->stateVariables.tBurstOld / AS_MULT_FACTOR;
+        if (roundClosed == BOOL_TRUE)
+        {
+            /* Keep first task of round to update its burst after regulator */
+            group->regulatorInputs.firstTask = nextTask;
+        }
+    }
 
-            /* next task (and its burst time) is found so break the search */
-            break;
-		}
-		else
-		{
-			/*
-			 * This task is not ready so it is not run in current round.
-			 * So, it is processing (burst) time is just zero.
-			 */
-			nextTask->stateVariables.tProcess = 0;
-
-			/*
-			 * Do not break searching here and continue to find a ready task.
-			 */
-		}
-	}
+    return nextTask;
+}
+
+/*
+ * Find a (next) ready task from Task Pool.
+ *  It is also set the preemption timer for next tasks
+ *
+ *  If a valid decision is prepared while current task runs, it is just
+ *  committed. Otherwise next task is selected here.
+ *
+ * @param setBurstTimer Flag to set Burst Timer for preemption or not.
+ * @return none
+ *
+ */
+PRIVATE void FindNextTask(uint32_t setBurstTimer)
+{
+    TaskInfo* nextTask;
+	uint32_t nextBurstTime;
+
+    /* Burst of current task is ended */
+    EndBurst();
+
+#if AS_ENABLE_PIPELINED_SCHEDULING
+    /* Take prepared decision (if any) */
+    nextTask = scheduler.preparedDecision.task;
+    nextBurstTime = scheduler.preparedDecision.burstTime;
+
+    /* Decision is consumed and scheduling state is changed in any case */
+    InvalidatePreparedDecision();
+
+    if (nextTask != NULL)
+    {
+        /* Commit prepared decision. Task is run in current round. */
+        scheduler.roundPendingTasks &= ~TASK_BIT(nextTask);
+    }
+    else
+#endif /* AS_ENABLE_PIPELINED_SCHEDULING */
+    {
+        nextTask = SelectNextTask(&nextBurstTime);
+    }
+
+#if AS_ENABLE_SLICE_DONATION
+    /* Credit is already consumed if task continues its burst */
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    if (nextTask->remainingBurstInUs == 0)
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+    {
+        ConsumeCredit(nextTask, nextBurstTime);
+    }
+#endif /* AS_ENABLE_SLICE_DONATION */
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    /* Preempted task continues its burst so its process time is accumulated */
+    scheduler.flags.burstContinued = (nextTask->remainingBurstInUs != 0);
+    nextTask->remainingBurstInUs = 0;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
 
 	/* Save next task*/
     scheduler.currentTask = nextTask;
@@ -533,6 +2007,69 @@ PRIVATE void FindNextTask(uint32_t setBurstTimer)
     }
 }
 
+/*
+ * Initializes scheduling groups and assigns tasks to groups.
+ *
+ * @param definitions static group definitions (GROUP_COUNT groups). Not used
+ *        if scheduling groups are disabled.
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeGroups(const OSSchedulingGroup* definitions)
+{
+    SchedulingGroup* group;
+    TaskInfo* task = &scheduler.taskList[0];
+    uint32_t taskCount;
+    uint32_t roundSetPoint;
+    uint32_t i;
+
+    for (i = 0; i < GROUP_COUNT; i++)
+    {
+        group = &scheduler.groups[i];
+
+#if AS_ENABLE_SCHEDULING_GROUPS
+        taskCount = definitions[i].taskCount;
+        roundSetPoint = definitions[i].roundSetPointInUs;
+#else
+        (void)definitions;
+        taskCount = TASK_COUNT;
+        roundSetPoint = 0;
+#endif /* AS_ENABLE_SCHEDULING_GROUPS */
+
+        /* Nominal set point is used if group does not have a fixed one */
+        if (roundSetPoint == 0)
+        {
+            roundSetPoint = taskCount * AS_BURST_NOMINAL_IN_US;
+        }
+        else
+        {
+            group->fixedSetPoint = BOOL_TRUE;
+        }
+        group->stateVariables.tRoundSetPoint = roundSetPoint;
+        group->maxRoundTime = AS_BURST_MAX_IN_US * taskCount;
+
+        /* Regulator starts with fixed gains */
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+        group->gains.krr = AS_KRR_Q;
+        group->gains.krrZrr = AS_KRR_ZRR_Q;
+#else
+        group->gains.krr = AS_KRR;
+        group->gains.krrZrr = AS_KRR * AS_ZRR;
+#endif
+
+        /* Group takes next tasks in task list */
+        group->taskListBegin = task;
+        for (; taskCount > 0; taskCount--, task++)
+        {
+            task->group = group;
+            group->tasks |= TASK_BIT(task);
+        }
+        group->taskListEnd = task;
+    }
+
+    /* Groups must cover all tasks */
+    DEBUG_ASSERT(task == LAST_TASK);
+}
+
 /*
  * Initializes tasks for Adaptive Scheduling and prepares task state variables
  *
@@ -545,8 +2082,10 @@ PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
     TCB* tcb = &tcbList[0];
     /* Internal task object for adaptive scheduling */
     TaskInfo* task;
-    /* Keeps sum of priorities of all tasks */
-    uint32_t sumOfPriorities = 0;
+    SchedulingGroup* group;
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    uint32_t i;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
 
     for (task = &scheduler.taskList[0]; task != LAST_TASK; task++, tcb++)
     {
@@ -559,23 +2098,75 @@ PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
         /* Initial burst value for Task */
         task->stateVariables.tBurstOld = AS_BURST_NOMINAL_IN_US * AS_MULT_FACTOR;
 
-        /* Calculate the sum of Priorities */
-        sumOfPriorities += tcb->userTaskInfo->priority + 1;
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+        /* Tasks with latency targets can not wait for end of running burst */
+        if (tcb->userTaskInfo->maxLatencyInUs != 0)
+        {
+            scheduler.urgentTasks |= TASK_BIT(task);
+        }
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+#if AS_ENABLE_RESERVATIONS
+        /* Tasks declared with a budget (see OS_RESERVED_USER_TASK) are reserved */
+        if (tcb->userTaskInfo->budgetInUs != 0)
+        {
+            task->reservation.budgetInUs = tcb->userTaskInfo->budgetInUs;
+            task->reservation.periodInUs = tcb->userTaskInfo->serverPeriodInUs;
+            ReplenishBudget(task, task->reservation.periodInUs);
+        }
+#endif /* AS_ENABLE_RESERVATIONS */
+
     }
 
-    /*
-     * Find the alpha for each task.
-     *  alpha = TaskPriority / TotalPriority
-     */
-    for (task = &scheduler.taskList[0]; task != LAST_TASK; task++)
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    /* Find tasks of declared best-effort (user) tasks */
+    for (i = 0; i < BEST_EFFORT_TASK_COUNT; i++)
     {
-        task->stateVariables.alpha = ((float)(task->tcb->userTaskInfo->priority + 1)) / sumOfPriorities;
+        for (task = &scheduler.taskList[0]; task != LAST_TASK; task++)
+        {
+            if ((void*)task->tcb->userTaskInfo == bestEffortTasks[i])
+            {
+                scheduler.sheddingOrder[i] = task;
+            }
+        }
+
+        /* Best-effort tasks must be startup applications */
+        DEBUG_ASSERT(scheduler.sheddingOrder[i] != NULL);
     }
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
 
-#if AS_ENABLE_REINIT_REGULATOR
-    /* Reinit Regulator for the first time */
-    scheduler.flags.reInitRegulator = BOOL_TRUE;
-#endif /* AS_ENABLE_REINIT_REGULATOR */
+    /* All tasks are ready at startup */
+    scheduler.readyTasks = TASK_SET_ALL;
+    scheduler.readyTaskCount = TASK_COUNT;
+
+    for (group = &scheduler.groups[0]; group != &scheduler.groups[GROUP_COUNT]; group++)
+    {
+        /* Round of a group is shared between tasks of group */
+        group->sumOfPriorities = 0;
+        for (task = group->taskListBegin; task != group->taskListEnd; task++)
+        {
+            group->sumOfPriorities += task->tcb->userTaskInfo->priority + 1;
+        }
+
+        /*
+         * Find the alpha for each task.
+         *  alpha = TaskPriority / TotalPriority (in group)
+         */
+        for (task = group->taskListBegin; task != group->taskListEnd; task++)
+        {
+            task->stateVariables.alpha = CalculateAlpha(task->tcb->userTaskInfo->priority + 1, group->sumOfPriorities);
+        }
+
+#if AS_ENABLE_DYNAMIC_ROUND_SET_POINT
+        /* Set point of first round */
+        UpdateRoundSetPoint(group);
+#endif /* AS_ENABLE_DYNAMIC_ROUND_SET_POINT */
+
+#if OS_TASK_CREATION != OS_TASK_CREATION_STATIC
+        /* Reinit Regulator for the first time */
+        group->reInitRegulator = BOOL_TRUE;
+#endif
+    }
 }
 
 /*
@@ -587,26 +2178,17 @@ PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
  */
 PRIVATE ALWAYS_INLINE void InitializeScheduler(void)
 {
-    /* For now, Set point for Round Time  is constant */
-    scheduler.stateVariables.tRoundSetPoint = TASK_COUNT * AS_BURST_NOMINAL_IN_US;
-
-    /*
-     * IMP Following initializations seem hacky but to avoid unnecesssary if checks
-     * for each context switch, they are helpfull.
-     */
-
-    /*
-     * FindNextTask() function increases the current task (to get next task)
-     * first so let's start with -1 indexed item to run first
-     */
-    scheduler.currentTask = scheduler.taskList;
-    scheduler.currentTask--;
+    /* First round starts with all tasks */
+    scheduler.roundPendingTasks = TASK_SET_ALL;
 
     /*
+     * Kernel starts with idle task so current task is idle.
+     *
      * FindNextTask measures elapsed time for running task but for the first
      * time, there is no running time so we should discard time measurement.
      * FindNextTask only discard measurement if running task is idle.
      */
+    scheduler.currentTask = &scheduler.idleTask;
     scheduler.flags.taskIsIdle = 1;
 }
 
@@ -632,6 +2214,21 @@ PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCal
     /* Save Idle TCB to run idle task if there is no ready task in next round*/
     scheduler.idleTask.tcb = idleTCB;
 
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+#if AS_ENABLE_CS_HOOK
+    /* Deferred works are run in context switching hook */
+    Kernel_SetContextSwitchHook(ContextSwitchHook);
+#endif /* AS_ENABLE_CS_HOOK */
+
+    /* Partition tasks into scheduling groups */
+#if AS_ENABLE_SCHEDULING_GROUPS
+    InitializeGroups(schedulingGroups);
+#else
+    InitializeGroups(NULL);
+#endif /* AS_ENABLE_SCHEDULING_GROUPS */
+
     /* Initialize Tasks for Adaptive Scheduling */
     InitializeTasks(tcbList);
 
@@ -648,6 +2245,251 @@ PUBLIC void Scheduler_Yield(void)
     scheduler.csCallback(scheduler.currentTask->tcb);
 }
 
+/*
+ * Yields running task and donates unused part of its burst.
+ *
+ *  Target task runs the donated part immediately without losing its own
+ *  burst in the round. If there is no target, unused part is kept as credit
+ *  for the next burst of running task.
+ */
+PUBLIC void Scheduler_YieldTo(TCB* tcb)
+{
+#if AS_ENABLE_SLICE_DONATION
+    /*
+     * Burst Timer ISR must not end or switch running task while its unused
+     * burst is being donated.
+     */
+    uint32_t interruptState = Kernel_DisableInterrupts();
+    TaskInfo* task = scheduler.currentTask;
+    TaskInfo* target = NULL;
+    uint32_t tProcess = Kernel_GetPreemptionTimeStamp(scheduler.timer);
+    uint32_t unusedBurst = (scheduler.burstTime > tProcess) ? (scheduler.burstTime - tProcess) : 0;
+
+    if (tcb != NULL)
+    {
+        target = &scheduler.taskList[tcb - scheduler.tcbList];
+
+        /* Donation is only possible to another eligible task */
+        if ((target == task) || ((EligibleTasks() & TASK_BIT(target)) == 0))
+        {
+            target = NULL;
+            unusedBurst = 0;
+        }
+    }
+
+    /* Idle task and donated bursts can not be donated again */
+    if ((scheduler.flags.taskIsIdle == BOOL_TRUE) || (scheduler.flags.burstDonated == BOOL_TRUE))
+    {
+        Scheduler_Yield();
+    }
+    else
+    {
+        if (target == NULL)
+        {
+            /* Keep unused burst as (bounded) credit */
+            unusedBurst = MATH_MIN(unusedBurst, AS_MAX_BURST_CREDIT_IN_US);
+            task->burstCreditInUs = unusedBurst;
+
+            /* Burst of running task is changed */
+            InvalidatePreparedDecision();
+        }
+
+        /* Given up time is counted as processed time of running task */
+        scheduler.burstYielded = unusedBurst;
+
+        if ((target == NULL) || (unusedBurst == 0))
+        {
+            Scheduler_Yield();
+        }
+        else
+        {
+            EndBurst();
+
+            /* Target runs donated burst in behalf of donor */
+            scheduler.currentTask = target;
+            scheduler.flags.burstDonated = BOOL_TRUE;
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+            scheduler.flags.burstContinued = BOOL_FALSE;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+            SetBurstTimer(unusedBurst);
+
+            InvalidatePreparedDecision();
+
+            scheduler.csCallback(target->tcb);
+        }
+    }
+
+    /* Context switch is performed when interrupts are restored */
+    Kernel_RestoreInterrupts(interruptState);
+#else
+    (void)tcb;
+
+    Scheduler_Yield();
+#endif /* AS_ENABLE_SLICE_DONATION */
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  Only updates ready task set (and related counters/flags) in constant time.
+ *  A woken task may preempt running task if wake-up preemption is enabled.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+    TaskSet taskBit;
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    uint32_t wokenUp = BOOL_FALSE;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+    AS_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    taskBit = TASK_BIT(task);
+
+    /* Running task is also a ready task for scheduling */
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if ((scheduler.readyTasks & taskBit) == 0)
+        {
+            scheduler.readyTasks |= taskBit;
+            scheduler.readyTaskCount++;
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+            wokenUp = BOOL_TRUE;
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+
+#if AS_ENABLE_RESERVATIONS
+            WakeUpReservation(task);
+#endif /* AS_ENABLE_RESERVATIONS */
+        }
+    }
+    else
+    {
+        if (scheduler.readyTasks & taskBit)
+        {
+            scheduler.readyTasks &= ~taskBit;
+            scheduler.readyTaskCount--;
+        }
+    }
+
+    task->state = state;
+
+    /* Ready task set is changed */
+    UpdateSaturationFlag(task->group);
+    InvalidatePreparedDecision();
+
+#if AS_ENABLE_WAKE_UP_PREEMPTION
+    /* Throttled tasks wait for replenishment even if they are urgent */
+    if ((wokenUp == BOOL_TRUE) && (EligibleTasks() & taskBit))
+    {
+        if (scheduler.flags.taskIsIdle == BOOL_TRUE)
+        {
+            /* Idle task is preempted by any task */
+            Scheduler_Yield();
+        }
+        else if ((scheduler.urgentTasks & taskBit) &&
+                 ((scheduler.urgentTasks & TASK_BIT(scheduler.currentTask)) == 0) &&
+                 (task->group <= scheduler.currentTask->group))
+        {
+            /*
+             * Urgent tasks do not preempt each other to avoid ping-pong. Groups
+             * are in priority order so a task of a lower priority group does
+             * not preempt a task of a higher priority group.
+             */
+            PreemptRunningTask(task);
+        }
+    }
+#endif /* AS_ENABLE_WAKE_UP_PREEMPTION */
+}
+
+/*
+ * Returns round time set point of group of a task.
+ */
+PUBLIC uint32_t Scheduler_GetRoundSetPoint(TCB* tcb)
+{
+    return scheduler.taskList[tcb - scheduler.tcbList].group->stateVariables.tRoundSetPoint;
+}
+
+/*
+ * Reads convergence statistics of regulator of group of a task.
+ */
+PUBLIC uint32_t Scheduler_GetRegulatorStatistics(TCB* tcb, OSRegulatorStatistics* statistics)
+{
+#if AS_ENABLE_REGULATOR_STATISTICS
+    SchedulingGroup* group = scheduler.taskList[tcb - scheduler.tcbList].group;
+
+    *statistics = group->statistics.results;
+
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+    statistics->krrQ16 = group->gains.krr;
+#else
+    statistics->krrQ16 = AS_Q(group->gains.krr);
+#endif
+
+#if AS_ENABLE_SELF_TUNING
+    statistics->plantGainQ16 = (group->estimator.sumXX == 0) ? 0 :
+        (int32_t)((group->estimator.sumXY * AS_Q_ONE) / group->estimator.sumXX);
+#endif /* AS_ENABLE_SELF_TUNING */
+
+    return BOOL_TRUE;
+#else
+    (void)tcb;
+    (void)statistics;
+
+    return BOOL_FALSE;
+#endif /* AS_ENABLE_REGULATOR_STATISTICS */
+}
+
+/*
+ * Changes priority (CPU share) of a task.
+ *
+ *  Sum of priorities of group is updated with the difference so other tasks
+ *  are not visited to find the new sum. A new sum changes alphas of all group
+ *  tasks, so they are calculated by regulator in its visit of group tasks
+ *  when round is closed. PI state and bursts are not reset, tasks in other
+ *  groups are not affected.
+ */
+PUBLIC uint32_t Scheduler_SetTaskPriority(TCB* tcb, uint32_t priority)
+{
+#if AS_ENABLE_RUNTIME_PRIORITY
+    SchedulingGroup* group = scheduler.taskList[tcb - scheduler.tcbList].group;
+    uint32_t interruptState;
+
+    DEBUG_ASSERT(priority < OS_TASK_PRIORITY_MAX);
+
+    /* Regulator (ISR or context switching handler) must see a consistent sum */
+    interruptState = Kernel_DisableInterrupts();
+
+    group->sumOfPriorities = group->sumOfPriorities - tcb->userTaskInfo->priority + priority;
+    tcb->userTaskInfo->priority = priority;
+
+    /* Alphas are updated to new shares when round of group is closed */
+    group->prioritiesChanged = BOOL_TRUE;
+
+    Kernel_RestoreInterrupts(interruptState);
+
+    return BOOL_TRUE;
+#else
+    (void)tcb;
+    (void)priority;
+
+    return BOOL_FALSE;
+#endif /* AS_ENABLE_RUNTIME_PRIORITY */
+}
+
+/*
+ * Sets callback which is notified when a task is shed or restored.
+ */
+PUBLIC void Scheduler_SetOverloadCallback(OSOverloadCallback callback)
+{
+#if AS_ENABLE_OVERLOAD_MANAGEMENT
+    scheduler.overloadCallback = callback;
+#else
+    (void)callback;
+#endif /* AS_ENABLE_OVERLOAD_MANAGEMENT */
+}
+
 PUBLIC TCB* Scheduler_GetNextTCBs(void)
 {
     FindNextTask(BOOL_TRUE);
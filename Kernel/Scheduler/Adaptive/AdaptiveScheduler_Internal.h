@@ -43,6 +43,234 @@
 
 /***************************** MACRO DEFINITIONS ******************************/
 
+/*
+ * Regulator Arithmetic Selection
+ *
+ *  Cortex-M3 (e.g. LPC1768) does not have a FPU so float regulator is compiled
+ *  into soft-float library calls which run in Burst Timer ISR for each context
+ *  switch. Fixed point regulator runs whole I + PI controller on integers in
+ *  Q16.16 format.
+ *
+ *  1 : Fixed point (Q16.16) regulator
+ *  0 : Floating point regulator (Reference implementation)
+ */
+#ifndef AS_ENABLE_FIXED_POINT_REGULATOR
+#define AS_ENABLE_FIXED_POINT_REGULATOR		1
+#endif
+
+/*
+ * Deferred Regulator
+ *
+ *  Regulator visits all tasks at the end of each round. If it is run in Burst
+ *  Timer ISR, worst case duration of ISR grows with number of tasks. Deferred
+ *  regulator only closes the round in ISR and runs regulator in context
+ *  switching hook (lowest priority interrupt) before first task of new round
+ *  continues.
+ *
+ *  1 : Regulator is run in context switching hook
+ *  0 : Regulator is run in Burst Timer ISR
+ */
+#ifndef AS_ENABLE_DEFERRED_REGULATOR
+#define AS_ENABLE_DEFERRED_REGULATOR		1
+#endif
+
+/*
+ * Pipelined Scheduling
+ *
+ *  Next task and its burst time are prepared in context switching hook while
+ *  current task runs. Burst Timer ISR only commits prepared decision if it is
+ *  still valid (e.g. no state change after preparation) so switch path is
+ *  shorter and has less jitter.
+ *
+ *  1 : Next task is prepared in context switching hook
+ *  0 : Next task is selected in Burst Timer ISR
+ */
+#ifndef AS_ENABLE_PIPELINED_SCHEDULING
+#define AS_ENABLE_PIPELINED_SCHEDULING		1
+#endif
+
+/*
+ * Constant Bandwidth Server (CBS) Reservations
+ *
+ *  A task which is created with a budget and a server period (see
+ *  OS_RESERVED_USER_TASK) gets a reservation of budget in each server period.
+ *  Bursts of a reserved task are limited by its remaining budget and task is
+ *  throttled until its server deadline when budget is exhausted, so a bursty
+ *  task cannot take more CPU than its bandwidth (budget / period) regardless
+ *  of its round share.
+ *
+ *  Tasks without budget are not limited. Period and WCET of periodic tasks
+ *  are not used for reservations.
+ */
+#ifndef AS_ENABLE_RESERVATIONS
+#define AS_ENABLE_RESERVATIONS				1
+#endif
+
+/*
+ * Hierarchical Scheduling Groups
+ *
+ *  Tasks are partitioned into groups which are declared using
+ *  OS_SCHEDULING_GROUPS next to OS_STARTUP_APPLICATIONS. Groups are selected
+ *  by fixed priority and each group runs its own Adaptive round with its own
+ *  set point and regulator, so tasks of a high group never wait behind round
+ *  of a lower group.
+ *
+ *  1 : Tasks are scheduled in groups (OS_SCHEDULING_GROUPS is mandatory)
+ *  0 : All tasks are in a single round
+ */
+#ifndef AS_ENABLE_SCHEDULING_GROUPS
+#define AS_ENABLE_SCHEDULING_GROUPS			0
+#endif
+
+/*
+ * Dynamic Round Set Point
+ *
+ *  Round time set point is derived from maximum response latencies of ready
+ *  tasks (see OS_LATENCY_USER_TASK) at the end of each round. Set point is
+ *  the tightest latency which keeps context switching overhead under
+ *  AS_MAX_SWITCH_OVERHEAD_PERCENT. If there is no ready task with a latency
+ *  target or group has a fixed set point (see OS_SCHEDULING_GROUP), set
+ *  point is not changed.
+ */
+#ifndef AS_ENABLE_DYNAMIC_ROUND_SET_POINT
+#define AS_ENABLE_DYNAMIC_ROUND_SET_POINT	1
+#endif
+
+/* Cost of a context switch (including scheduler) in microseconds */
+#ifndef AS_CONTEXT_SWITCH_COST_IN_US
+#define AS_CONTEXT_SWITCH_COST_IN_US		(10)
+#endif
+
+/* Allowed context switching overhead in a round in percent */
+#ifndef AS_MAX_SWITCH_OVERHEAD_PERCENT
+#define AS_MAX_SWITCH_OVERHEAD_PERCENT		(2)
+#endif
+
+/*
+ * Runtime Priority Changes
+ *
+ *  Allows changing priorities (CPU shares) of tasks at runtime using
+ *  OS_TaskSetPriority(). Regulator of task group moves tasks to the new
+ *  shares starting from the round following the change.
+ */
+#ifndef AS_ENABLE_RUNTIME_PRIORITY
+#define AS_ENABLE_RUNTIME_PRIORITY			1
+#endif
+
+/*
+ * Wake-up Preemption
+ *
+ *  Tasks are switched at the end of bursts so a woken task waits until the
+ *  running burst ends (up to AS_BURST_MAX_IN_US).
+ *
+ *  If enabled, a woken latency sensitive task (a task with a latency target,
+ *  see OS_LATENCY_USER_TASK) preempts running task immediately and idle task
+ *  is preempted by any woken task. Preempted task continues with its
+ *  remaining burst in the same round.
+ */
+#ifndef AS_ENABLE_WAKE_UP_PREEMPTION
+#define AS_ENABLE_WAKE_UP_PREEMPTION		1
+#endif
+
+/*
+ * Time-Slice Donation
+ *
+ *  A task which yields before its burst ends loses the rest of its burst
+ *  and regulator sees a short process time so it grows burst of the task.
+ *
+ *  If enabled, OS_YieldTo() donates the rest of the burst to another task
+ *  or keeps it as credit for the next burst of yielding task (bounded by
+ *  AS_MAX_BURST_CREDIT_IN_US). Given up time is counted as processed time of
+ *  yielding task so voluntary yields are not seen as low demand.
+ */
+#ifndef AS_ENABLE_SLICE_DONATION
+#define AS_ENABLE_SLICE_DONATION			1
+#endif
+
+/* Maximum credit which a task can carry into its next burst */
+#ifndef AS_MAX_BURST_CREDIT_IN_US
+#define AS_MAX_BURST_CREDIT_IN_US			(4000)
+#endif
+
+/*
+ * Overload Management
+ *
+ *  Regulator can not keep round time if tasks demand more than CPU can
+ *  provide. If round time overruns its set point for
+ *  AS_OVERLOAD_WINDOW_ROUNDS consecutive rounds, group is overloaded and its
+ *  least critical best-effort task (see OS_BEST_EFFORT_TASKS) is shed. Shed
+ *  tasks are not run until round time stays under its set point for
+ *  AS_RECOVERY_WINDOW_ROUNDS consecutive rounds. Application is notified by
+ *  overload callback (see OS_SetOverloadCallback).
+ *
+ *  If enabled, OS_BEST_EFFORT_TASKS must be declared in UserStartupInfo.h.
+ */
+#ifndef AS_ENABLE_OVERLOAD_MANAGEMENT
+#define AS_ENABLE_OVERLOAD_MANAGEMENT		0
+#endif
+
+/* Number of consecutive overrun rounds to shed a task */
+#ifndef AS_OVERLOAD_WINDOW_ROUNDS
+#define AS_OVERLOAD_WINDOW_ROUNDS			(16)
+#endif
+
+/* Number of consecutive rounds with spare time to restore a shed task */
+#ifndef AS_RECOVERY_WINDOW_ROUNDS
+#define AS_RECOVERY_WINDOW_ROUNDS			(64)
+#endif
+
+/*
+ * Overrun margin of round time in percent of set point.
+ *  Regulator transients are not overloads unless all ready tasks are
+ *  saturated, in that case any overrun is counted.
+ */
+#ifndef AS_OVERLOAD_MARGIN_PERCENT
+#define AS_OVERLOAD_MARGIN_PERCENT			(20)
+#endif
+
+/* Spare time (percent of set point) which is required to restore a task */
+#ifndef AS_RECOVERY_MARGIN_PERCENT
+#define AS_RECOVERY_MARGIN_PERCENT			(20)
+#endif
+
+/*
+ * Self-Tuning Regulator
+ *
+ *  Outer loop gains (KRR, ZRR) are designed for tasks which use their bursts
+ *  so round time follows burst correction with KPI gain. If tasks yield early
+ *  or their demands change quickly, round time responds differently and
+ *  fixed gains lead to sluggish or oscillating rounds.
+ *
+ *  If enabled, each group estimates its plant gain (change of round time per
+ *  burst correction) from measured rounds and scales KRR to keep loop gain at
+ *  its nominal value. Tuned KRR is limited by AS_SELF_TUNING_KRR_MIN and
+ *  AS_SELF_TUNING_KRR_MAX.
+ */
+#ifndef AS_ENABLE_SELF_TUNING
+#define AS_ENABLE_SELF_TUNING				0
+#endif
+
+/*
+ * Regulator Statistics
+ *
+ *  Collects convergence statistics (settling times and errors) of round time
+ *  regulators to compare regulator configurations on real workloads.
+ *  Results can be read using OS_GetRegulatorStatistics().
+ */
+#ifndef AS_ENABLE_REGULATOR_STATISTICS
+#define AS_ENABLE_REGULATOR_STATISTICS		0
+#endif
+
+/*
+ * ISR Profiling
+ *
+ *  Measures worst case durations of Burst Timer ISR and regulator in CPU
+ *  cycles. Results are kept in scheduler data (profile) and can be watched
+ *  using a debugger.
+ */
+#ifndef AS_ENABLE_ISR_PROFILING
+#define AS_ENABLE_ISR_PROFILING				0
+#endif
 
 /*******************************************************************************
  * Coefficients for Controller
@@ -60,6 +288,32 @@
 #define AS_KRR						(0.9f)
 #define AS_ZRR						(0.88f)
 
+/*
+ * Limits of self-tuned KRR. KRR * ZRR is scaled with KRR so zero of PI
+ * controller is kept.
+ */
+#define AS_SELF_TUNING_KRR_MIN		(0.3f)
+#define AS_SELF_TUNING_KRR_MAX		(1.35f)
+
+/*
+ * Forgetting factor (1 - 2^-N) of plant gain estimation.
+ *  Old rounds are forgotten quickly to follow changing demands.
+ */
+#define AS_SELF_TUNING_FORGET_SHIFT	(3)
+
+/*
+ * Minimum burst correction to estimate plant gain. Smaller corrections are
+ * dominated by measurement noise.
+ */
+#define AS_SELF_TUNING_MIN_EXCITATION_IN_US	(100)
+
+/*
+ * Settling criteria for regulator statistics.
+ *  Round error must be in band (percent of set point) for given rounds.
+ */
+#define AS_SETTLING_BAND_PERCENT	(5)
+#define AS_SETTLING_ROUNDS			(3)
+
 /******************************************************************************/
 
 /* Burst time for idle thread */
@@ -95,6 +349,30 @@
  */
 #define AS_MULT_FACTOR				(1.0f / AS_KPI)
 
+/*******************************************************************************
+ * Fixed Point (Q16.16) Definitions
+ ******************************************************************************/
+
+/* Number of fractional bits */
+#define AS_Q_SHIFT					(16)
+
+/* 1.0 in Q16.16 format */
+#define AS_Q_ONE					(1L << AS_Q_SHIFT)
+
+/*
+ * Converts a (constant) float coefficient to Q16.16 format.
+ *  Only used with constants so conversion is done in compile time.
+ */
+#define AS_Q(x)						((int32_t)(((x) * AS_Q_ONE) + 0.5f))
+
+/* Controller coefficients in Q16.16 format */
+#define AS_KPI_Q					AS_Q(AS_KPI)
+#define AS_KRR_Q					AS_Q(AS_KRR)
+#define AS_KRR_ZRR_Q				AS_Q(AS_KRR * AS_ZRR)
+#define AS_ZRR_Q					AS_Q(AS_ZRR)
+#define AS_SELF_TUNING_KRR_MIN_Q	AS_Q(AS_SELF_TUNING_KRR_MIN)
+#define AS_SELF_TUNING_KRR_MAX_Q	AS_Q(AS_SELF_TUNING_KRR_MAX)
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*************************** FUNCTION DEFINITIONS *****************************/
@@ -0,0 +1,63 @@
+/*******************************************************************************
+ *
+ * @file OSConfig.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock Operating System Configs for Tests
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __OS_CONFIG_H
+#define __OS_CONFIG_H
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Selected Scheduler Type */
+#define OS_SCHEDULER						OS_SCHEDULER_ADAPTIVE
+
+/* Tasks are scheduled in groups (see UserStartupInfo.h) */
+#define AS_ENABLE_SCHEDULING_GROUPS			1
+
+/* Outer loop gains are tuned online and their convergence is measured */
+#define AS_ENABLE_SELF_TUNING				1
+#define AS_ENABLE_REGULATOR_STATISTICS		1
+
+/* Best-effort tasks are shed under overload (see UserStartupInfo.h) */
+#define AS_ENABLE_OVERLOAD_MANAGEMENT		1
+
+#define OS_TASK_CREATION                    OS_TASK_CREATION_STATIC
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif	/* __OS_CONFIG_H */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+ *
+ * @file UserStartupInfo.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock User Tasks for Adaptive Scheduler Tests
+ *
+ * Tasks have different priorities to test CPU share distribution.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __USER_STARTUP_INFO_H
+#define __USER_STARTUP_INFO_H
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Task start points are never called in unit tests so all tasks share a
+ * single start point.
+ */
+OS_USER_TASK_START_POINT(MockTaskFunc);
+
+/* Mock User Tasks with different priorities */
+OS_USER_TASK(MockTask1, MockTaskFunc, 64, 0);
+OS_USER_TASK(MockTask2, MockTaskFunc, 64, 3);
+OS_USER_TASK(MockTask3, MockTaskFunc, 64, 15);
+OS_USER_TASK(MockTask4, MockTaskFunc, 64, 40);
+
+/* Startup Applications */
+OS_STARTUP_APPLICATIONS
+(
+    OS_USER_TASK_PREFIX(MockTask1),
+    OS_USER_TASK_PREFIX(MockTask2),
+    OS_USER_TASK_PREFIX(MockTask3),
+    OS_USER_TASK_PREFIX(MockTask4)
+)
+
+/*
+ * Scheduling Groups
+ *  All tasks are in first group so tests run a single round. Second group is
+ *  empty and used by hierarchical scheduling tests to re-partition tasks.
+ */
+OS_SCHEDULING_GROUPS
+(
+    OS_SCHEDULING_GROUP(4, 0),
+    OS_SCHEDULING_GROUP(0, 0)
+)
+
+/* Last two tasks are best-effort tasks, last one is shed first */
+OS_BEST_EFFORT_TASKS
+(
+    OS_USER_TASK_PREFIX(MockTask4),
+    OS_USER_TASK_PREFIX(MockTask3)
+)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif	/* __USER_STARTUP_INFO_H */
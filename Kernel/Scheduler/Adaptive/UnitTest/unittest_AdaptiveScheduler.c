@@ -0,0 +1,1632 @@
+/*******************************************************************************
+ *
+ * @file unittest_AdaptiveScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Adaptive Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Time stamp counter is used to count cycles of switch path */
+#include <x86intrin.h>
+#endif
+
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "mock_Timer.c"
+#include "Mock/mock_CPUCore.c"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../AdaptiveScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Number of simulated rounds for regulator tests */
+#define TEST_NUM_OF_ROUNDS					(200)
+
+/*
+ * Allowed difference between burst times of fixed point regulator and float
+ * (reference) regulator.
+ *
+ *  Fixed point regulator truncates Q16.16 products while float regulator
+ *  truncates float products so each product may differ by 1 us. Closed loop
+ *  regulator does not accumulate these differences so bursts of both
+ *  regulators should stay in a few microseconds band.
+ */
+#define TEST_BURST_TOLERANCE_IN_US			(8)
+
+/* Number of regulator runs to compare execution time of regulators */
+#define TEST_NUM_OF_BENCHMARK_RUNS			(10000)
+
+/* Number of repeats of regulator runs. Minimum of repeats is taken. */
+#define TEST_NUM_OF_BENCHMARK_REPEATS		(32)
+
+/* Number of context switches to measure switch latency */
+#define TEST_NUM_OF_SWITCH_RUNS				(10000)
+
+/*
+ * Number of repeats of same switch sequence from same scheduler state.
+ * Minimum of repeats is taken for each switch so host noise (interrupts,
+ * preemption, cold caches) is filtered out and only cost of switch path is
+ * left.
+ */
+#define TEST_NUM_OF_SWITCH_REPEATS			(32)
+
+/* Scheduling group which includes all tasks (see Mock/UserStartupInfo.h) */
+#define TEST_GROUP							(&scheduler.groups[0])
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Cycle counts of switch path. Switches which close a round are counted
+ * separately because they are selected in ISR with or without prepared
+ * decisions.
+ */
+typedef struct
+{
+	/* Average and worst case of switches in a round */
+	uint64_t inRoundAvg;
+	uint64_t inRoundMax;
+	/* Average and worst case of switches which close a round */
+	uint64_t roundCloseAvg;
+	uint64_t roundCloseMax;
+} SwitchCycles;
+
+/*
+ * Reference (float) regulator task state.
+ *  Copy of original floating point implementation.
+ */
+typedef struct
+{
+	uint32_t tProcess;
+	uint32_t tProcessSetPoint;
+	uint32_t tBurstOld;
+	float alpha;
+} RefTaskState;
+
+/*
+ * Reference (float) regulator state.
+ */
+typedef struct
+{
+	RefTaskState tasks[TASK_COUNT];
+	uint32_t tRound;
+	uint32_t tRoundSetPoint;
+	int32_t burstCorrectionOld;
+	int32_t errRoundOld;
+	float krr;
+	float krrZrr;
+	/* Keeps statistics of reference regulator */
+	SchedulingGroup statisticsGroup;
+} RefRegulator;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* First two tasks are in high priority group and last two are in low group */
+static const OSSchedulingGroup testGroups[GROUP_COUNT] =
+{
+	OS_SCHEDULING_GROUP(2, 3000),
+	OS_SCHEDULING_GROUP(2, 0)
+};
+
+/* Float regulator to compare fixed point regulator */
+static RefRegulator refRegulator;
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/*
+ * Flag to defer context switching handler (PendSV) after kernel callback.
+ *  Lets tests check scheduler state between ISR and context switching handler.
+ */
+static uint32_t deferCSHandler;
+
+/* Minimum cycles of each switch in switch latency benchmark */
+static uint64_t switchCycles[TEST_NUM_OF_SWITCH_RUNS];
+
+/* Last overload notification */
+static void* lastOverloadTask;
+static OSOverloadEvent lastOverloadEvent;
+static uint32_t overloadEventCount;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Returns cycle counter of host CPU for benchmarks
+ */
+static uint64_t ReadHostCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	/* No portable cycle counter, clock ticks are just an approximation */
+	return (uint64_t)clock();
+#endif
+}
+
+/*
+ * Measures cycles of switch path (Scheduler_Yield) in Burst Timer ISR.
+ *
+ *  Context switching handler is run out of measurement like on target where
+ *  it runs after ISR. Switch sequence is deterministic so it is repeated
+ *  from same scheduler state and minimum cycles of repeats is taken as cost
+ *  of each switch.
+ *
+ * @param usePreparedDecision Flag to use prepared decisions or not
+ * @param cycles measured cycles
+ *
+ * @return none
+ */
+static void MeasureSwitchCycles(uint32_t usePreparedDecision, SwitchCycles* cycles)
+{
+	SchedulerData initialState;
+	uint32_t roundClosed[TEST_NUM_OF_SWITCH_RUNS];
+	uint64_t inRoundTotal = 0;
+	uint64_t roundCloseTotal = 0;
+	uint32_t roundCloseCount = 0;
+	uint64_t cyclesOfSwitch;
+	uint64_t start;
+	uint32_t i;
+	uint32_t j;
+
+	deferCSHandler = BOOL_TRUE;
+	mockTimer.elapsedTimeInUs = 1000;
+	memset(cycles, 0, sizeof(SwitchCycles));
+	initialState = scheduler;
+
+	for (i = 0; i < TEST_NUM_OF_SWITCH_RUNS; i++)
+	{
+		switchCycles[i] = UINT64_MAX;
+	}
+
+	for (j = 0; j < TEST_NUM_OF_SWITCH_REPEATS; j++)
+	{
+		scheduler = initialState;
+
+		for (i = 0; i < TEST_NUM_OF_SWITCH_RUNS; i++)
+		{
+			MockCPUCore_RunCSHandler();
+
+			if (usePreparedDecision == BOOL_FALSE)
+			{
+				InvalidatePreparedDecision();
+			}
+
+			start = ReadHostCycles();
+			Scheduler_Yield();
+			cyclesOfSwitch = ReadHostCycles() - start;
+
+			switchCycles[i] = MATH_MIN(switchCycles[i], cyclesOfSwitch);
+
+			/* Measured round time is reset only if switch closes the round */
+			roundClosed[i] = (TEST_GROUP->stateVariables.tRound == 0);
+		}
+	}
+
+	for (i = 0; i < TEST_NUM_OF_SWITCH_RUNS; i++)
+	{
+		if (roundClosed[i])
+		{
+			roundCloseTotal += switchCycles[i];
+			roundCloseCount++;
+			cycles->roundCloseMax = MATH_MAX(cycles->roundCloseMax, switchCycles[i]);
+		}
+		else
+		{
+			inRoundTotal += switchCycles[i];
+			cycles->inRoundMax = MATH_MAX(cycles->inRoundMax, switchCycles[i]);
+		}
+	}
+
+	cycles->inRoundAvg = inRoundTotal / (TEST_NUM_OF_SWITCH_RUNS - roundCloseCount);
+	cycles->roundCloseAvg = roundCloseTotal / roundCloseCount;
+}
+
+/*
+ * Returns measurements of a task in last closed round of its group.
+ */
+static RoundMeasurements* ClosedMeasurements(uint32_t taskIndex)
+{
+	TaskInfo* task = &scheduler.taskList[taskIndex];
+
+	return &task->stateVariables.measurements[task->group->measuredSet ^ 1];
+}
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+
+	/* Kernel requests a context switch so context switching handler runs */
+	if (deferCSHandler == BOOL_FALSE)
+	{
+		MockCPUCore_RunCSHandler();
+	}
+}
+
+/*
+ * Mock overload callback of application.
+ */
+static void MockOverloadCallback(void* userTask, OSOverloadEvent event)
+{
+	lastOverloadTask = userTask;
+	lastOverloadEvent = event;
+	overloadEventCount++;
+
+	/* Application is notified out of critical section of shedding */
+	TEST_ASSERT_EQUAL_UINT32(0, mockCPUCore.criticalSectionLevel);
+}
+
+/*
+ * Runs regulator of test group for closed rounds with given round time.
+ */
+static void RunRounds(uint32_t roundCount, uint32_t roundTime)
+{
+	for (; roundCount > 0; roundCount--)
+	{
+		TEST_GROUP->regulatorInputs.tRound = roundTime;
+		RunRegulator(TEST_GROUP);
+	}
+}
+
+/*
+ * Demand (required processing time in a round) of a task for simulations.
+ *  Demand changes in time to excite regulator.
+ */
+static uint32_t TaskDemand(uint32_t taskIndex, uint32_t round)
+{
+	uint32_t demand = 3000 + taskIndex * 1500;
+
+	/* Step changes on load */
+	if ((round / 50) % 2)
+	{
+		demand = (taskIndex % 2) ? demand / 4 : demand * 3;
+	}
+
+	return demand;
+}
+
+/*
+ * Initializes reference regulator using same alphas with scheduler.
+ */
+static void RefRegulator_Init(void)
+{
+	uint32_t sumOfPriorities = 0;
+	uint32_t i;
+
+	memset(&refRegulator, 0, sizeof(refRegulator));
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		sumOfPriorities += testTCBs[i].userTaskInfo->priority + 1;
+		refRegulator.tasks[i].tBurstOld = AS_BURST_NOMINAL_IN_US * AS_MULT_FACTOR;
+	}
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		refRegulator.tasks[i].alpha = ((float)(testTCBs[i].userTaskInfo->priority + 1)) / sumOfPriorities;
+	}
+
+	refRegulator.tRoundSetPoint = TASK_COUNT * AS_BURST_NOMINAL_IN_US;
+	refRegulator.statisticsGroup.stateVariables.tRoundSetPoint = refRegulator.tRoundSetPoint;
+
+	/* Fixed gains */
+	refRegulator.krr = AS_KRR;
+	refRegulator.krrZrr = AS_KRR * AS_ZRR;
+}
+
+/*
+ * Uses actual gains of scheduler regulator in reference regulator.
+ */
+static void RefRegulator_FollowGains(void)
+{
+#if AS_ENABLE_FIXED_POINT_REGULATOR
+	refRegulator.krr = (float)TEST_GROUP->gains.krr / AS_Q_ONE;
+	refRegulator.krrZrr = (float)TEST_GROUP->gains.krrZrr / AS_Q_ONE;
+#else
+	refRegulator.krr = TEST_GROUP->gains.krr;
+	refRegulator.krrZrr = TEST_GROUP->gains.krrZrr;
+#endif
+}
+
+/*
+ * Floating point (reference) implementation of I + PI controller.
+ */
+static void RefRegulator_Run(void)
+{
+	RefTaskState* taskState;
+	float nextRoundTime;
+	int32_t errorTProcess;
+	int32_t burst;
+	int32_t errRound;
+	int32_t burstCorrection;
+	uint32_t i;
+
+	errRound = refRegulator.tRoundSetPoint - refRegulator.tRound;
+
+	UpdateStatistics(&refRegulator.statisticsGroup, errRound);
+
+	burstCorrection = refRegulator.burstCorrectionOld +
+					  (int32_t)((refRegulator.krr * errRound) - (refRegulator.krrZrr * refRegulator.errRoundOld));
+
+	refRegulator.burstCorrectionOld = burstCorrection;
+	refRegulator.burstCorrectionOld =
+		MATH_MIN((int32_t)MATH_MAX(refRegulator.burstCorrectionOld, -(int32_t)refRegulator.tRound), TEST_GROUP->maxRoundTime);
+
+	nextRoundTime = (float)(refRegulator.tRound + refRegulator.burstCorrectionOld);
+
+	refRegulator.errRoundOld = errRound;
+	refRegulator.tRound = 0;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		taskState = &refRegulator.tasks[i];
+
+		taskState->tProcessSetPoint = (uint32_t)(taskState->alpha * nextRoundTime);
+		errorTProcess = taskState->tProcessSetPoint - taskState->tProcess;
+		burst = taskState->tBurstOld + errorTProcess;
+		taskState->tBurstOld = AS_BURST_BOUNDARY_FIX(burst);
+	}
+}
+
+/*
+ * Fixed point implementation of I + PI controller.
+ *
+ *  Same steps with RefRegulator_Run() using arithmetic of scheduler
+ *  regulator so execution times of both are comparable. Features which are
+ *  not in reference (e.g. self-tuning, overload management) are left out.
+ */
+static void FixedRegulator_Run(void)
+{
+	SchedulerStateVariables* state = &TEST_GROUP->stateVariables;
+	uint32_t tRound = TEST_GROUP->regulatorInputs.tRound;
+	TaskStateVariables* taskState;
+	int32_t nextRoundTime;
+	int32_t errorTProcess;
+	int32_t burst;
+	int32_t errRound;
+	uint32_t i;
+
+	errRound = state->tRoundSetPoint - tRound;
+
+	UpdateStatistics(TEST_GROUP, errRound);
+
+	state->burstCorrectionOld += CalculateBurstCorrectionDelta(&TEST_GROUP->gains, errRound, state->errRoundOld);
+	state->burstCorrectionOld =
+		MATH_MIN((int32_t)MATH_MAX(state->burstCorrectionOld, -(int32_t)tRound), TEST_GROUP->maxRoundTime);
+
+	nextRoundTime = (int32_t)tRound + state->burstCorrectionOld;
+
+	state->errRoundOld = errRound;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		taskState = &scheduler.taskList[i].stateVariables;
+
+		taskState->tProcessSetPoint = CalculateProcessSetPoint(taskState->alpha, nextRoundTime);
+		errorTProcess = (int32_t)taskState->tProcessSetPoint - ProcessedTime(&taskState->measurements[0]);
+		burst = taskState->tBurstOld + errorTProcess;
+		taskState->tBurstOld = AS_BURST_BOUNDARY_FIX(burst);
+	}
+}
+
+/*
+ * Measures cycles of a regulator for a number of rounds.
+ *
+ * @param fixedPoint BOOL_TRUE to measure fixed point regulator, BOOL_FALSE
+ *        to measure reference (float) regulator
+ *
+ * @return cycles of all runs
+ */
+static uint64_t MeasureRegulatorCycles(uint32_t fixedPoint)
+{
+	uint64_t start;
+	uint32_t tRound;
+	uint32_t i;
+
+	start = ReadHostCycles();
+	for (i = 0; i < TEST_NUM_OF_BENCHMARK_RUNS; i++)
+	{
+		tRound = i % (AS_BURST_MAX_IN_US * TASK_COUNT);
+
+		if (fixedPoint == BOOL_TRUE)
+		{
+			TEST_GROUP->regulatorInputs.tRound = tRound;
+			FixedRegulator_Run();
+		}
+		else
+		{
+			refRegulator.tRound = tRound;
+			RefRegulator_Run();
+		}
+	}
+
+	return ReadHostCycles() - start;
+}
+
+/*
+ * Simulates a round for reference regulator.
+ *  Each task runs until its burst ends or its demand is completed.
+ */
+static void RefRegulator_SimulateRound(uint32_t round)
+{
+	uint32_t burstTime;
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		burstTime = (uint32_t)(refRegulator.tasks[i].tBurstOld / AS_MULT_FACTOR);
+		refRegulator.tasks[i].tProcess = MATH_MIN(burstTime, TaskDemand(i, round));
+		refRegulator.tRound += refRegulator.tasks[i].tProcess;
+	}
+
+	RefRegulator_Run();
+}
+
+/*
+ * Simulates a round for scheduler (fixed point) regulator.
+ */
+static void Scheduler_SimulateRound(uint32_t round)
+{
+	TaskStateVariables* taskState;
+	uint32_t burstTime;
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		taskState = &scheduler.taskList[i].stateVariables;
+
+		burstTime = BurstToTime(taskState->tBurstOld);
+		ActualMeasurements(&scheduler.taskList[i])->tProcess = MATH_MIN(burstTime, TaskDemand(i, round));
+		TEST_GROUP->stateVariables.tRound += ActualMeasurements(&scheduler.taskList[i])->tProcess;
+
+		/* Task is run in this round */
+		scheduler.roundPendingTasks &= ~TASK_BIT(&scheduler.taskList[i]);
+	}
+
+	/* Close round in ISR and run regulator in context switching handler */
+	CloseRound(TEST_GROUP);
+	MockCPUCore_RunCSHandler();
+}
+
+/*
+ * Reserves bandwidth for a task (budget in each period).
+ */
+static void ReserveBandwidth(uint32_t taskIndex, uint32_t budgetInUs, uint32_t periodInUs)
+{
+	TaskInfo* task = &scheduler.taskList[taskIndex];
+
+	task->reservation.budgetInUs = budgetInUs;
+	task->reservation.periodInUs = periodInUs;
+	ReplenishBudget(task, scheduler.now + periodInUs);
+}
+
+/*
+ * Re-partitions tasks into scheduling groups.
+ */
+static void PartitionTasks(const OSSchedulingGroup* definitions)
+{
+	memset(scheduler.groups, 0, sizeof(scheduler.groups));
+
+	InitializeGroups(definitions);
+	InitializeTasks(testTCBs);
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	MockTimer_Reset();
+	MockCPUCore_Reset();
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	deferCSHandler = BOOL_FALSE;
+	lastOverloadTask = NULL;
+	overloadEventCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+
+		/* Mock tasks are static so declarations of previous test are cleared */
+		testTCBs[i].userTaskInfo->maxLatencyInUs = 0;
+		testTCBs[i].userTaskInfo->periodInUs = 0;
+		testTCBs[i].userTaskInfo->wcetInUs = 0;
+		testTCBs[i].userTaskInfo->budgetInUs = 0;
+		testTCBs[i].userTaskInfo->serverPeriodInUs = 0;
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that alpha values of tasks are proportional to their priorities and
+ * their sum is (almost) one.
+ */
+void test_Alpha(void)
+{
+	int32_t sumOfAlphas = 0;
+	uint32_t i;
+
+	RefRegulator_Init();
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		TEST_ASSERT_INT_WITHIN(1,
+							   (int32_t)(AS_Q_ONE * refRegulator.tasks[i].alpha),
+							   scheduler.taskList[i].stateVariables.alpha);
+
+		sumOfAlphas += scheduler.taskList[i].stateVariables.alpha;
+	}
+
+	/* Each alpha is truncated so sum may lose one LSB per task */
+	TEST_ASSERT_INT_WITHIN(TASK_COUNT, AS_Q_ONE, sumOfAlphas);
+}
+
+/*
+ * Tests burst value to burst time conversion which is done for each context
+ * switch.
+ */
+void test_BurstToTime(void)
+{
+	uint32_t burst;
+
+	for (burst = AS_BURST_MIN_IN_US * AS_MULT_FACTOR;
+		 burst <= AS_BURST_MAX_IN_US * AS_MULT_FACTOR;
+		 burst++)
+	{
+		TEST_ASSERT_EQUAL_UINT32((uint32_t)(burst / AS_MULT_FACTOR), BurstToTime(burst));
+	}
+}
+
+/*
+ * Tests that fixed point regulator tracks float (reference) regulator.
+ *
+ *  Both regulators are run in closed loop with same task demands and burst
+ *  times of tasks are compared for each round.
+ */
+void test_RegulatorTracksFloatReference(void)
+{
+	uint32_t round;
+	uint32_t i;
+
+	RefRegulator_Init();
+
+	for (round = 0; round < TEST_NUM_OF_ROUNDS; round++)
+	{
+		Scheduler_SimulateRound(round);
+
+		/* Only arithmetic is compared so same (tuned) gains are used */
+		RefRegulator_FollowGains();
+		RefRegulator_SimulateRound(round);
+
+		for (i = 0; i < TASK_COUNT; i++)
+		{
+			TEST_ASSERT_INT_WITHIN(TEST_BURST_TOLERANCE_IN_US,
+								   (uint32_t)(refRegulator.tasks[i].tBurstOld / AS_MULT_FACTOR),
+								   BurstToTime(scheduler.taskList[i].stateVariables.tBurstOld));
+		}
+
+		/* Round error and burst correction must also be close */
+		TEST_ASSERT_INT_WITHIN(TEST_BURST_TOLERANCE_IN_US * TASK_COUNT,
+							   refRegulator.burstCorrectionOld,
+							   TEST_GROUP->stateVariables.burstCorrectionOld);
+	}
+}
+
+/*
+ * Tests that self-tuned regulator settles faster than fixed gain regulator.
+ *
+ *  Both regulators are run in closed loop with same (step changing) demands
+ *  and their convergence statistics are compared.
+ */
+void test_SelfTuningSettlesFaster(void)
+{
+	OSRegulatorStatistics tuned;
+	OSRegulatorStatistics* fixed = &refRegulator.statisticsGroup.statistics.results;
+	uint32_t round;
+
+	RefRegulator_Init();
+
+	for (round = 0; round < TEST_NUM_OF_ROUNDS; round++)
+	{
+		Scheduler_SimulateRound(round);
+		RefRegulator_SimulateRound(round);
+	}
+
+	TEST_ASSERT_TRUE(Scheduler_GetRegulatorStatistics(&testTCBs[0], &tuned));
+
+	TEST_ASSERT_EQUAL_UINT32(TEST_NUM_OF_ROUNDS, tuned.rounds);
+	TEST_ASSERT_TRUE(tuned.disturbances > 0);
+
+	/*
+	 * Simulation is deterministic. Tuned regulator settles in about 2/3 of
+	 * rounds of fixed gain regulator (46 vs 70 rounds) with about 20% less
+	 * error, so bounds have some margin.
+	 */
+	TEST_ASSERT_TRUE(tuned.maxSettlingRounds <= (fixed->maxSettlingRounds * 3) / 4);
+	TEST_ASSERT_TRUE(tuned.sumOfAbsErrorsInUs <= (fixed->sumOfAbsErrorsInUs * 9) / 10);
+
+	/* Tuned gain stays in its limits */
+	TEST_ASSERT_TRUE(tuned.krrQ16 >= AS_SELF_TUNING_KRR_MIN_Q);
+	TEST_ASSERT_TRUE(tuned.krrQ16 <= AS_SELF_TUNING_KRR_MAX_Q);
+}
+
+/*
+ * Tests that regulator output stays in burst limits (saturation).
+ */
+void test_RegulatorSaturation(void)
+{
+	uint32_t round;
+	uint32_t i;
+
+	for (round = 0; round < TEST_NUM_OF_ROUNDS; round++)
+	{
+		/* Tasks never use their bursts so regulator tries to increase them */
+		TEST_GROUP->regulatorInputs.tRound = 0;
+		RunRegulator(TEST_GROUP);
+
+		for (i = 0; i < TASK_COUNT; i++)
+		{
+			TEST_ASSERT_TRUE(BurstToTime(scheduler.taskList[i].stateVariables.tBurstOld) >= AS_BURST_MIN_IN_US);
+			TEST_ASSERT_TRUE(BurstToTime(scheduler.taskList[i].stateVariables.tBurstOld) <= AS_BURST_MAX_IN_US);
+		}
+	}
+}
+
+/*
+ * Tests that scheduler visits tasks in order and arms burst timer with
+ * burst time of next task.
+ */
+void test_YieldArmsBurstTimer(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		mockTimer.elapsedTimeInUs = 1000;
+
+		Scheduler_Yield();
+
+		TEST_ASSERT_EQUAL_PTR(&testTCBs[i], lastSwitchedTCB);
+		TEST_ASSERT_EQUAL_UINT32(BurstToTime(scheduler.taskList[i].stateVariables.tBurstOld),
+								 mockTimer.timeoutInUs);
+	}
+}
+
+/*
+ * Compares execution times of fixed point and float regulators.
+ *
+ *  [IMP] Host CPU has a FPU so float products are single instructions while
+ *  fixed point regulator needs 64-bit products and rounding. On host (without
+ *  optimization) fixed point regulator takes about 1.5 times of float
+ *  regulator. On a FPU-less target (e.g. Cortex-M3) float regulator is
+ *  compiled into soft-float library calls and fixed point regulator is the
+ *  faster one. So test only checks that fixed point arithmetic does not cost
+ *  more than two times of hardware float on host.
+ */
+void test_RegulatorExecutionTime(void)
+{
+	uint64_t fixedPointCycles = UINT64_MAX;
+	uint64_t floatCycles = UINT64_MAX;
+	uint32_t i;
+
+	RefRegulator_Init();
+
+	/* Interleaved so both regulators see same host load, minimum is taken */
+	for (i = 0; i < TEST_NUM_OF_BENCHMARK_REPEATS; i++)
+	{
+		fixedPointCycles = MATH_MIN(fixedPointCycles, MeasureRegulatorCycles(BOOL_TRUE));
+		floatCycles = MATH_MIN(floatCycles, MeasureRegulatorCycles(BOOL_FALSE));
+	}
+
+	TEST_ASSERT_TRUE(fixedPointCycles < (2 * floatCycles));
+}
+
+/*
+ * Tests that blocked (not ready) tasks are skipped in a round.
+ */
+void test_BlockedTasksAreSkipped(void)
+{
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Waiting);
+
+	TEST_ASSERT_EQUAL_UINT32(TASK_COUNT - 1, scheduler.readyTaskCount);
+
+	/* First round */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[3], lastSwitchedTCB);
+
+	mockTimer.elapsedTimeInUs = 1000;
+
+	/* Round is completed and blocked task is not run in this round */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_TRUE(TEST_GROUP->regulatorInputs.notRunTasks & TASK_BIT(&scheduler.taskList[1]));
+
+	/* Task becomes ready again and it is run in current round */
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Ready);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+}
+
+/*
+ * Tests that idle task is run with its burst if there is no ready task.
+ */
+void test_IdleTaskRunsWhenNoReadyTask(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		Scheduler_SetTaskState(&testTCBs[i], OSTaskState_Waiting);
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.readyTaskCount);
+
+	Scheduler_Yield();
+
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(AS_IDLE_THREAD_BURST_IN_US, mockTimer.timeoutInUs);
+
+	/* Idle time must not be added to round time */
+	mockTimer.elapsedTimeInUs = AS_IDLE_THREAD_BURST_IN_US;
+	Scheduler_SetTaskState(&testTCBs[2], OSTaskState_Ready);
+	Scheduler_Yield();
+
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(0, TEST_GROUP->stateVariables.tRound);
+}
+
+/*
+ * Tests that saturation flag follows state transitions without visiting tasks.
+ */
+void test_SaturationFlag(void)
+{
+	TaskInfo* task;
+
+	for (task = &scheduler.taskList[0]; task != LAST_TASK; task++)
+	{
+		task->stateVariables.tBurstOld = AS_BURST_MAX_IN_US * AS_MULT_FACTOR;
+		UpdateTaskSaturation(task);
+	}
+	UpdateSaturationFlag(TEST_GROUP);
+
+	TEST_ASSERT_TRUE(TEST_GROUP->allReadyTasksSaturated);
+
+	/* A ready task is not saturated anymore */
+	scheduler.taskList[0].stateVariables.tBurstOld = AS_BURST_NOMINAL_IN_US * AS_MULT_FACTOR;
+	UpdateTaskSaturation(&scheduler.taskList[0]);
+	UpdateSaturationFlag(TEST_GROUP);
+
+	TEST_ASSERT_FALSE(TEST_GROUP->allReadyTasksSaturated);
+
+	/* Non saturated task is blocked so all ready tasks are saturated again */
+	Scheduler_SetTaskState(&testTCBs[0], OSTaskState_Waiting);
+
+	TEST_ASSERT_TRUE(TEST_GROUP->allReadyTasksSaturated);
+}
+
+/*
+ * Tests that regulator is not run in Burst Timer ISR but in context switching
+ * handler and first task of round is restarted with its new burst.
+ */
+void test_RegulatorIsDeferredToCSHandler(void)
+{
+	uint32_t burstsBefore[TASK_COUNT];
+	uint32_t i;
+
+	TEST_ASSERT_NOT_NULL(mockCPUCore.csHook);
+
+	/* Run all tasks with a short burst so regulator has to change bursts */
+	mockTimer.elapsedTimeInUs = 500;
+	for (i = 0; i < TASK_COUNT + 1; i++)
+	{
+		Scheduler_Yield();
+	}
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		burstsBefore[i] = scheduler.taskList[i].stateVariables.tBurstOld;
+	}
+
+	/* Round is closed in ISR. Context switching handler is not run yet. */
+	deferCSHandler = BOOL_TRUE;
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		Scheduler_Yield();
+	}
+
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_TRUE(TEST_GROUP->regulatorPending);
+	TEST_ASSERT_EQUAL_UINT32(0, TEST_GROUP->stateVariables.tRound);
+	TEST_ASSERT_EQUAL_UINT32(500 * TASK_COUNT, TEST_GROUP->regulatorInputs.tRound);
+
+	/* ISR armed timer with previous burst of first task */
+	TEST_ASSERT_EQUAL_UINT32(BurstToTime(burstsBefore[0]), mockTimer.timeoutInUs);
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32(burstsBefore[i], scheduler.taskList[i].stateVariables.tBurstOld);
+	}
+
+	/* Context switching handler runs regulator and restarts burst */
+	MockCPUCore_RunCSHandler();
+
+	TEST_ASSERT_FALSE(TEST_GROUP->regulatorPending);
+	TEST_ASSERT_TRUE(burstsBefore[0] != scheduler.taskList[0].stateVariables.tBurstOld);
+	TEST_ASSERT_EQUAL_UINT32(BurstToTime(scheduler.taskList[0].stateVariables.tBurstOld),
+							 mockTimer.timeoutInUs);
+}
+
+/*
+ * Tests that a round is discarded if regulator of previous round is not
+ * completed yet.
+ */
+void test_RoundIsDiscardedWhileRegulatorIsPending(void)
+{
+	uint32_t i;
+
+	deferCSHandler = BOOL_TRUE;
+
+	/* First round is closed with 1000 us per task */
+	mockTimer.elapsedTimeInUs = 1000;
+	for (i = 0; i < TASK_COUNT + 1; i++)
+	{
+		Scheduler_Yield();
+	}
+	TEST_ASSERT_TRUE(TEST_GROUP->regulatorPending);
+
+	/* Second round is closed before regulator is run */
+	mockTimer.elapsedTimeInUs = 100;
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		Scheduler_Yield();
+	}
+
+	/* Inputs of pending regulator are not changed */
+	TEST_ASSERT_EQUAL_UINT32(1000 * TASK_COUNT, TEST_GROUP->regulatorInputs.tRound);
+	TEST_ASSERT_EQUAL_UINT32(0, TEST_GROUP->stateVariables.tRound);
+	TEST_ASSERT_EQUAL_UINT32(TASK_SET_ALL & ~TASK_BIT(&scheduler.taskList[0]),
+							 scheduler.roundPendingTasks);
+}
+
+/*
+ * Tests that next task is prepared in context switching handler and committed
+ * in next switch.
+ */
+void test_PreparedDecisionIsCommitted(void)
+{
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+
+	/* Next task is prepared while first task runs */
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[1], scheduler.preparedDecision.task);
+	TEST_ASSERT_EQUAL_UINT32(BurstToTime(scheduler.taskList[1].stateVariables.tBurstOld),
+							 scheduler.preparedDecision.burstTime);
+
+	/* Commit prepared decision */
+	deferCSHandler = BOOL_TRUE;
+	Scheduler_Yield();
+
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(BurstToTime(scheduler.taskList[1].stateVariables.tBurstOld),
+							 mockTimer.timeoutInUs);
+	TEST_ASSERT_NULL(scheduler.preparedDecision.task);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.roundPendingTasks & TASK_BIT(&scheduler.taskList[1]));
+}
+
+/*
+ * Tests that a prepared decision is discarded on state change.
+ */
+void test_PreparedDecisionIsInvalidatedOnStateChange(void)
+{
+	uint32_t version;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[1], scheduler.preparedDecision.task);
+
+	/* Prepared task is blocked */
+	version = scheduler.stateVersion;
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Waiting);
+
+	TEST_ASSERT_NULL(scheduler.preparedDecision.task);
+	TEST_ASSERT_TRUE(version != scheduler.stateVersion);
+
+	/* Next task is selected in switch path */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+}
+
+/*
+ * Tests that bursts of a reserved task are limited by its budget and task is
+ * throttled until replenishment when budget is exhausted.
+ */
+void test_ReservedTaskIsThrottled(void)
+{
+	uint32_t i;
+
+	ReserveBandwidth(3, 1000, 10000);
+
+	mockTimer.elapsedTimeInUs = 500;
+	for (i = 0; i < 4; i++)
+	{
+		Scheduler_Yield();
+	}
+
+	/* Burst of reserved task is limited by its budget */
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[3], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(1000, mockTimer.timeoutInUs);
+
+	/* Budget is exhausted */
+	mockTimer.elapsedTimeInUs = 1000;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_HEX32(TASK_BIT(&scheduler.taskList[3]), scheduler.throttledTasks);
+
+	/* Throttled task is skipped in rounds until its server deadline */
+	mockTimer.elapsedTimeInUs = 500;
+	Scheduler_Yield();
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+
+	/* Scheduler time reaches to server deadline (10ms) */
+	while (scheduler.now < 10000)
+	{
+		Scheduler_Yield();
+	}
+
+	TEST_ASSERT_EQUAL_HEX32(0, scheduler.throttledTasks);
+	TEST_ASSERT_EQUAL_UINT32(1000, scheduler.taskList[3].reservation.remainingInUs);
+	TEST_ASSERT_EQUAL_UINT32(20000, scheduler.taskList[3].reservation.deadline);
+}
+
+/*
+ * Tests that idle task is woken up at replenishment of a throttled task.
+ */
+void test_IdleBurstIsLimitedByReplenishment(void)
+{
+	uint32_t i;
+
+	ReserveBandwidth(3, 1000, 10000);
+
+	for (i = 0; i < 3; i++)
+	{
+		Scheduler_SetTaskState(&testTCBs[i], OSTaskState_Waiting);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[3], lastSwitchedTCB);
+
+	/* Budget is exhausted, idle task is run until server deadline */
+	mockTimer.elapsedTimeInUs = 1000;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(9000, mockTimer.timeoutInUs);
+
+	mockTimer.elapsedTimeInUs = 9000;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[3], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(1000, mockTimer.timeoutInUs);
+}
+
+/*
+ * Tests that reservations are taken from declared budgets and server periods
+ * of tasks (aperiodic tasks included) and not from WCETs of periodic tasks.
+ */
+void test_ReservationIsDeclaredPerTask(void)
+{
+	/* Aperiodic task with a reservation */
+	testTCBs[1].userTaskInfo->budgetInUs = 2000;
+	testTCBs[1].userTaskInfo->serverPeriodInUs = 8000;
+
+	/* Periodic task without a reservation */
+	testTCBs[2].userTaskInfo->periodInUs = 10000;
+	testTCBs[2].userTaskInfo->wcetInUs = 1000;
+
+	memset(&scheduler, 0, sizeof(scheduler));
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+
+	TEST_ASSERT_EQUAL_UINT32(2000, scheduler.taskList[1].reservation.budgetInUs);
+	TEST_ASSERT_EQUAL_UINT32(8000, scheduler.taskList[1].reservation.periodInUs);
+	TEST_ASSERT_EQUAL_UINT32(2000, scheduler.taskList[1].reservation.remainingInUs);
+	TEST_ASSERT_EQUAL_UINT32(8000, scheduler.taskList[1].reservation.deadline);
+
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.taskList[2].reservation.budgetInUs);
+}
+
+/*
+ * Tests CBS wake-up rule.
+ */
+void test_ReservationWakeUpRule(void)
+{
+	Reservation* reservation = &scheduler.taskList[3].reservation;
+
+	ReserveBandwidth(3, 1000, 10000);
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Waiting);
+
+	/* Remaining budget can be consumed until deadline, keep server period */
+	reservation->remainingInUs = 200;
+	scheduler.now = 5000;
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_UINT32(200, reservation->remainingInUs);
+	TEST_ASSERT_EQUAL_UINT32(10000, reservation->deadline);
+
+	/* Remaining budget exceeds bandwidth until deadline, start new period */
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Waiting);
+	reservation->remainingInUs = 800;
+	scheduler.now = 6000;
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_UINT32(1000, reservation->remainingInUs);
+	TEST_ASSERT_EQUAL_UINT32(16000, reservation->deadline);
+}
+
+/*
+ * Tests that tasks are partitioned into groups and alpha is calculated in
+ * group.
+ */
+void test_SchedulingGroups(void)
+{
+	SchedulingGroup* highGroup = &scheduler.groups[0];
+	SchedulingGroup* lowGroup = &scheduler.groups[1];
+
+	PartitionTasks(testGroups);
+
+	TEST_ASSERT_EQUAL_HEX32(0x3, highGroup->tasks);
+	TEST_ASSERT_EQUAL_HEX32(0xC, lowGroup->tasks);
+	TEST_ASSERT_EQUAL_PTR(lowGroup, scheduler.taskList[2].group);
+
+	TEST_ASSERT_EQUAL_UINT32(3000, highGroup->stateVariables.tRoundSetPoint);
+	TEST_ASSERT_EQUAL_UINT32(2 * AS_BURST_NOMINAL_IN_US, lowGroup->stateVariables.tRoundSetPoint);
+
+	/* Priorities 0 and 3 share round of high group */
+	TEST_ASSERT_INT32_WITHIN(1, AS_Q_ONE / 5, scheduler.taskList[0].stateVariables.alpha);
+	TEST_ASSERT_INT32_WITHIN(1, (4 * AS_Q_ONE) / 5, scheduler.taskList[1].stateVariables.alpha);
+}
+
+/*
+ * Tests that tasks of low group are run only if there is no ready task in
+ * high group.
+ */
+void test_HighGroupIsRunBeforeLowGroup(void)
+{
+	SchedulingGroup* highGroup = &scheduler.groups[0];
+	SchedulingGroup* lowGroup = &scheduler.groups[1];
+
+	PartitionTasks(testGroups);
+	mockTimer.elapsedTimeInUs = 500;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+
+	/* Round of high group is closed without running low group */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(1000, highGroup->regulatorInputs.tRound);
+
+	/* High group is blocked */
+	Scheduler_SetTaskState(&testTCBs[0], OSTaskState_Waiting);
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Waiting);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+
+	/* Woken high group task does not wait for round of low group */
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Ready);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+
+	/* Only bursts of low group tasks are added to round of low group */
+	TEST_ASSERT_EQUAL_UINT32(500, lowGroup->stateVariables.tRound);
+	TEST_ASSERT_EQUAL_UINT32(TASK_BIT(&scheduler.taskList[3]),
+							 scheduler.roundPendingTasks & lowGroup->tasks);
+}
+
+/*
+ * Tests that deferred regulator uses measurements of closed round even if
+ * next round is measured before regulator is run.
+ */
+void test_DeferredRegulatorUsesClosedRound(void)
+{
+	SchedulerData closedRoundState;
+	uint32_t expectedBursts[TASK_COUNT];
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		ActualMeasurements(&scheduler.taskList[i])->tProcess = 1000;
+		TEST_GROUP->stateVariables.tRound += 1000;
+		scheduler.roundPendingTasks &= ~TASK_BIT(&scheduler.taskList[i]);
+	}
+
+	/* Round is closed in ISR but context switching handler is not run yet */
+	CloseRound(TEST_GROUP);
+	closedRoundState = scheduler;
+
+	/* Next round is measured into other set */
+	TEST_ASSERT_EQUAL_UINT32(1000, ClosedMeasurements(0)->tProcess);
+	TEST_ASSERT_TRUE(ActualMeasurements(&scheduler.taskList[0]) != ClosedMeasurements(0));
+
+	MockCPUCore_RunCSHandler();
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		expectedBursts[i] = scheduler.taskList[i].stateVariables.tBurstOld;
+	}
+
+	/* Same round again but first task ends a burst of next round before regulator */
+	scheduler = closedRoundState;
+	ActualMeasurements(&scheduler.taskList[0])->tProcess = 4000;
+
+	MockCPUCore_RunCSHandler();
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32(expectedBursts[i], scheduler.taskList[i].stateVariables.tBurstOld);
+	}
+
+	/* Regulator does not clear measurements of next round */
+	TEST_ASSERT_EQUAL_UINT32(4000, ActualMeasurements(&scheduler.taskList[0])->tProcess);
+	TEST_ASSERT_EQUAL_UINT32(0, mockCPUCore.criticalSectionLevel);
+}
+
+/*
+ * Tests that regulator of a group only updates bursts of its tasks.
+ */
+void test_GroupRegulatorsAreIndependent(void)
+{
+	SchedulingGroup* highGroup = &scheduler.groups[0];
+	uint32_t lowGroupBursts[2];
+
+	PartitionTasks(testGroups);
+
+	lowGroupBursts[0] = scheduler.taskList[2].stateVariables.tBurstOld;
+	lowGroupBursts[1] = scheduler.taskList[3].stateVariables.tBurstOld;
+
+	/* High group round is much shorter than its set point */
+	highGroup->regulatorInputs.tRound = 500;
+	RunRegulator(highGroup);
+
+	TEST_ASSERT_EQUAL_UINT32(lowGroupBursts[0], scheduler.taskList[2].stateVariables.tBurstOld);
+	TEST_ASSERT_EQUAL_UINT32(lowGroupBursts[1], scheduler.taskList[3].stateVariables.tBurstOld);
+	TEST_ASSERT_EQUAL_INT32(3000 - 500, highGroup->stateVariables.errRoundOld);
+}
+
+/*
+ * Tests that round set point follows the tightest latency of ready tasks.
+ */
+void test_RoundSetPointFollowsLatency(void)
+{
+	testTCBs[1].userTaskInfo->maxLatencyInUs = 6000;
+	testTCBs[3].userTaskInfo->maxLatencyInUs = 9000;
+
+	TEST_GROUP->regulatorInputs.tRound = TEST_GROUP->stateVariables.tRoundSetPoint;
+	RunRegulator(TEST_GROUP);
+	TEST_ASSERT_EQUAL_UINT32(6000, Scheduler_GetRoundSetPoint(&testTCBs[0]));
+
+	/* Tightest latency is not considered while its task is blocked */
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Waiting);
+	RunRegulator(TEST_GROUP);
+	TEST_ASSERT_EQUAL_UINT32(9000, Scheduler_GetRoundSetPoint(&testTCBs[0]));
+
+	/* Round of 3 ready tasks can not be shorter than their minimum bursts */
+	testTCBs[3].userTaskInfo->maxLatencyInUs = 100;
+	RunRegulator(TEST_GROUP);
+	TEST_ASSERT_EQUAL_UINT32(MATH_MAX(3 * AS_BURST_MIN_IN_US,
+									  (3 * AS_CONTEXT_SWITCH_COST_IN_US * 100) / AS_MAX_SWITCH_OVERHEAD_PERCENT),
+							 Scheduler_GetRoundSetPoint(&testTCBs[0]));
+
+	/* Round of 3 ready tasks can not be longer than their maximum bursts */
+	testTCBs[3].userTaskInfo->maxLatencyInUs = 0xFFFFFFF0UL;
+	RunRegulator(TEST_GROUP);
+	TEST_ASSERT_EQUAL_UINT32(3 * AS_BURST_MAX_IN_US, Scheduler_GetRoundSetPoint(&testTCBs[0]));
+
+	/* Nominal set point is restored when no ready task has a latency target */
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Waiting);
+	RunRegulator(TEST_GROUP);
+	TEST_ASSERT_EQUAL_UINT32(TASK_COUNT * AS_BURST_NOMINAL_IN_US, Scheduler_GetRoundSetPoint(&testTCBs[0]));
+}
+
+/*
+ * Tests that round set point given by scheduling group is not changed.
+ */
+void test_FixedRoundSetPointIsKept(void)
+{
+	testTCBs[0].userTaskInfo->maxLatencyInUs = 1000;
+
+	PartitionTasks(testGroups);
+
+	TEST_ASSERT_EQUAL_UINT32(3000, Scheduler_GetRoundSetPoint(&testTCBs[0]));
+
+	/* Low group does not have fixed set point but its tasks do not have latency targets */
+	TEST_ASSERT_EQUAL_UINT32(2 * AS_BURST_NOMINAL_IN_US, Scheduler_GetRoundSetPoint(&testTCBs[2]));
+}
+
+/*
+ * Tests that a woken latency sensitive task preempts running task and
+ * preempted task continues with its remaining burst.
+ */
+void test_UrgentTaskPreemptsOnWakeUp(void)
+{
+	uint32_t burstTime;
+
+	/* Task with latency target is an urgent task */
+	testTCBs[3].userTaskInfo->maxLatencyInUs = 1000;
+	memset(&scheduler, 0, sizeof(scheduler));
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Waiting);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	burstTime = mockTimer.timeoutInUs;
+
+	/* Woken urgent task does not wait for end of burst */
+	mockTimer.elapsedTimeInUs = 300;
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[3], lastSwitchedTCB);
+
+	/* Preempted task continues with its remaining burst */
+	mockTimer.elapsedTimeInUs = 200;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(burstTime - 300, mockTimer.timeoutInUs);
+
+	mockTimer.elapsedTimeInUs = burstTime - 300;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+
+	/* Regulator sees whole burst of preempted task */
+	TEST_ASSERT_EQUAL_UINT32(burstTime, ActualMeasurements(&scheduler.taskList[0])->tProcess);
+	TEST_ASSERT_EQUAL_UINT32(200, ActualMeasurements(&scheduler.taskList[3])->tProcess);
+	TEST_ASSERT_EQUAL_UINT32(burstTime + 200, TEST_GROUP->stateVariables.tRound);
+
+	/* Urgent task is already run in this round so only last task is left */
+	TEST_ASSERT_EQUAL_UINT32(TASK_BIT(&scheduler.taskList[2]), scheduler.roundPendingTasks);
+}
+
+/*
+ * Tests that a woken urgent task of a lower priority group does not preempt a
+ * task of a higher priority group.
+ */
+void test_UrgentTaskOfLowerGroupDoesNotPreempt(void)
+{
+	testTCBs[1].userTaskInfo->maxLatencyInUs = 1000;
+	testTCBs[3].userTaskInfo->maxLatencyInUs = 1000;
+	PartitionTasks(testGroups);
+
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Waiting);
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Waiting);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+
+	/* Urgent task of low group waits for end of burst */
+	mockTimer.elapsedTimeInUs = 300;
+	Scheduler_SetTaskState(&testTCBs[3], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+
+	/* Urgent task of same group preempts */
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+}
+
+/*
+ * Tests that a woken task without latency target waits for end of burst.
+ */
+void test_NonUrgentTaskWaitsForBurstEnd(void)
+{
+	Scheduler_SetTaskState(&testTCBs[2], OSTaskState_Waiting);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+
+	Scheduler_SetTaskState(&testTCBs[2], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+}
+
+/*
+ * Tests that idle task is preempted by any woken task.
+ */
+void test_IdleIsPreemptedOnWakeUp(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		Scheduler_SetTaskState(&testTCBs[i], OSTaskState_Waiting);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	mockTimer.elapsedTimeInUs = 500;
+	Scheduler_SetTaskState(&testTCBs[1], OSTaskState_Ready);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+
+	/* Idle time is not added to round time */
+	TEST_ASSERT_EQUAL_UINT32(0, TEST_GROUP->stateVariables.tRound);
+}
+
+/*
+ * Tests that best-effort tasks are shed in criticality order under
+ * sustained overload and critical tasks are never shed.
+ */
+void test_OverloadShedsBestEffortTasks(void)
+{
+	uint32_t overrun = TEST_GROUP->stateVariables.tRoundSetPoint * 2;
+
+	Scheduler_SetOverloadCallback(MockOverloadCallback);
+
+	/* Short overloads are regulator transients */
+	RunRounds(AS_OVERLOAD_WINDOW_ROUNDS - 1, overrun);
+	RunRounds(1, TEST_GROUP->stateVariables.tRoundSetPoint);
+	TEST_ASSERT_EQUAL_UINT32(0, overloadEventCount);
+
+	/* Least critical task is shed first */
+	RunRounds(AS_OVERLOAD_WINDOW_ROUNDS, overrun);
+	TEST_ASSERT_EQUAL_UINT32(1, overloadEventCount);
+	TEST_ASSERT_EQUAL_PTR(testTCBs[3].userTaskInfo, lastOverloadTask);
+	TEST_ASSERT_EQUAL(OSOverloadEvent_TaskShed, lastOverloadEvent);
+
+	RunRounds(AS_OVERLOAD_WINDOW_ROUNDS, overrun);
+	TEST_ASSERT_EQUAL_UINT32(2, overloadEventCount);
+	TEST_ASSERT_EQUAL_PTR(testTCBs[2].userTaskInfo, lastOverloadTask);
+
+	/* Critical tasks are not shed */
+	RunRounds(AS_OVERLOAD_WINDOW_ROUNDS * 4, overrun);
+	TEST_ASSERT_EQUAL_UINT32(2, overloadEventCount);
+
+	/* Shed tasks are not run */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+}
+
+/*
+ * Tests that shed tasks are restored in reverse order when overload is over.
+ */
+void test_ShedTasksAreRestored(void)
+{
+	uint32_t setPoint = TEST_GROUP->stateVariables.tRoundSetPoint;
+
+	Scheduler_SetOverloadCallback(MockOverloadCallback);
+
+	RunRounds(AS_OVERLOAD_WINDOW_ROUNDS * 2, setPoint * 2);
+	TEST_ASSERT_EQUAL_UINT32(2, overloadEventCount);
+
+	/* Round time on set point does not have spare time for shed tasks */
+	RunRounds(AS_RECOVERY_WINDOW_ROUNDS, setPoint);
+	TEST_ASSERT_EQUAL_UINT32(2, overloadEventCount);
+
+	/* More critical shed task is restored first */
+	RunRounds(AS_RECOVERY_WINDOW_ROUNDS, setPoint / 2);
+	TEST_ASSERT_EQUAL_UINT32(3, overloadEventCount);
+	TEST_ASSERT_EQUAL_PTR(testTCBs[2].userTaskInfo, lastOverloadTask);
+	TEST_ASSERT_EQUAL(OSOverloadEvent_TaskRestored, lastOverloadEvent);
+
+	RunRounds(AS_RECOVERY_WINDOW_ROUNDS, setPoint / 2);
+	TEST_ASSERT_EQUAL_UINT32(4, overloadEventCount);
+	TEST_ASSERT_EQUAL_PTR(testTCBs[3].userTaskInfo, lastOverloadTask);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.shedTasks);
+}
+
+/*
+ * Tests that priority change updates shares of group tasks when round is
+ * closed without resetting state of regulator.
+ */
+void test_TaskPriorityChange(void)
+{
+	uint32_t oldPriority = testTCBs[3].userTaskInfo->priority;
+	uint32_t oldSum = TEST_GROUP->sumOfPriorities;
+	uint32_t i;
+
+	TEST_ASSERT_TRUE(Scheduler_SetTaskPriority(&testTCBs[3], 0));
+
+	TEST_ASSERT_EQUAL_UINT32(oldSum - oldPriority, TEST_GROUP->sumOfPriorities);
+	TEST_ASSERT_TRUE(TEST_GROUP->prioritiesChanged);
+	TEST_ASSERT_FALSE(TEST_GROUP->reInitRegulator);
+	TEST_ASSERT_EQUAL_UINT32(0, mockCPUCore.criticalSectionLevel);
+
+	/* Regulator has a burst correction from previous rounds */
+	TEST_GROUP->stateVariables.burstCorrectionOld = 1000;
+	TEST_GROUP->regulatorInputs.tRound = TEST_GROUP->stateVariables.tRoundSetPoint;
+	RunRegulator(TEST_GROUP);
+
+	/* New shares are used at the end of round and PI state is kept */
+	TEST_ASSERT_FALSE(TEST_GROUP->prioritiesChanged);
+	TEST_ASSERT_EQUAL_INT32(1000, TEST_GROUP->stateVariables.burstCorrectionOld);
+	TEST_ASSERT_EQUAL_INT32(CalculateAlpha(1, oldSum - oldPriority), scheduler.taskList[3].stateVariables.alpha);
+	TEST_ASSERT_EQUAL_INT32(CalculateAlpha(testTCBs[1].userTaskInfo->priority + 1, oldSum - oldPriority),
+							scheduler.taskList[1].stateVariables.alpha);
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32(CalculateProcessSetPoint(scheduler.taskList[i].stateVariables.alpha,
+														  TEST_GROUP->regulatorInputs.tRound + 1000),
+								 scheduler.taskList[i].stateVariables.tProcessSetPoint);
+	}
+
+	/* Mock tasks are static so priority is restored */
+	TEST_ASSERT_TRUE(Scheduler_SetTaskPriority(&testTCBs[3], oldPriority));
+	TEST_ASSERT_EQUAL_UINT32(oldSum, TEST_GROUP->sumOfPriorities);
+}
+
+/*
+ * Tests that a task donates rest of its burst to another task and given up
+ * time is counted as its processed time.
+ */
+void test_YieldToDonatesRemainingBurst(void)
+{
+	uint32_t burstTime;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	burstTime = mockTimer.timeoutInUs;
+
+	/* Target runs immediately for the rest of the burst */
+	mockTimer.elapsedTimeInUs = 300;
+	Scheduler_YieldTo(&testTCBs[2]);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[2], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(burstTime - 300, mockTimer.timeoutInUs);
+	/* Donation is done in a critical section and interrupts are restored */
+	TEST_ASSERT_EQUAL_UINT32(0, mockCPUCore.criticalSectionLevel);
+
+	/* Target does not lose its own burst in round */
+	mockTimer.elapsedTimeInUs = 100;
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(TASK_BIT(&scheduler.taskList[2]) | TASK_BIT(&scheduler.taskList[3]),
+							 scheduler.roundPendingTasks);
+
+	/* Donated time is a part of donor's share */
+	TEST_ASSERT_EQUAL_UINT32(300, ActualMeasurements(&scheduler.taskList[0])->tProcess);
+	TEST_ASSERT_EQUAL_UINT32(burstTime - 300, ActualMeasurements(&scheduler.taskList[0])->tYielded);
+	TEST_ASSERT_EQUAL_UINT32(0, ActualMeasurements(&scheduler.taskList[2])->tProcess);
+	TEST_ASSERT_EQUAL_UINT32(400, TEST_GROUP->stateVariables.tRound);
+}
+
+/*
+ * Tests that rest of the burst is kept as bounded credit for next burst of
+ * yielding task.
+ */
+void test_YieldToSelfKeepsCredit(void)
+{
+	uint32_t credit;
+	uint32_t baseBurstTime;
+	uint32_t i;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	credit = MATH_MIN(mockTimer.timeoutInUs - 300, AS_MAX_BURST_CREDIT_IN_US);
+
+	mockTimer.elapsedTimeInUs = 300;
+	Scheduler_YieldTo(NULL);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(credit, scheduler.taskList[0].burstCreditInUs);
+
+	/* Complete round */
+	for (i = 1; i < TASK_COUNT; i++)
+	{
+		mockTimer.elapsedTimeInUs = mockTimer.timeoutInUs;
+		Scheduler_Yield();
+	}
+
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[0], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(credit, ClosedMeasurements(0)->tYielded);
+
+	/* Credit is added to next burst of task and consumed */
+	baseBurstTime = BurstToTime(scheduler.taskList[0].stateVariables.tBurstOld);
+	TEST_ASSERT_EQUAL_UINT32(MATH_MIN(baseBurstTime + credit, AS_BURST_MAX_IN_US), mockTimer.timeoutInUs);
+	TEST_ASSERT_EQUAL_UINT32(mockTimer.timeoutInUs - baseBurstTime, scheduler.burstCreditUsed);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.taskList[0].burstCreditInUs);
+}
+
+/*
+ * Tests worst case Burst Timer ISR which closes a round.
+ *
+ *  Closing a round only flips measurement set of group so switch which closes
+ *  a round costs about an in-round switch whatever task count is. Before it,
+ *  measurements of all tasks of group were copied in ISR and with 32 tasks
+ *  worst case switch was about 2.7 times an in-round switch.
+ */
+void test_RoundCloseSwitchLatency(void)
+{
+	SwitchCycles selected;
+
+	MeasureSwitchCycles(BOOL_FALSE, &selected);
+
+	TEST_ASSERT_TRUE(selected.roundCloseMax <= 2 * selected.inRoundMax);
+}
+
+/*
+ * Benchmark for switch latency with and without prepared decisions.
+ *
+ *  Prepared decisions only shorten switches in a round. Round closing (and
+ *  idle task selection) still selects next task in ISR so worst case switch
+ *  is round closing switch with or without prepared decisions.
+ *
+ *  [IMP] Host cycles just give an idea about costs. On target, worst case
+ *  Burst Timer ISR duration can be measured using AS_ENABLE_ISR_PROFILING.
+ */
+void test_SwitchLatency(void)
+{
+	SwitchCycles selected;
+	SwitchCycles prepared;
+
+	MeasureSwitchCycles(BOOL_FALSE, &selected);
+	MeasureSwitchCycles(BOOL_TRUE, &prepared);
+
+	/* Prepared decisions shorten switches in a round */
+	TEST_ASSERT_TRUE(prepared.inRoundAvg < selected.inRoundAvg);
+
+	/*
+	 * Worst case switch is round closing switch which selects in ISR in both
+	 * cases, so preparing decisions must not make it longer (measured on host
+	 * it is within 10%).
+	 */
+	TEST_ASSERT_TRUE(prepared.roundCloseMax <= selected.roundCloseMax + (selected.roundCloseMax / 2));
+}
@@ -4,7 +4,15 @@
  *
  * @author Murat Cakmak
  *
- * @brief Basic Cooparative Scheduler Implementation.
+ * @brief Priority Aware Cooparative Scheduler Implementation.
+ *
+ *         Each yield runs highest priority ready task. Tasks with same
+ *         priority are run in round-robin order. A running task is never
+ *         preempted, so scheduler does not use any timer.
+ *
+ *         Ready tasks are kept in a circular run queue per priority and a
+ *         two-level bitmap of ready priorities, so finding next task and
+ *         removing a blocked task are O(1).
  *
  * @see https://github.com/P-LATFORM/P-OS/wiki
  *
@@ -47,11 +55,39 @@
 #include "Debug.h"
 #include "postypes.h"
 
+#include "CooparativeScheduler_Internal.h"
+
 /***************************** MACRO DEFINITIONS ******************************/
 /* Task count */
 #define TASK_COUNT              NUM_OF_USER_TASKS
 
+/* Index of most significant set bit of a (non-zero) word */
+#define HIGHEST_BIT(value)      (31 - COUNT_LEADING_ZEROS(value))
+
+/* Priority group of a priority */
+#define PRIORITY_GROUP(priority) ((priority) / CS_PRIORITY_GROUP_SIZE)
+
+/* Bit of a priority in its priority group */
+#define PRIORITY_BIT(priority)  ((uint32_t)1 << ((priority) % CS_PRIORITY_GROUP_SIZE))
+
 /***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Cooparative Scheduler Task Information
+ */
+typedef struct TaskInfo
+{
+    /*
+     * Links in run queue of task priority. Both are NULL if task is not
+     * ready.
+     */
+    struct TaskInfo* next;
+    struct TaskInfo* prev;
+    /* Task Priority. Higher value is higher priority. */
+    uint32_t priority;
+    /* TCB reference to pass kernel on context switching */
+    TCB* tcb;
+} TaskInfo;
+
 /*
  * Cooparative Scheduler Internal Data Structure
  */
@@ -63,8 +99,16 @@ typedef struct
     TCB* idleTask;
     /* Kernel callback to inform Kernel core about context switching */
     SchedulerCSCallback csCallback;
-    /* Task index to track current task in cooparative scheduling */
-    int taskIndex;
+    /* Scheduler side information of user tasks */
+    TaskInfo taskList[TASK_COUNT];
+    /* Current (running) task. NULL if idle task is running. */
+    TaskInfo* currentTask;
+    /* Run queues (heads) of each priority. Head is next task to run. */
+    TaskInfo* runQueues[OS_TASK_PRIORITY_MAX];
+    /* Priority groups which have ready tasks */
+    uint32_t readyGroups;
+    /* Ready priorities in each group */
+    uint32_t readyPriorities[CS_PRIORITY_GROUP_COUNT];
 } CooparativeScheduler;
 /**************************** FUNCTION PROTOTYPES *****************************/
 
@@ -74,6 +118,89 @@ typedef struct
  */
 PRIVATE CooparativeScheduler scheduler;
 /**************************** PRIVATE FUNCTIONS *******************************/
+/*
+ * Adds a task to end of run queue of its priority.
+ */
+PRIVATE ALWAYS_INLINE void EnqueueTask(TaskInfo* task)
+{
+    uint32_t priority = task->priority;
+    TaskInfo* head = scheduler.runQueues[priority];
+
+    if (head == NULL)
+    {
+        task->next = task;
+        task->prev = task;
+        scheduler.runQueues[priority] = task;
+
+        /* Priority is ready now */
+        scheduler.readyPriorities[PRIORITY_GROUP(priority)] |= PRIORITY_BIT(priority);
+        scheduler.readyGroups |= PRIORITY_BIT(PRIORITY_GROUP(priority));
+    }
+    else
+    {
+        /* End of circular queue is just before head */
+        task->next = head;
+        task->prev = head->prev;
+        head->prev->next = task;
+        head->prev = task;
+    }
+}
+
+/*
+ * Removes a task from run queue of its priority.
+ */
+PRIVATE ALWAYS_INLINE void DequeueTask(TaskInfo* task)
+{
+    uint32_t priority = task->priority;
+    uint32_t group = PRIORITY_GROUP(priority);
+
+    if (task->next == task)
+    {
+        scheduler.runQueues[priority] = NULL;
+
+        /* Priority is not ready anymore */
+        scheduler.readyPriorities[group] &= ~PRIORITY_BIT(priority);
+        if (scheduler.readyPriorities[group] == 0)
+        {
+            scheduler.readyGroups &= ~PRIORITY_BIT(group);
+        }
+    }
+    else
+    {
+        task->prev->next = task->next;
+        task->next->prev = task->prev;
+
+        if (scheduler.runQueues[priority] == task)
+        {
+            scheduler.runQueues[priority] = task->next;
+        }
+    }
+
+    task->next = NULL;
+    task->prev = NULL;
+}
+
+/*
+ * Finds highest priority ready task in constant time.
+ *
+ * @return highest priority ready task or NULL if there is no ready task
+ */
+PRIVATE ALWAYS_INLINE TaskInfo* FindHighestPriorityTask(void)
+{
+    uint32_t group;
+    uint32_t priority;
+
+    if (scheduler.readyGroups == 0)
+    {
+        return NULL;
+    }
+
+    group = HIGHEST_BIT(scheduler.readyGroups);
+    priority = (group * CS_PRIORITY_GROUP_SIZE) +
+               HIGHEST_BIT(scheduler.readyPriorities[group]);
+
+    return scheduler.runQueues[priority];
+}
 
 /***************************** PUBLIC FUNCTIONS *******************************/
 /*
@@ -81,29 +208,85 @@ PRIVATE CooparativeScheduler scheduler;
  */
 PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
 {
+    TaskInfo* task;
+    uint32_t i;
+
     scheduler.taskPool = tcbList;
     scheduler.idleTask = idleTCB;
     scheduler.csCallback = csCallback;
-    scheduler.taskIndex = 0;
+    scheduler.currentTask = NULL;
+
+    /* All tasks are ready at startup */
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        task = &scheduler.taskList[i];
+        task->tcb = &tcbList[i];
+        task->priority = tcbList[i].userTaskInfo->priority;
+
+        DEBUG_ASSERT(task->priority < OS_TASK_PRIORITY_MAX);
+
+        EnqueueTask(task);
+    }
 }
 
 /*
  * Yields task in Scheduler side.
  *
- *  Primitive implementation for Cooparative scheduling.
+ *  Yielding task is moved to end of its run queue and highest priority ready
+ *  task is run.
  */
 PUBLIC void Scheduler_Yield(void)
 {
-    TCB* nextTCB;
+    TaskInfo* currentTask = scheduler.currentTask;
+    TaskInfo* nextTask;
 
-    /* Get next (ready) task from task pool */
-    nextTCB = &scheduler.taskPool[scheduler.taskIndex];
+    /*
+     * Running task is always at head of its run queue so moving head to next
+     * task moves running task to end of queue.
+     */
+    if ((currentTask != NULL) && (currentTask->next != NULL))
+    {
+        scheduler.runQueues[currentTask->priority] = currentTask->next;
+    }
 
-    /* Calculate task indexx for next yield */
-    scheduler.taskIndex = (scheduler.taskIndex + 1) % TASK_COUNT;
+    nextTask = FindHighestPriorityTask();
+    scheduler.currentTask = nextTask;
 
     /* Inform kernel about next task */
-    scheduler.csCallback(nextTCB);
+    scheduler.csCallback((nextTask != NULL) ? nextTask->tcb : scheduler.idleTask);
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  Blocked tasks are removed from run queues. Woken task is run when running
+ *  task yields.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task = &scheduler.taskList[tcb - scheduler.taskPool];
+
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if (task->next == NULL)
+        {
+            EnqueueTask(task);
+        }
+    }
+    else if (task->next != NULL)
+    {
+        DequeueTask(task);
+    }
+}
+
+/*
+ * Returns highest priority ready task without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    TaskInfo* nextTask = FindHighestPriorityTask();
+
+    return (nextTask != NULL) ? nextTask->tcb : scheduler.idleTask;
 }
 
 #endif /* #if (OS_SCHEDULER == OS_SCHEDULER_COOPARATIVE) */
@@ -0,0 +1,198 @@
+/*******************************************************************************
+ *
+ * @file unittest_CooparativeScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Cooparative Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../CooparativeScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_LOW						(0)		/* Priority 5 */
+#define TEST_TASK_MID_1						(1)		/* Priority 40 */
+#define TEST_TASK_MID_2						(2)		/* Priority 40 */
+#define TEST_TASK_HIGH						(3)		/* Priority 63 */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that highest priority ready task is run on each yield.
+ */
+void test_HighestPriorityTaskIsRun(void)
+{
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+
+	/* Blocked task is not considered anymore */
+	BlockTask(TEST_TASK_HIGH);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(40), scheduler.readyPriorities[1]);
+}
+
+/*
+ * Tests round-robin order between tasks with same priority.
+ */
+void test_RoundRobinBetweenSamePriorities(void)
+{
+	BlockTask(TEST_TASK_HIGH);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+}
+
+/*
+ * Tests that a woken task does not preempt running task but is run on next
+ * yield.
+ */
+void test_WokenTaskIsRunOnYield(void)
+{
+	BlockTask(TEST_TASK_HIGH);
+	BlockTask(TEST_TASK_MID_1);
+	BlockTask(TEST_TASK_MID_2);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_HIGH);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], Scheduler_GetNextTCB());
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+}
+
+/*
+ * Tests that idle task is run if there is no ready task.
+ */
+void test_IdleTaskIsRunWithoutReadyTask(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		BlockTask(i);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_HEX32(0, scheduler.readyGroups);
+
+	WakeUpTask(TEST_TASK_LOW);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+}
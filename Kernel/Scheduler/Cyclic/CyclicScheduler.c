@@ -0,0 +1,489 @@
+/*******************************************************************************
+ *
+ * @file CyclicScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Cyclic Executive (Time-Triggered) Scheduler Implementation.
+ *
+ *          Tasks are run in slots of a static schedule table which is
+ *          declared in UserStartupInfo.h (see OS_CYCLIC_SCHEDULE). Layout of
+ *          frames is checked at build time and table is resolved once in
+ *          initialization.
+ *
+ *          At runtime scheduler only advances slot index on each timer
+ *          interrupt so there is no search, no floating point and no
+ *          decision cost on context switches. Each slot timer is started
+ *          from end of previous slot (not from ISR time) so major frame
+ *          does not drift with interrupt latency. A slot is never given to
+ *          another task, if slot owner is blocked or it yields, idle task
+ *          runs until next slot.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#include "OSConfig.h"
+
+#if (OS_SCHEDULER == OS_SCHEDULER_CYCLIC)
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+#include "Scheduler.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Task count */
+#define TASK_COUNT                          NUM_OF_USER_TASKS
+
+/* Slot count in major frame */
+#define SLOT_COUNT                          (sizeof(cyclicSchedule) / sizeof(OSCyclicSlot))
+
+/* Length of major frame */
+#define MAJOR_FRAME_IN_US                   (cyclicMinorFrameInUs * cyclicMinorFrameCount)
+
+/*
+ * Cyclic scheduler is an internal object and external objects
+ * (e.g. User Application) cannot access and cannot pass parameter into
+ * this module. And assume that OS modules are robust and do not pass erronous
+ * parameters so no need to check parameter for public function to avoid
+ * unnecessary checks.
+ */
+#define CS_PARAMETER_CHECK(...)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Task Information
+ */
+typedef struct TaskInfo
+{
+    /* Task State */
+    OSTaskState state;
+
+    /*
+     * Task Control Block (TCB) Reference.
+     *  Kernel interests only TCB for context switching, when scheduler finds
+     *  the next task, just provides next task's TCB to kernel.
+     */
+    TCB* tcb;
+} TaskInfo;
+
+/*
+ * Resolved Slot
+ *
+ *  Slots of schedule table are resolved in initialization so timer ISR
+ *  does not need any calculation.
+ */
+typedef struct
+{
+    /* Task which runs in slot */
+    TaskInfo* task;
+    /* Duration of slot */
+    uint32_t durationInUs;
+    /* Idle time after slot until next slot. Zero if slots are adjacent. */
+    uint32_t gapInUs;
+} Slot;
+
+/*
+ * Scheduler Data Structure.
+ */
+typedef struct
+{
+    /*
+     * Slot Timer
+     *  Interrupts at the end of each slot and gap.
+     */
+    KernelTimerHandle timer;
+
+    /* Client (Kernel) callback function to notify kernel for to be run task */
+    SchedulerCSCallback csCallback;
+
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Task List (Pool) to collect all user tasks. */
+    TaskInfo taskList[TASK_COUNT];
+    /* Idle task. Run between slots and in slots of blocked tasks. */
+    TaskInfo idleTask;
+    /* Reference to Current (Running) task*/
+    TaskInfo* currentTask;
+
+    /* Resolved schedule table */
+    Slot slots[SLOT_COUNT];
+    /* Index of actual slot */
+    uint32_t slotIndex;
+    /* Idle time before first slot of major frame */
+    uint32_t leadInUs;
+    /* Number of completed major frames */
+    uint32_t majorFrameCount;
+
+    struct
+    {
+        /* Indicates whether if schedule is started */
+        uint32_t started : 1;
+        /* Indicates whether if idle time after actual slot is running */
+        uint32_t inGap : 1;
+        /* Indicates whether if slot owner gave up rest of its slot */
+        uint32_t slotYielded : 1;
+        /* Indicates whether if schedule table is rejected in initialization */
+        uint32_t scheduleRejected : 1;
+        uint32_t __reserved : 28;
+    } flags;
+} SchedulerData;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Scheduler (Internal) Data
+ */
+PRIVATE SchedulerData scheduler;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+/*
+ * Checks whether if a task is ready or not.
+ *
+ * @param task to be checked task
+ * @return BOOL_TRUE if task is ready, otherwise BOOL_FALSE
+ */
+PRIVATE ALWAYS_INLINE uint32_t IsTaskReady(TaskInfo* task)
+{
+    return ((task->state == OSTaskState_Ready) || (task->state == OSTaskState_Running)) ?
+           BOOL_TRUE : BOOL_FALSE;
+}
+
+/*
+ * Switches to a task.
+ *
+ * @param nextTask to be switched task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void SwitchTo(TaskInfo* nextTask)
+{
+    scheduler.currentTask = nextTask;
+
+    /* Notify kernel and pass next task (TCB) */
+    scheduler.csCallback(nextTask->tcb);
+}
+
+/*
+ * Starts slot timer.
+ *
+ * @param timeoutInUs duration of slot or gap
+ * @param fromLastTimeout BOOL_TRUE to start timer from end of previous slot
+ *        or gap, BOOL_FALSE to start it from now (start of schedule)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void StartSlotTimer(uint32_t timeoutInUs, uint32_t fromLastTimeout)
+{
+    if (fromLastTimeout == BOOL_TRUE)
+    {
+        /* ISR latency is not added to schedule */
+        Kernel_ContinuePreemptionTimer(scheduler.timer, timeoutInUs);
+    }
+    else
+    {
+        Kernel_StartPreemptionTimer(scheduler.timer, timeoutInUs);
+    }
+}
+
+/*
+ * Starts actual slot.
+ *
+ *  Slot owner runs if it is ready, otherwise slot is idle.
+ *
+ * @param fromLastTimeout BOOL_TRUE if slot starts at end of previous slot
+ *        or gap
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void StartSlot(uint32_t fromLastTimeout)
+{
+    Slot* slot = &scheduler.slots[scheduler.slotIndex];
+
+    scheduler.flags.inGap = BOOL_FALSE;
+    scheduler.flags.slotYielded = BOOL_FALSE;
+
+    StartSlotTimer(slot->durationInUs, fromLastTimeout);
+
+    SwitchTo((IsTaskReady(slot->task) == BOOL_TRUE) ? slot->task : &scheduler.idleTask);
+}
+
+/*
+ * Starts idle time after actual slot.
+ *
+ * @param gapInUs idle time
+ * @param fromLastTimeout BOOL_TRUE if gap starts at end of previous slot
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void StartGap(uint32_t gapInUs, uint32_t fromLastTimeout)
+{
+    scheduler.flags.inGap = BOOL_TRUE;
+
+    StartSlotTimer(gapInUs, fromLastTimeout);
+
+    SwitchTo(&scheduler.idleTask);
+}
+
+/*
+ * Interrupt Service Routine (ISR) to handle end of slots and gaps
+ */
+void ISR_SlotTimer(void) NO_INLINE;
+void ISR_SlotTimer(void)
+{
+    uint32_t gapInUs = scheduler.slots[scheduler.slotIndex].gapInUs;
+
+    if ((scheduler.flags.inGap == BOOL_FALSE) && (gapInUs != 0))
+    {
+        StartGap(gapInUs, BOOL_TRUE);
+    }
+    else
+    {
+        /* Just advance to next slot */
+        scheduler.slotIndex++;
+        if (scheduler.slotIndex == SLOT_COUNT)
+        {
+            scheduler.slotIndex = 0;
+            scheduler.majorFrameCount++;
+        }
+
+        StartSlot(BOOL_TRUE);
+    }
+}
+
+/*
+ * Finds task of a user task.
+ *
+ * @param userTask User Task in schedule table
+ * @return task of user task
+ */
+PRIVATE ALWAYS_INLINE TaskInfo* FindTask(void* userTask)
+{
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        if ((void*)scheduler.taskList[i].tcb->userTaskInfo == userTask)
+        {
+            return &scheduler.taskList[i];
+        }
+    }
+
+    /* Slots can only be given to startup applications */
+    DEBUG_ASSERT(0);
+
+    return &scheduler.idleTask;
+}
+
+/*
+ * Initializes tasks.
+ *
+ * @param tcbList list of to be initialized tasks (TCBs)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
+{
+    TaskInfo* task;
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        task = &scheduler.taskList[i];
+
+        task->tcb = &tcbList[i];
+
+        /* When a task is created, it should be in ready state */
+        task->state = OSTaskState_Ready;
+    }
+}
+
+/*
+ * Resolves tasks and gaps of schedule table.
+ *
+ *  Fitting of slots into frames is checked at build time, order of slots
+ *  is checked here in all builds because an overlapping slot can not be
+ *  followed. System is halted for an unordered table (also in release
+ *  builds) so a wrong table is not run silently as an idle system.
+ *
+ * @param schedule schedule table
+ * @return BOOL_TRUE if slots are in time order, otherwise BOOL_FALSE
+ */
+PRIVATE ALWAYS_INLINE uint32_t InitializeSlots(const OSCyclicSlot* schedule)
+{
+    uint32_t slotEnd;
+    uint32_t nextStart;
+    uint32_t i;
+
+    for (i = 0; i < SLOT_COUNT; i++)
+    {
+        scheduler.slots[i].task = FindTask(schedule[i].userTask);
+        scheduler.slots[i].durationInUs = schedule[i].durationInUs;
+
+        slotEnd = schedule[i].startInUs + schedule[i].durationInUs;
+
+        /* Last slot is followed by first slot of next major frame */
+        nextStart = (i + 1 < SLOT_COUNT) ? schedule[i + 1].startInUs :
+                                           (MAJOR_FRAME_IN_US + schedule[0].startInUs);
+
+        /* Slots must be in time order and must not overlap */
+        if (nextStart < slotEnd)
+        {
+            Kernel_Halt();
+
+            return BOOL_FALSE;
+        }
+
+        scheduler.slots[i].gapInUs = nextStart - slotEnd;
+    }
+
+    scheduler.leadInUs = schedule[0].startInUs;
+
+    return BOOL_TRUE;
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Cyclic Scheduler
+ */
+PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
+{
+    CS_PARAMETER_CHECK(tcbList, idleTCB, csCallback);
+
+    /* Save client(kernel) callback to notify when Context Switching required */
+    scheduler.csCallback = csCallback;
+
+    /*
+     * Create timer to switch tasks at the end of slots.
+     */
+    scheduler.timer = Kernel_CreatePreemptionTimer(SYSTEM_TIMER_KERNEL,
+                                                   KERNEL_TIMER_PRIORITY,
+                                                   ISR_SlotTimer);
+
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+    /* Save Idle TCB to run idle task between slots */
+    scheduler.idleTask.tcb = idleTCB;
+
+    InitializeTasks(tcbList);
+
+    if (InitializeSlots(cyclicSchedule) == BOOL_FALSE)
+    {
+        /* System is halted, schedule is never started if halt returns */
+        scheduler.flags.scheduleRejected = BOOL_TRUE;
+    }
+
+    /* Kernel starts with idle task */
+    scheduler.currentTask = &scheduler.idleTask;
+}
+
+/*
+ * Yields running task.
+ *
+ *  First yield (of idle task) starts schedule if schedule table is not
+ *  rejected. After that, a yielding task gives up rest of its slot and idle
+ *  task runs until end of slot. Schedule is never shifted by yields.
+ */
+PUBLIC void Scheduler_Yield(void)
+{
+    if (scheduler.flags.scheduleRejected == BOOL_TRUE)
+    {
+        /* Idle task keeps running */
+    }
+    else if (scheduler.flags.started == BOOL_FALSE)
+    {
+        scheduler.flags.started = BOOL_TRUE;
+
+        if (scheduler.leadInUs != 0)
+        {
+            /* Idle until first slot, ISR advances to first slot */
+            scheduler.slotIndex = SLOT_COUNT - 1;
+            StartGap(scheduler.leadInUs, BOOL_FALSE);
+        }
+        else
+        {
+            scheduler.slotIndex = 0;
+            StartSlot(BOOL_FALSE);
+        }
+    }
+    else if (scheduler.currentTask != &scheduler.idleTask)
+    {
+        scheduler.flags.slotYielded = BOOL_TRUE;
+
+        SwitchTo(&scheduler.idleTask);
+    }
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  A blocked slot owner which becomes ready in its slot continues its slot.
+ *  Other tasks wait for their slots.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+
+    CS_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    task->state = state;
+
+    if ((IsTaskReady(task) == BOOL_TRUE) &&
+        (scheduler.flags.started == BOOL_TRUE) &&
+        (scheduler.flags.inGap == BOOL_FALSE) &&
+        (scheduler.flags.slotYielded == BOOL_FALSE) &&
+        (scheduler.slots[scheduler.slotIndex].task == task) &&
+        (scheduler.currentTask == &scheduler.idleTask))
+    {
+        SwitchTo(task);
+    }
+}
+
+/*
+ * Returns task which should run in actual slot without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    TaskInfo* task = scheduler.slots[scheduler.slotIndex].task;
+
+    if ((scheduler.flags.inGap == BOOL_TRUE) ||
+        (scheduler.flags.slotYielded == BOOL_TRUE) ||
+        (IsTaskReady(task) == BOOL_FALSE))
+    {
+        task = &scheduler.idleTask;
+    }
+
+    return task->tcb;
+}
+
+#endif /* #if (OS_SCHEDULER == OS_SCHEDULER_CYCLIC) */
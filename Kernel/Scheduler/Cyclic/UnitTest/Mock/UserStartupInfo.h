@@ -0,0 +1,82 @@
+/*******************************************************************************
+ *
+ * @file UserStartupInfo.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock User Tasks and Schedule Table for Cyclic Scheduler Tests
+ *
+ * Major frame has two minor frames. First task runs in both minor frames,
+ * slots of second minor frame have gaps.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __USER_STARTUP_INFO_H
+#define __USER_STARTUP_INFO_H
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Task start points are never called in unit tests so all tasks share a
+ * single start point.
+ */
+OS_USER_TASK_START_POINT(MockTaskFunc);
+
+/* Mock User Tasks. Priorities are not used by Cyclic scheduler. */
+OS_USER_TASK(MockTask1, MockTaskFunc, 64, 0);
+OS_USER_TASK(MockTask2, MockTaskFunc, 64, 0);
+OS_USER_TASK(MockTask3, MockTaskFunc, 64, 0);
+
+/* Startup Applications */
+OS_STARTUP_APPLICATIONS
+(
+    OS_USER_TASK_PREFIX(MockTask1),
+    OS_USER_TASK_PREFIX(MockTask2),
+    OS_USER_TASK_PREFIX(MockTask3)
+)
+
+/* Schedule Table. 1ms minor frames, 2ms major frame. */
+OS_CYCLIC_SCHEDULE
+(
+    1000, 2,
+    OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+    OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask2), 300, 400),
+    OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+    OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask3), 500, 200)
+)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif	/* __USER_STARTUP_INFO_H */
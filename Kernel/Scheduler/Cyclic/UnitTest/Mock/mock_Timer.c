@@ -0,0 +1,125 @@
+/*******************************************************************************
+ *
+ * @file mock_Timer.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Mock Implementation for Timer Driver
+ *
+ * Keeps last timer request and lets tests specify elapsed time of running
+ * burst.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "Drv_Timer.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/***************************** TYPE DEFINITIONS *******************************/
+/*
+ * Mock Timer Object
+ */
+typedef struct
+{
+	/* Registered client callback */
+	DrvTimerCallback callback;
+	/* Last requested timeout value */
+	uint32_t timeoutInUs;
+	/* Elapsed time which is returned to client. Set by tests. */
+	uint32_t elapsedTimeInUs;
+	/* Number of timer start requests */
+	uint32_t startCount;
+	/* Number of timer start requests from last timeout */
+	uint32_t continueCount;
+} MockTimer;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Mock Timer. There is only one (kernel) timer in scheduler tests.
+ */
+static MockTimer mockTimer;
+
+/********************************** FUNCTIONS *********************************/
+
+/*
+ * Resets mock timer
+ */
+static INLINE void MockTimer_Reset(void)
+{
+	memset(&mockTimer, 0, sizeof(mockTimer));
+}
+
+/*
+ * Mock Implementation of Drv_Timer_Create
+ */
+TimerHandle Drv_Timer_Create(TimerNo timerNo, DrvTimerPriority priority, DrvTimerCallback timerCallback)
+{
+	(void)timerNo;
+	(void)priority;
+
+	mockTimer.callback = timerCallback;
+
+	return (TimerHandle)1;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_Start
+ */
+void Drv_Timer_Start(TimerHandle timerHandle, uint32_t timeoutInUs)
+{
+	(void)timerHandle;
+
+	mockTimer.timeoutInUs = timeoutInUs;
+	mockTimer.startCount++;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_StartFromLastTimeout
+ */
+void Drv_Timer_StartFromLastTimeout(TimerHandle timerHandle, uint32_t timeoutInUs)
+{
+	(void)timerHandle;
+
+	mockTimer.timeoutInUs = timeoutInUs;
+	mockTimer.continueCount++;
+}
+
+/*
+ * Mock Implementation of Drv_Timer_ReadElapsedTimeInUs
+ */
+uint32_t Drv_Timer_ReadElapsedTimeInUs(TimerHandle timerHandle)
+{
+	(void)timerHandle;
+
+	return mockTimer.elapsedTimeInUs;
+}
@@ -0,0 +1,299 @@
+/*******************************************************************************
+ *
+ * @file unittest_CyclicScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Cyclic Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "Mock/mock_Timer.c"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../CyclicScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_1							(0)
+#define TEST_TASK_2							(1)
+#define TEST_TASK_3							(2)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Expected scheduler step (a slot or a gap)
+ */
+typedef struct
+{
+	/* Expected task, NULL for idle task */
+	TCB* tcb;
+	/* Expected timer timeout */
+	uint32_t timeoutInUs;
+} TestStep;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* Number of system halts */
+static uint32_t haltCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Mock Implementation of Drv_CPUCore_Halt. Returns to let tests continue.
+ */
+void Drv_CPUCore_Halt(void)
+{
+	haltCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	MockTimer_Reset();
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+	haltCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that schedule table is resolved into tasks and gaps.
+ */
+void test_ScheduleTableIsResolved(void)
+{
+	TEST_ASSERT_EQUAL_UINT32(4, SLOT_COUNT);
+	TEST_ASSERT_EQUAL_UINT32(2000, MAJOR_FRAME_IN_US);
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.leadInUs);
+
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_1], scheduler.slots[0].task);
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_2], scheduler.slots[1].task);
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_1], scheduler.slots[2].task);
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_3], scheduler.slots[3].task);
+
+	/* Slots in first minor frame are adjacent, then idle until second one */
+	TEST_ASSERT_EQUAL_UINT32(0, scheduler.slots[0].gapInUs);
+	TEST_ASSERT_EQUAL_UINT32(300, scheduler.slots[1].gapInUs);
+	TEST_ASSERT_EQUAL_UINT32(200, scheduler.slots[2].gapInUs);
+
+	/* Last slot is followed by first slot of next major frame */
+	TEST_ASSERT_EQUAL_UINT32(300, scheduler.slots[3].gapInUs);
+}
+
+/*
+ * Tests that tasks are run in slots of table over major frames.
+ */
+void test_TableIsFollowed(void)
+{
+	const TestStep steps[] =
+	{
+		{ &testTCBs[TEST_TASK_1], 300 },
+		{ &testTCBs[TEST_TASK_2], 400 },
+		{ &testIdleTCB, 300 },
+		{ &testTCBs[TEST_TASK_1], 300 },
+		{ &testIdleTCB, 200 },
+		{ &testTCBs[TEST_TASK_3], 200 },
+		{ &testIdleTCB, 300 },
+	};
+	uint32_t stepCount = sizeof(steps) / sizeof(TestStep);
+	uint32_t frame;
+	uint32_t i;
+
+	/* Idle task starts schedule */
+	Scheduler_Yield();
+
+	for (frame = 0; frame < 3; frame++)
+	{
+		for (i = 0; i < stepCount; i++)
+		{
+			TEST_ASSERT_EQUAL_PTR(steps[i].tcb, lastSwitchedTCB);
+			TEST_ASSERT_EQUAL_UINT32(steps[i].timeoutInUs, mockTimer.timeoutInUs);
+
+			mockTimer.callback();
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(3, scheduler.majorFrameCount);
+
+	/* Only first slot is started from now, others from end of previous step */
+	TEST_ASSERT_EQUAL_UINT32(1, mockTimer.startCount);
+	TEST_ASSERT_EQUAL_UINT32(3 * stepCount, mockTimer.continueCount);
+}
+
+/*
+ * Tests that a schedule table whose slots are not in time order is rejected
+ * and system is halted.
+ */
+void test_OutOfOrderTableIsRejected(void)
+{
+	const OSCyclicSlot overlappingSchedule[] =
+	{
+		OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+		OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask2), 200, 400),
+		OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+		OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask3), 500, 200)
+	};
+	const OSCyclicSlot unorderedSchedule[] =
+	{
+		OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+		OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask1), 0, 300),
+		OS_CYCLIC_SLOT(0, OS_USER_TASK_PREFIX(MockTask2), 300, 400),
+		OS_CYCLIC_SLOT(1, OS_USER_TASK_PREFIX(MockTask3), 500, 200)
+	};
+
+	TEST_ASSERT_FALSE(InitializeSlots(overlappingSchedule));
+	TEST_ASSERT_EQUAL_UINT32(1, haltCount);
+	TEST_ASSERT_FALSE(InitializeSlots(unorderedSchedule));
+	TEST_ASSERT_EQUAL_UINT32(2, haltCount);
+	TEST_ASSERT_TRUE(InitializeSlots(cyclicSchedule));
+	TEST_ASSERT_EQUAL_UINT32(2, haltCount);
+
+	/* Rejected schedule is never started */
+	scheduler.flags.scheduleRejected = BOOL_TRUE;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_UINT32(0, mockTimer.startCount);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+
+	WakeUpTask(TEST_TASK_1);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+}
+
+/*
+ * Tests that slot of a blocked task is idle and it is not given to another
+ * task.
+ */
+void test_BlockedTaskSlotIsIdle(void)
+{
+	BlockTask(TEST_TASK_1);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(300, mockTimer.timeoutInUs);
+
+	/* Slot owner continues its slot when it becomes ready */
+	WakeUpTask(TEST_TASK_1);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_1], lastSwitchedTCB);
+
+	/* Other tasks wait for their slots */
+	BlockTask(TEST_TASK_2);
+	mockTimer.callback();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_3);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+}
+
+/*
+ * Tests that a yielding task gives up rest of its slot without shifting
+ * schedule.
+ */
+void test_YieldGivesUpSlot(void)
+{
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_1], lastSwitchedTCB);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	/* Timer is not restarted */
+	TEST_ASSERT_EQUAL_UINT32(1, mockTimer.startCount);
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, Scheduler_GetNextTCB());
+
+	/* Next slot starts on time */
+	mockTimer.callback();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_2], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_2], Scheduler_GetNextTCB());
+}
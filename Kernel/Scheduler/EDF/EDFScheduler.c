@@ -0,0 +1,717 @@
+/*******************************************************************************
+ *
+ * @file EDFScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Earliest Deadline First (EDF) Scheduler Implementation.
+ *
+ *          Ready task with earliest absolute deadline is run. Periodic tasks
+ *          (see OS_PERIODIC_USER_TASK) release a job at each period and a job
+ *          is completed when task yields. Deadline of a job is its release
+ *          time plus relative deadline of task (period by default, see
+ *          OS_PERIODIC_DEADLINE_USER_TASK).
+ *
+ *          Ready tasks are kept in a binary min-heap keyed on absolute deadline
+ *          and periodic tasks are kept in another min-heap keyed on next
+ *          release time so insert and remove are O(log n).
+ *
+ *          Aperiodic tasks are run in background (in FIFO order) if there is
+ *          no ready periodic job.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#include "OSConfig.h"
+
+#if (OS_SCHEDULER == OS_SCHEDULER_EDF)
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+#include "Scheduler.h"
+
+#include "EDFScheduler_Internal.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Task count */
+#define TASK_COUNT                          NUM_OF_USER_TASKS
+
+/* Heap index of a task which is not in heap */
+#define NOT_IN_HEAP                         (0xFFFFFFFFUL)
+
+/* Heap node of a task in a heap */
+#define HEAP_NODE(heap, task)               (&(task)->heapNodes[(heap)->nodeIndex])
+
+/* Key of an item in a heap */
+#define HEAP_KEY(heap, index)               (HEAP_NODE(heap, (heap)->items[index])->key)
+
+/*
+ * Keys of aperiodic (background) tasks start from this value so they are
+ * always after periodic jobs in ready heap.
+ */
+#define BACKGROUND_KEY_BASE                 ((uint64_t)1 << 63)
+
+/*
+ * EDF scheduler is an internal object and external objects
+ * (e.g. User Application) cannot access and cannot pass parameter into
+ * this module. And assume that OS modules are robust and do not pass erronous
+ * parameters so no need to check parameter for public function to avoid
+ * unnecessary checks.
+ */
+#define EDF_PARAMETER_CHECK(...)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Heaps which a task can be kept in
+ */
+typedef enum
+{
+    /* Ready tasks keyed on absolute deadline */
+    HeapType_Ready = 0,
+    /* Periodic tasks keyed on next release time */
+    HeapType_Release,
+    HeapType_Count
+} HeapType;
+
+/*
+ * Heap Node
+ *  Each task has a node for each heap so it can be kept in both heaps.
+ */
+typedef struct
+{
+    /* Key of task in heap */
+    uint64_t key;
+    /* Index of task in heap array. NOT_IN_HEAP if task is not in heap. */
+    uint32_t index;
+} HeapNode;
+
+/*
+ * Task Information
+ */
+typedef struct TaskInfo
+{
+    /* Heap nodes of task */
+    HeapNode heapNodes[HeapType_Count];
+
+    /* Absolute deadline of current job */
+    uint64_t deadline;
+    /* Release time of next job */
+    uint64_t nextRelease;
+    /* Missed deadline of a job which is still pending at next release */
+    uint64_t missedDeadline;
+    /* Period of task. Zero for aperiodic tasks. */
+    uint32_t periodInUs;
+    /* Relative deadline of jobs. Not longer than period. */
+    uint32_t relativeDeadlineInUs;
+
+    /* Task flags */
+    struct
+    {
+        /* Task passed admission test */
+        uint32_t admitted : 1;
+        /* Task is blocked (e.g. waits for an event) */
+        uint32_t blocked : 1;
+        /* A job is released and not completed yet */
+        uint32_t jobPending : 1;
+        /* Pending job has missed its deadline (missedDeadline is valid) */
+        uint32_t jobLate : 1;
+        uint32_t __reserved : 28;
+    } flags;
+
+    /* Task State */
+    OSTaskState state;
+
+    /*
+     * Task Control Block (TCB) Reference.
+     *  Kernel interests only TCB for context switching, when scheduler finds
+     *  the next task, just provides next task's TCB to kernel.
+     */
+    TCB* tcb;
+} TaskInfo;
+
+/*
+ * Array based binary min-heap of tasks
+ */
+typedef struct
+{
+    /* Tasks in heap order */
+    TaskInfo* items[TASK_COUNT];
+    /* Number of tasks in heap */
+    uint32_t count;
+    /* Index of heap node in tasks (HeapType) */
+    uint32_t nodeIndex;
+} TaskHeap;
+
+/*
+ * Scheduler Data Structure.
+ */
+typedef struct
+{
+    /*
+     * Kernel Timer
+     *  Expires at next job release and keeps scheduler time.
+     */
+    KernelTimerHandle timer;
+
+    /* Client (Kernel) callback function to notify kernel for to be run task */
+    SchedulerCSCallback csCallback;
+
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Task List (Pool) to collect all user tasks. */
+    TaskInfo taskList[TASK_COUNT];
+    /* Idle task. Run if there is no ready task. */
+    TaskInfo idleTask;
+    /* Reference to Current (Running) task*/
+    TaskInfo* currentTask;
+
+    /* Ready tasks ordered by absolute deadlines */
+    TaskHeap readyHeap;
+    /* Periodic tasks ordered by next release times */
+    TaskHeap releaseHeap;
+
+    /* Scheduler time in microseconds since start of scheduling */
+    uint64_t now;
+    /* Sequence to keep FIFO order between aperiodic tasks */
+    uint64_t backgroundSequence;
+    /* Total utilization of admitted tasks */
+    uint32_t utilization;
+} SchedulerData;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Scheduler (Internal) Data
+ */
+PRIVATE SchedulerData scheduler;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+/*
+ * Places a task into a position of heap
+ */
+PRIVATE ALWAYS_INLINE void Heap_Place(TaskHeap* heap, TaskInfo* task, uint32_t index)
+{
+    heap->items[index] = task;
+    HEAP_NODE(heap, task)->index = index;
+}
+
+/*
+ * Moves a task up until its parent has a smaller key.
+ */
+PRIVATE void Heap_SiftUp(TaskHeap* heap, uint32_t index)
+{
+    TaskInfo* task = heap->items[index];
+    uint64_t key = HEAP_NODE(heap, task)->key;
+    uint32_t parent;
+
+    while (index > 0)
+    {
+        parent = (index - 1) / 2;
+
+        if (HEAP_KEY(heap, parent) <= key)
+        {
+            break;
+        }
+
+        Heap_Place(heap, heap->items[parent], index);
+        index = parent;
+    }
+
+    Heap_Place(heap, task, index);
+}
+
+/*
+ * Moves a task down until its children have bigger keys.
+ */
+PRIVATE void Heap_SiftDown(TaskHeap* heap, uint32_t index)
+{
+    TaskInfo* task = heap->items[index];
+    uint64_t key = HEAP_NODE(heap, task)->key;
+    uint32_t child;
+
+    while ((child = (2 * index) + 1) < heap->count)
+    {
+        /* Select child with smaller key */
+        if (((child + 1) < heap->count) && (HEAP_KEY(heap, child + 1) < HEAP_KEY(heap, child)))
+        {
+            child++;
+        }
+
+        if (key <= HEAP_KEY(heap, child))
+        {
+            break;
+        }
+
+        Heap_Place(heap, heap->items[child], index);
+        index = child;
+    }
+
+    Heap_Place(heap, task, index);
+}
+
+/*
+ * Checks whether if a task is in heap or not.
+ */
+PRIVATE ALWAYS_INLINE uint32_t Heap_Contains(TaskHeap* heap, TaskInfo* task)
+{
+    return (HEAP_NODE(heap, task)->index != NOT_IN_HEAP) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+/*
+ * Returns task with minimum key or NULL if heap is empty.
+ */
+PRIVATE ALWAYS_INLINE TaskInfo* Heap_Min(TaskHeap* heap)
+{
+    return (heap->count > 0) ? heap->items[0] : NULL;
+}
+
+/*
+ * Inserts a task into heap. O(log n)
+ */
+PRIVATE void Heap_Insert(TaskHeap* heap, TaskInfo* task, uint64_t key)
+{
+    HEAP_NODE(heap, task)->key = key;
+
+    Heap_Place(heap, task, heap->count);
+    heap->count++;
+
+    Heap_SiftUp(heap, heap->count - 1);
+}
+
+/*
+ * Removes a task from any position of heap. O(log n)
+ */
+PRIVATE void Heap_Remove(TaskHeap* heap, TaskInfo* task)
+{
+    uint32_t index = HEAP_NODE(heap, task)->index;
+
+    heap->count--;
+
+    if (index != heap->count)
+    {
+        /* Move last task into empty position and restore heap order */
+        Heap_Place(heap, heap->items[heap->count], index);
+        Heap_SiftDown(heap, index);
+        Heap_SiftUp(heap, HEAP_NODE(heap, heap->items[index])->index);
+    }
+
+    HEAP_NODE(heap, task)->index = NOT_IN_HEAP;
+}
+
+/*
+ * Changes key of a task in heap. O(log n)
+ */
+PRIVATE void Heap_UpdateKey(TaskHeap* heap, TaskInfo* task, uint64_t key)
+{
+    HEAP_NODE(heap, task)->key = key;
+
+    Heap_SiftUp(heap, HEAP_NODE(heap, task)->index);
+    Heap_SiftDown(heap, HEAP_NODE(heap, task)->index);
+}
+
+/*
+ * Returns ready heap key of an aperiodic task which puts task at the end of
+ * background tasks.
+ */
+PRIVATE ALWAYS_INLINE uint64_t NextBackgroundKey(void)
+{
+    return BACKGROUND_KEY_BASE + scheduler.backgroundSequence++;
+}
+
+/*
+ * Returns ready heap key of a task
+ */
+PRIVATE ALWAYS_INLINE uint64_t ReadyKey(TaskInfo* task)
+{
+    return (task->periodInUs != 0) ? task->deadline : NextBackgroundKey();
+}
+
+/*
+ * Adds a task into ready heap if it is runnable.
+ *
+ *  A task is runnable if it is admitted, not blocked and it is aperiodic or
+ *  it has a pending job.
+ */
+PRIVATE ALWAYS_INLINE void MakeReadyIfRunnable(TaskInfo* task)
+{
+    if ((task->flags.admitted == BOOL_TRUE) &&
+        (task->flags.blocked == BOOL_FALSE) &&
+        ((task->periodInUs == 0) || (task->flags.jobPending == BOOL_TRUE)))
+    {
+        if (Heap_Contains(&scheduler.readyHeap, task) == BOOL_TRUE)
+        {
+            Heap_UpdateKey(&scheduler.readyHeap, task, ReadyKey(task));
+        }
+        else
+        {
+            Heap_Insert(&scheduler.readyHeap, task, ReadyKey(task));
+        }
+    }
+}
+
+/*
+ * Updates scheduler time.
+ *
+ *  Kernel time base is used if kernel time services are enabled so release
+ *  times do not drift. Otherwise elapsed time of kernel timer is added.
+ *
+ *  [IMP] Kernel timer must be restarted (see StartTimer()) after each update,
+ *  otherwise same elapsed time is added again.
+ */
+PRIVATE ALWAYS_INLINE void UpdateTime(void)
+{
+#if (OS_ENABLE_TIME_SERVICES == 1)
+    scheduler.now = Kernel_ReadTimeBase();
+#else
+    scheduler.now += Kernel_GetPreemptionTimeStamp(scheduler.timer);
+#endif
+}
+
+/*
+ * Starts kernel timer to expire at next job release.
+ */
+PRIVATE ALWAYS_INLINE void StartTimer(void)
+{
+    TaskInfo* task = Heap_Min(&scheduler.releaseHeap);
+    uint64_t timeout = EDF_MAX_TIMER_TIMEOUT_IN_US;
+
+    if ((task != NULL) && ((task->nextRelease - scheduler.now) < timeout))
+    {
+        timeout = task->nextRelease - scheduler.now;
+    }
+
+    Kernel_StartPreemptionTimer(scheduler.timer, (uint32_t)timeout);
+}
+
+/*
+ * Updates worst observed lateness of a task.
+ */
+PRIVATE ALWAYS_INLINE void UpdateLateness(TaskInfo* task, uint64_t deadline)
+{
+    uint64_t lateness = scheduler.now - deadline;
+
+    if (lateness > task->tcb->maxLatenessInUs)
+    {
+        task->tcb->maxLatenessInUs = (uint32_t)lateness;
+    }
+}
+
+/*
+ * Releases a new job of a periodic task.
+ *
+ *  If previous job is still not completed, its deadline is missed. Lateness
+ *  is measured from first missed deadline when job is completed.
+ */
+PRIVATE ALWAYS_INLINE void ReleaseJob(TaskInfo* task)
+{
+    if (task->flags.jobPending == BOOL_TRUE)
+    {
+        task->tcb->deadlineMissCount++;
+
+        if (task->flags.jobLate == BOOL_FALSE)
+        {
+            task->flags.jobLate = BOOL_TRUE;
+            task->missedDeadline = task->deadline;
+        }
+    }
+
+    task->flags.jobPending = BOOL_TRUE;
+    task->deadline = task->nextRelease + task->relativeDeadlineInUs;
+    task->nextRelease += task->periodInUs;
+
+    Heap_UpdateKey(&scheduler.releaseHeap, task, task->nextRelease);
+
+    MakeReadyIfRunnable(task);
+}
+
+/*
+ * Releases all jobs whose release times are passed.
+ */
+PRIVATE ALWAYS_INLINE void ReleaseJobs(void)
+{
+    TaskInfo* task;
+
+    while (((task = Heap_Min(&scheduler.releaseHeap)) != NULL) &&
+           (task->nextRelease <= scheduler.now))
+    {
+        ReleaseJob(task);
+    }
+}
+
+/*
+ * Completes current job of a periodic task.
+ */
+PRIVATE ALWAYS_INLINE void CompleteJob(TaskInfo* task)
+{
+    if (task->flags.jobLate == BOOL_TRUE)
+    {
+        UpdateLateness(task, task->missedDeadline);
+    }
+    else if (scheduler.now > task->deadline)
+    {
+        task->tcb->deadlineMissCount++;
+        UpdateLateness(task, task->deadline);
+    }
+
+    task->flags.jobPending = BOOL_FALSE;
+    task->flags.jobLate = BOOL_FALSE;
+
+    Heap_Remove(&scheduler.readyHeap, task);
+}
+
+/*
+ * Switches to ready task with earliest deadline (or idle task).
+ *
+ * @param forceSwitch notify kernel even if running task is not changed
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void SwitchToEarliestDeadline(uint32_t forceSwitch)
+{
+    TaskInfo* nextTask = Heap_Min(&scheduler.readyHeap);
+
+    if (nextTask == NULL)
+    {
+        nextTask = &scheduler.idleTask;
+    }
+
+    if ((nextTask != scheduler.currentTask) || (forceSwitch == BOOL_TRUE))
+    {
+        scheduler.currentTask = nextTask;
+
+        /* Notify kernel and pass next task (TCB) */
+        scheduler.csCallback(nextTask->tcb);
+    }
+}
+
+/*
+ * Interrupt Service Routine (ISR) to handle Kernel Timer Timeouts
+ */
+void ISR_ReleaseTimer(void) NO_INLINE;
+void ISR_ReleaseTimer(void)
+{
+    UpdateTime();
+
+    /* Released jobs may preempt running task */
+    ReleaseJobs();
+    StartTimer();
+
+    SwitchToEarliestDeadline(BOOL_FALSE);
+}
+
+/*
+ * Initializes tasks and runs admission test.
+ *
+ *  Periodic tasks are admitted in task list order while total density
+ *  (WCET / min(period, deadline)) stays under utilization bound. Density
+ *  test is exact for implicit deadlines and safe for constrained deadlines.
+ *  Rejected tasks are never run.
+ *
+ * @param tcbList list of to be initialized tasks (TCBs)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
+{
+    UserTaskBaseType* userTask;
+    TaskInfo* task;
+    uint32_t utilization;
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        task = &scheduler.taskList[i];
+        userTask = tcbList[i].userTaskInfo;
+
+        task->tcb = &tcbList[i];
+        task->state = OSTaskState_Ready;
+        task->periodInUs = userTask->periodInUs;
+        task->relativeDeadlineInUs = userTask->deadlineInUs;
+        task->heapNodes[HeapType_Ready].index = NOT_IN_HEAP;
+        task->heapNodes[HeapType_Release].index = NOT_IN_HEAP;
+
+        if (task->periodInUs == 0)
+        {
+            /* Aperiodic tasks use remaining CPU time */
+            task->flags.admitted = BOOL_TRUE;
+        }
+        else
+        {
+            /* Deadline is implicit (period) if it is not given or too long */
+            if ((task->relativeDeadlineInUs == 0) ||
+                (task->relativeDeadlineInUs > task->periodInUs))
+            {
+                task->relativeDeadlineInUs = task->periodInUs;
+            }
+
+            /* Round up to stay in safe side */
+            utilization = (uint32_t)((((uint64_t)userTask->wcetInUs << EDF_UTILIZATION_SHIFT) +
+                                      task->relativeDeadlineInUs - 1) / task->relativeDeadlineInUs);
+
+            if ((scheduler.utilization + utilization) <= EDF_UTILIZATION_BOUND)
+            {
+                scheduler.utilization += utilization;
+                task->flags.admitted = BOOL_TRUE;
+
+                /* First job is released at start of scheduling */
+                task->nextRelease = 0;
+                Heap_Insert(&scheduler.releaseHeap, task, task->nextRelease);
+            }
+            else
+            {
+                DEBUG_MESSAGE("Task is rejected by EDF admission test!");
+            }
+        }
+
+        MakeReadyIfRunnable(task);
+    }
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes EDF Scheduler
+ */
+PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
+{
+    EDF_PARAMETER_CHECK(tcbList, idleTCB, csCallback);
+
+    /* Save client(kernel) callback to notify when Context Switching required */
+    scheduler.csCallback = csCallback;
+
+    /*
+     * Create timer to release jobs and keep time.
+     */
+    scheduler.timer = Kernel_CreatePreemptionTimer(SYSTEM_TIMER_KERNEL,
+                                                   KERNEL_TIMER_PRIORITY,
+                                                   ISR_ReleaseTimer);
+
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+    /* Save Idle TCB to run idle task if there is no ready task */
+    scheduler.idleTask.tcb = idleTCB;
+
+    scheduler.readyHeap.nodeIndex = HeapType_Ready;
+    scheduler.releaseHeap.nodeIndex = HeapType_Release;
+
+    InitializeTasks(tcbList);
+
+    /* Kernel starts with idle task */
+    scheduler.currentTask = &scheduler.idleTask;
+}
+
+/*
+ * Yields running task.
+ *
+ *  Yield of a periodic task completes its current job. An aperiodic task is
+ *  moved to end of background tasks.
+ */
+PUBLIC void Scheduler_Yield(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+
+    UpdateTime();
+
+    if ((currentTask != &scheduler.idleTask) &&
+        (Heap_Contains(&scheduler.readyHeap, currentTask) == BOOL_TRUE))
+    {
+        if (currentTask->periodInUs != 0)
+        {
+            CompleteJob(currentTask);
+        }
+        else
+        {
+            Heap_UpdateKey(&scheduler.readyHeap, currentTask, NextBackgroundKey());
+        }
+    }
+
+    ReleaseJobs();
+    StartTimer();
+
+    SwitchToEarliestDeadline(BOOL_TRUE);
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  A task which becomes ready preempts running task if it has an earlier
+ *  deadline.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+
+    EDF_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    task->state = state;
+
+    /* Running task is also a ready task for scheduling */
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if (task->flags.blocked == BOOL_TRUE)
+        {
+            task->flags.blocked = BOOL_FALSE;
+            MakeReadyIfRunnable(task);
+
+            /* Preempt running task if woken task has the earliest deadline */
+            if (Heap_Min(&scheduler.readyHeap) == task)
+            {
+                SwitchToEarliestDeadline(BOOL_FALSE);
+            }
+        }
+    }
+    else
+    {
+        task->flags.blocked = BOOL_TRUE;
+
+        if (Heap_Contains(&scheduler.readyHeap, task) == BOOL_TRUE)
+        {
+            Heap_Remove(&scheduler.readyHeap, task);
+        }
+    }
+}
+
+/*
+ * Returns ready task with earliest deadline without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    TaskInfo* nextTask = Heap_Min(&scheduler.readyHeap);
+
+    return (nextTask != NULL) ? nextTask->tcb : scheduler.idleTask.tcb;
+}
+
+#endif /* #if (OS_SCHEDULER == OS_SCHEDULER_EDF) */
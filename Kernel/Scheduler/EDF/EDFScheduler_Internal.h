@@ -0,0 +1,77 @@
+/*******************************************************************************
+ *
+ * @file EDFScheduler_Internal.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Internal definitions and configurations of Earliest Deadline First (EDF)
+ * Scheduler
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __EDF_SCHEDULER_INTERNAL_H
+#define __EDF_SCHEDULER_INTERNAL_H
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Utilization bound for admission test in percent.
+ *
+ *  EDF can schedule any periodic task set (with deadlines equal to periods)
+ *  whose total utilization is not higher than 100%. Bound can be decreased
+ *  to reserve CPU for aperiodic (background) tasks and scheduling overhead.
+ */
+#ifndef EDF_UTILIZATION_BOUND_PERCENT
+#define EDF_UTILIZATION_BOUND_PERCENT		(100)
+#endif
+
+/*
+ * Maximum timeout of kernel timer.
+ *
+ *  Scheduler keeps time using kernel timer so timer is started even if there
+ *  is no release in near future. Must fit in timer range.
+ */
+#ifndef EDF_MAX_TIMER_TIMEOUT_IN_US
+#define EDF_MAX_TIMER_TIMEOUT_IN_US			(1000000)
+#endif
+
+/* Number of fractional bits of utilization values */
+#define EDF_UTILIZATION_SHIFT				(16)
+
+/* Utilization bound in fixed point format */
+#define EDF_UTILIZATION_BOUND \
+			((uint32_t)(((uint64_t)EDF_UTILIZATION_BOUND_PERCENT << EDF_UTILIZATION_SHIFT) / 100))
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif /* __EDF_SCHEDULER_INTERNAL_H */
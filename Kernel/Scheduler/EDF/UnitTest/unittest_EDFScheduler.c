@@ -0,0 +1,331 @@
+/*******************************************************************************
+ *
+ * @file unittest_EDFScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for EDF Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "mock_Timer.c"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../EDFScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_SHORT_PERIOD				(0)		/* Period 10ms, WCET 2ms */
+#define TEST_TASK_LONG_PERIOD				(1)		/* Period 25ms, WCET 10ms */
+#define TEST_TASK_REJECTED					(2)		/* Period 20ms, WCET 10ms */
+#define TEST_TASK_APERIODIC					(3)		/* Background task */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/*
+ * Simulates kernel timer timeout after given time
+ */
+static void ElapseAndExpireTimer(uint32_t elapsedTimeInUs)
+{
+	mockTimer.elapsedTimeInUs = elapsedTimeInUs;
+	mockTimer.callback();
+}
+
+/*
+ * Simulates yield of running task after given time
+ */
+static void ElapseAndYield(uint32_t elapsedTimeInUs)
+{
+	mockTimer.elapsedTimeInUs = elapsedTimeInUs;
+	Scheduler_Yield();
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	MockTimer_Reset();
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		memset(&testTCBs[i], 0, sizeof(TCB));
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that periodic tasks are admitted while total utilization is under
+ * bound.
+ */
+void test_AdmissionTest(void)
+{
+	TEST_ASSERT_EQUAL_UINT32(BOOL_TRUE, scheduler.taskList[TEST_TASK_SHORT_PERIOD].flags.admitted);
+	TEST_ASSERT_EQUAL_UINT32(BOOL_TRUE, scheduler.taskList[TEST_TASK_LONG_PERIOD].flags.admitted);
+	TEST_ASSERT_EQUAL_UINT32(BOOL_FALSE, scheduler.taskList[TEST_TASK_REJECTED].flags.admitted);
+	TEST_ASSERT_EQUAL_UINT32(BOOL_TRUE, scheduler.taskList[TEST_TASK_APERIODIC].flags.admitted);
+
+	/* Total utilization is 60% (rounded up) */
+	TEST_ASSERT_UINT32_WITHIN(2, (60 << EDF_UTILIZATION_SHIFT) / 100, scheduler.utilization);
+
+	/* Only admitted periodic tasks release jobs */
+	TEST_ASSERT_EQUAL_UINT32(2, scheduler.releaseHeap.count);
+	TEST_ASSERT_EQUAL_UINT32(NOT_IN_HEAP, scheduler.taskList[TEST_TASK_REJECTED].heapNodes[HeapType_Release].index);
+}
+
+/*
+ * Tests heap order after inserts, removals and key updates.
+ */
+void test_HeapOrder(void)
+{
+	TaskHeap* heap = &scheduler.readyHeap;
+	TaskInfo* tasks = scheduler.taskList;
+	uint32_t i;
+
+	/* Clear heap and insert tasks in reverse order */
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		tasks[i].heapNodes[HeapType_Ready].index = NOT_IN_HEAP;
+	}
+	heap->count = 0;
+
+	Heap_Insert(heap, &tasks[0], 400);
+	Heap_Insert(heap, &tasks[1], 300);
+	Heap_Insert(heap, &tasks[2], 200);
+	Heap_Insert(heap, &tasks[3], 100);
+	TEST_ASSERT_EQUAL_PTR(&tasks[3], Heap_Min(heap));
+
+	/* Remove from middle of heap */
+	Heap_Remove(heap, &tasks[2]);
+	TEST_ASSERT_EQUAL_UINT32(BOOL_FALSE, Heap_Contains(heap, &tasks[2]));
+	TEST_ASSERT_EQUAL_PTR(&tasks[3], Heap_Min(heap));
+
+	/* Increase key of minimum and decrease key of maximum */
+	Heap_UpdateKey(heap, &tasks[3], 500);
+	TEST_ASSERT_EQUAL_PTR(&tasks[1], Heap_Min(heap));
+	Heap_UpdateKey(heap, &tasks[0], 50);
+	TEST_ASSERT_EQUAL_PTR(&tasks[0], Heap_Min(heap));
+
+	/* Tasks are removed in key order */
+	Heap_Remove(heap, &tasks[0]);
+	TEST_ASSERT_EQUAL_PTR(&tasks[1], Heap_Min(heap));
+	Heap_Remove(heap, &tasks[1]);
+	TEST_ASSERT_EQUAL_PTR(&tasks[3], Heap_Min(heap));
+	Heap_Remove(heap, &tasks[3]);
+	TEST_ASSERT_NULL(Heap_Min(heap));
+}
+
+/*
+ * Tests that task with earliest deadline is run and aperiodic task is run
+ * only if there is no pending periodic job.
+ */
+void test_EarliestDeadlineIsRun(void)
+{
+	/* Both periodic tasks release their first jobs at start */
+	ElapseAndYield(0);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_SHORT_PERIOD], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(10000, mockTimer.timeoutInUs);
+
+	/* First job of short period task is completed */
+	ElapseAndYield(2000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LONG_PERIOD], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(8000, mockTimer.timeoutInUs);
+
+	/* There is no pending periodic job, run background task */
+	ElapseAndYield(6000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_APERIODIC], lastSwitchedTCB);
+
+	/* Next release of short period task */
+	ElapseAndExpireTimer(2000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_SHORT_PERIOD], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT64(20000, scheduler.taskList[TEST_TASK_SHORT_PERIOD].deadline);
+
+	TEST_ASSERT_EQUAL_UINT32(0, testTCBs[TEST_TASK_SHORT_PERIOD].deadlineMissCount);
+	TEST_ASSERT_EQUAL_UINT32(0, testTCBs[TEST_TASK_LONG_PERIOD].deadlineMissCount);
+}
+
+/*
+ * Tests that a released job with earlier deadline preempts running task.
+ */
+void test_ReleasePreemptsLaterDeadline(void)
+{
+	ElapseAndYield(0);
+	ElapseAndYield(2000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LONG_PERIOD], lastSwitchedTCB);
+
+	/* Released job (deadline 20ms) preempts long period task (deadline 25ms) */
+	ElapseAndExpireTimer(8000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_SHORT_PERIOD], lastSwitchedTCB);
+
+	/* Long period task continues after job completion */
+	ElapseAndYield(2000);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LONG_PERIOD], lastSwitchedTCB);
+}
+
+/*
+ * Tests that missed deadlines are counted.
+ */
+void test_DeadlineMissCounter(void)
+{
+	ElapseAndYield(0);
+
+	/* Short period task does not complete its job until next release */
+	ElapseAndExpireTimer(10000);
+	TEST_ASSERT_EQUAL_UINT32(1, testTCBs[TEST_TASK_SHORT_PERIOD].deadlineMissCount);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_SHORT_PERIOD], Scheduler_GetNextTCB());
+
+	/* Job is completed in time, so no new miss */
+	ElapseAndYield(1000);
+	TEST_ASSERT_EQUAL_UINT32(1, testTCBs[TEST_TASK_SHORT_PERIOD].deadlineMissCount);
+
+	/* Long period task does not complete its job until its deadline (25ms) */
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LONG_PERIOD], lastSwitchedTCB);
+	BlockTask(TEST_TASK_SHORT_PERIOD);
+	ElapseAndExpireTimer(9000);
+	ElapseAndExpireTimer(5000);
+	ElapseAndYield(1000);
+	TEST_ASSERT_EQUAL_UINT32(1, testTCBs[TEST_TASK_LONG_PERIOD].deadlineMissCount);
+}
+
+/*
+ * Tests that worst lateness is measured from first missed deadline of a job.
+ */
+void test_MaxLateness(void)
+{
+	ElapseAndYield(0);
+
+	/* Short period task completes its job 1ms after its deadline */
+	ElapseAndExpireTimer(10000);
+	ElapseAndYield(1000);
+	TEST_ASSERT_EQUAL_UINT32(1000, testTCBs[TEST_TASK_SHORT_PERIOD].maxLatenessInUs);
+
+	/* Long period task completes its job 1ms after its deadline (25ms) */
+	BlockTask(TEST_TASK_SHORT_PERIOD);
+	ElapseAndExpireTimer(9000);
+	ElapseAndExpireTimer(5000);
+	ElapseAndYield(1000);
+	TEST_ASSERT_EQUAL_UINT32(1000, testTCBs[TEST_TASK_LONG_PERIOD].maxLatenessInUs);
+
+	/* Jobs which complete in time do not change worst lateness */
+	TEST_ASSERT_EQUAL_UINT32(1000, testTCBs[TEST_TASK_SHORT_PERIOD].maxLatenessInUs);
+}
+
+/*
+ * Tests that blocked tasks are not run and a woken task preempts running task
+ * if it has an earlier deadline.
+ */
+void test_BlockedTaskIsNotRun(void)
+{
+	BlockTask(TEST_TASK_SHORT_PERIOD);
+	BlockTask(TEST_TASK_APERIODIC);
+
+	ElapseAndYield(0);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LONG_PERIOD], lastSwitchedTCB);
+
+	/* Woken task has earlier deadline */
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_SHORT_PERIOD);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_SHORT_PERIOD], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(1, switchCount);
+
+	/* Idle task is run if all jobs are completed */
+	ElapseAndYield(1000);
+	BlockTask(TEST_TASK_LONG_PERIOD);
+	ElapseAndYield(1000);
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	/* Woken background task preempts idle task */
+	WakeUpTask(TEST_TASK_APERIODIC);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_APERIODIC], lastSwitchedTCB);
+}
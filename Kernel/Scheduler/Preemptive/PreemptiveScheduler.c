@@ -0,0 +1,551 @@
+/*******************************************************************************
+ *
+ * @file PreemptiveScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Fixed Priority Preemptive Scheduler Implementation.
+ *
+ *          Highest priority ready task is run. A task which becomes ready
+ *          preempts running task if it has a higher priority. Tasks with same
+ *          priority are kept in FIFO run queues and share CPU in round-robin
+ *          order (optionally with time slicing).
+ *
+ *          A task can have a preemption threshold which is higher than its
+ *          priority. Task runs with its threshold once it is dispatched so
+ *          only tasks with priorities above threshold can preempt it. Tasks
+ *          in a threshold cluster are non-preemptive to each other.
+ *
+ *          Ready priorities are kept in a two-level bitmap (priority groups
+ *          and priorities in groups) so highest ready priority is found in
+ *          constant time using CLZ (Count Leading Zeros) instruction.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#include "OSConfig.h"
+
+#if (OS_SCHEDULER == OS_SCHEDULER_PREEMPTIVE)
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+#include "Scheduler.h"
+
+#include "PreemptiveScheduler_Internal.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Task count */
+#define TASK_COUNT                          NUM_OF_USER_TASKS
+
+/* Index of most significant set bit of a (non-zero) word */
+#define HIGHEST_BIT(value)                  (31 - COUNT_LEADING_ZEROS(value))
+
+/* Priority group of a priority */
+#define PRIORITY_GROUP(priority)            ((priority) / PS_PRIORITY_GROUP_SIZE)
+
+/* Bit of a priority in its priority group */
+#define PRIORITY_BIT(priority)              ((uint32_t)1 << ((priority) % PS_PRIORITY_GROUP_SIZE))
+
+/*
+ * Preemptive scheduler is an internal object and external objects
+ * (e.g. User Application) cannot access and cannot pass parameter into
+ * this module. And assume that OS modules are robust and do not pass erronous
+ * parameters so no need to check parameter for public function to avoid
+ * unnecessary checks.
+ */
+#define PS_PARAMETER_CHECK(...)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Task Information
+ */
+typedef struct TaskInfo
+{
+    /*
+     * Links in run queue of task priority.
+     *  Run queues are circular doubly linked lists so a task can be removed
+     *  in constant time. Both are NULL if task is not in a run queue.
+     */
+    struct TaskInfo* next;
+    struct TaskInfo* prev;
+
+    /*
+     * Active Task Priority. Higher value is higher priority.
+     *  Task is kept in run queue of this priority. It is raised to preemption
+     *  threshold when task is dispatched and restored when task yields or
+     *  blocks.
+     */
+    uint32_t priority;
+
+    /* Base (user defined) Task Priority */
+    uint32_t basePriority;
+
+    /* Preemption Threshold. Never lower than base priority. */
+    uint32_t preemptionThreshold;
+
+    /* Task State */
+    OSTaskState state;
+
+    /*
+     * Task Control Block (TCB) Reference.
+     *  Kernel interests only TCB for context switching, when scheduler finds
+     *  the next task, just provides next task's TCB to kernel.
+     */
+    TCB* tcb;
+} TaskInfo;
+
+/*
+ * Two-Level Ready Bitmap
+ *
+ *  A bit in group bitmap is set if there is a ready priority in that group.
+ *  A bit in a priority bitmap is set if run queue of that priority is not
+ *  empty.
+ */
+typedef struct
+{
+    /* Priority groups which have ready tasks */
+    uint32_t groups;
+    /* Ready priorities in each group */
+    uint32_t priorities[PS_PRIORITY_GROUP_COUNT];
+} ReadyBitmap;
+
+/*
+ * Scheduler Data Structure.
+ */
+typedef struct
+{
+#if PS_ENABLE_TIME_SLICING
+    /*
+     * Time Slice Timer
+     * This timer preempts the actual task when its time slice is completed.
+     */
+    KernelTimerHandle timer;
+#endif /* PS_ENABLE_TIME_SLICING */
+
+    /* Client (Kernel) callback function to notify kernel for to be run task */
+    SchedulerCSCallback csCallback;
+
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Task List (Pool) to collect all user tasks. */
+    TaskInfo taskList[TASK_COUNT];
+    /* Idle task. Not kept in run queues, run if there is no ready task. */
+    TaskInfo idleTask;
+    /* Reference to Current (Running) task*/
+    TaskInfo* currentTask;
+
+    /* Run Queues (heads) of each priority */
+    TaskInfo* runQueues[OS_TASK_PRIORITY_MAX];
+
+    /* Ready priorities */
+    ReadyBitmap readyBitmap;
+} SchedulerData;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Scheduler (Internal) Data
+ */
+PRIVATE SchedulerData scheduler;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+#if PS_ENABLE_TIME_SLICING
+/*
+ * Interrupt Service Routine (ISR) to handle Time Slice Timeouts
+ */
+void ISR_TimeSliceTimer(void) NO_INLINE;
+void ISR_TimeSliceTimer(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+
+    /*
+     * A task which is raised to its preemption threshold must not be
+     * preempted by tasks below threshold. Yield would restore its base
+     * priority so if there is no other task in run queue of threshold, just
+     * start a new time slice.
+     */
+    if ((currentTask != &scheduler.idleTask) &&
+        (currentTask->priority != currentTask->basePriority) &&
+        (currentTask->next == currentTask))
+    {
+        Kernel_StartPreemptionTimer(scheduler.timer, PS_TIME_SLICE_IN_US);
+        return;
+    }
+
+    /*
+     * Running task's time slice is ended and preempted.
+     * Therfore, yield to next task with same priority.
+     */
+    Scheduler_Yield();
+}
+#endif /* PS_ENABLE_TIME_SLICING */
+
+/*
+ * Adds a task to end of run queue of its priority.
+ *
+ * @param task to be added task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void EnqueueTask(TaskInfo* task)
+{
+    uint32_t priority = task->priority;
+    TaskInfo* head = scheduler.runQueues[priority];
+
+    if (head == NULL)
+    {
+        /* First task in run queue */
+        task->next = task;
+        task->prev = task;
+        scheduler.runQueues[priority] = task;
+
+        /* Priority is ready now */
+        scheduler.readyBitmap.priorities[PRIORITY_GROUP(priority)] |= PRIORITY_BIT(priority);
+        scheduler.readyBitmap.groups |= PRIORITY_BIT(PRIORITY_GROUP(priority));
+    }
+    else
+    {
+        /* End of circular queue is just before head */
+        task->next = head;
+        task->prev = head->prev;
+        head->prev->next = task;
+        head->prev = task;
+    }
+}
+
+/*
+ * Removes a task from run queue of its priority.
+ *
+ * @param task to be removed task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void DequeueTask(TaskInfo* task)
+{
+    uint32_t priority = task->priority;
+    uint32_t group = PRIORITY_GROUP(priority);
+
+    if (task->next == task)
+    {
+        /* Last task in run queue */
+        scheduler.runQueues[priority] = NULL;
+
+        /* Priority is not ready anymore */
+        scheduler.readyBitmap.priorities[group] &= ~PRIORITY_BIT(priority);
+        if (scheduler.readyBitmap.priorities[group] == 0)
+        {
+            scheduler.readyBitmap.groups &= ~PRIORITY_BIT(group);
+        }
+    }
+    else
+    {
+        task->prev->next = task->next;
+        task->next->prev = task->prev;
+
+        if (scheduler.runQueues[priority] == task)
+        {
+            scheduler.runQueues[priority] = task->next;
+        }
+    }
+
+    task->next = NULL;
+    task->prev = NULL;
+}
+
+/*
+ * Raises priority of a dispatched task to its preemption threshold.
+ *
+ *  Task is moved to head of run queue of threshold so it is still selected
+ *  first if it is preempted by a task above threshold.
+ *
+ * @param task dispatched task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void RaiseToThreshold(TaskInfo* task)
+{
+    if (task->priority != task->preemptionThreshold)
+    {
+        DequeueTask(task);
+        task->priority = task->preemptionThreshold;
+        EnqueueTask(task);
+
+        /* Circular queue so last task becomes head */
+        scheduler.runQueues[task->priority] = task;
+    }
+}
+
+/*
+ * Restores priority of a task which gives up CPU (yield or block).
+ *
+ *  If task is still ready, it is added to end of run queue of its base
+ *  priority.
+ *
+ * @param task task which gives up CPU
+ * @param queued whether if task is in a run queue
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void RestoreBasePriority(TaskInfo* task, uint32_t queued)
+{
+    if (queued == BOOL_TRUE)
+    {
+        DequeueTask(task);
+        task->priority = task->basePriority;
+        EnqueueTask(task);
+    }
+    else
+    {
+        task->priority = task->basePriority;
+    }
+}
+
+/*
+ * Checks whether if a task is in a run queue (ready) or not.
+ *
+ * @param task to be checked task
+ * @return BOOL_TRUE if task is in its run queue, otherwise BOOL_FALSE
+ */
+PRIVATE ALWAYS_INLINE uint32_t IsTaskQueued(TaskInfo* task)
+{
+    return (task->next != NULL) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+/*
+ * Finds highest priority ready task in constant time.
+ *
+ *  First CLZ finds highest ready priority group and second one finds highest
+ *  ready priority in that group. Task at head of run queue of that priority
+ *  is the next task.
+ *
+ * @param none
+ * @return highest priority ready task or idle task if there is no ready task
+ */
+PRIVATE ALWAYS_INLINE TaskInfo* FindHighestPriorityTask(void)
+{
+    uint32_t group;
+    uint32_t priority;
+
+    if (scheduler.readyBitmap.groups == 0)
+    {
+        return &scheduler.idleTask;
+    }
+
+    group = HIGHEST_BIT(scheduler.readyBitmap.groups);
+    priority = (group * PS_PRIORITY_GROUP_SIZE) +
+               HIGHEST_BIT(scheduler.readyBitmap.priorities[group]);
+
+    return scheduler.runQueues[priority];
+}
+
+/*
+ * Switches to a task.
+ *
+ *  Starts time slice of task and notifies kernel.
+ *
+ * @param nextTask to be switched task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void SwitchTo(TaskInfo* nextTask)
+{
+    scheduler.currentTask = nextTask;
+
+    if (nextTask != &scheduler.idleTask)
+    {
+        /* Task runs with its threshold */
+        RaiseToThreshold(nextTask);
+    }
+
+#if PS_ENABLE_TIME_SLICING
+    /*
+     * Each switched task starts a new time slice. Idle task is not sliced
+     * because it is preempted as soon as a task becomes ready.
+     */
+    if (nextTask != &scheduler.idleTask)
+    {
+        Kernel_StartPreemptionTimer(scheduler.timer, PS_TIME_SLICE_IN_US);
+    }
+#endif /* PS_ENABLE_TIME_SLICING */
+
+    /* Notify kernel and pass next task (TCB) */
+    scheduler.csCallback(nextTask->tcb);
+}
+
+/*
+ * Initializes tasks and run queues.
+ *
+ * @param tcbList list of to be initialized tasks (TCBs)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
+{
+    TCB* tcb = &tcbList[0];
+    TaskInfo* task;
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++, tcb++)
+    {
+        task = &scheduler.taskList[i];
+
+        task->tcb = tcb;
+        task->priority = tcb->userTaskInfo->priority;
+        task->basePriority = task->priority;
+        task->preemptionThreshold = MATH_MAX(task->priority, tcb->userTaskInfo->preemptionThreshold);
+
+        DEBUG_ASSERT(task->preemptionThreshold < OS_TASK_PRIORITY_MAX);
+
+        /* When a task is created, it should be in ready state */
+        task->state = OSTaskState_Ready;
+        EnqueueTask(task);
+    }
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Preemptive Scheduler
+ */
+PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
+{
+    PS_PARAMETER_CHECK(tcbList, idleTCB, csCallback);
+
+    /* Save client(kernel) callback to notify when Context Switching required */
+    scheduler.csCallback = csCallback;
+
+#if PS_ENABLE_TIME_SLICING
+    /*
+     * Create timer to preempt running task at the end of its time slice.
+     */
+    scheduler.timer = Kernel_CreatePreemptionTimer(SYSTEM_TIMER_KERNEL,
+                                                   KERNEL_TIMER_PRIORITY,
+                                                   ISR_TimeSliceTimer);
+#endif /* PS_ENABLE_TIME_SLICING */
+
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+    /* Save Idle TCB to run idle task if there is no ready task */
+    scheduler.idleTask.tcb = idleTCB;
+
+    InitializeTasks(tcbList);
+
+    /* Kernel starts with idle task */
+    scheduler.currentTask = &scheduler.idleTask;
+}
+
+/*
+ * Yields running task.
+ *
+ *  Running task is moved to end of its run queue so next task with same
+ *  priority is run. If running task is blocked, highest priority ready task
+ *  is run.
+ *
+ *  A task with a preemption threshold goes back to its base priority.
+ */
+PUBLIC void Scheduler_Yield(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+
+    if (currentTask != &scheduler.idleTask)
+    {
+        if (currentTask->priority != currentTask->basePriority)
+        {
+            RestoreBasePriority(currentTask, IsTaskQueued(currentTask));
+        }
+        else if (IsTaskQueued(currentTask) == BOOL_TRUE)
+        {
+            /*
+             * Running task is always at head of its run queue so moving head
+             * to next task moves running task to end of queue.
+             */
+            scheduler.runQueues[currentTask->priority] = currentTask->next;
+        }
+    }
+
+    SwitchTo(FindHighestPriorityTask());
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  If a task with higher priority than (preemption threshold of) running task
+ *  becomes ready, running task is preempted immediately.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+    TaskInfo* currentTask = scheduler.currentTask;
+
+    PS_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    task->state = state;
+
+    /* Running task is also a ready task for scheduling */
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if (IsTaskQueued(task) == BOOL_FALSE)
+        {
+            EnqueueTask(task);
+
+            /*
+             * Preempt running task if woken task has higher priority. Running
+             * task is already raised to its threshold.
+             */
+            if ((currentTask == &scheduler.idleTask) ||
+                (task->priority > currentTask->priority))
+            {
+                SwitchTo(task);
+            }
+        }
+    }
+    else
+    {
+        if (IsTaskQueued(task) == BOOL_TRUE)
+        {
+            DequeueTask(task);
+        }
+
+        /* Blocked task is woken with its base priority */
+        task->priority = task->basePriority;
+    }
+}
+
+/*
+ * Returns highest priority ready task without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    return FindHighestPriorityTask()->tcb;
+}
+
+#endif /* #if (OS_SCHEDULER == OS_SCHEDULER_PREEMPTIVE) */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+ *
+ * @file PreemptiveScheduler_Internal.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Internal definitions and configurations of Fixed Priority Preemptive Scheduler
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __PREEMPTIVE_SCHEDULER_INTERNAL_H
+#define __PREEMPTIVE_SCHEDULER_INTERNAL_H
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Round-Robin Time Slicing
+ *
+ *  Tasks with same priority share CPU in round-robin order. Running task is
+ *  preempted by kernel timer at the end of its time slice and moved to end
+ *  of its run queue. If disabled, tasks with same priority are only switched
+ *  by yield or blocking.
+ */
+#ifndef PS_ENABLE_TIME_SLICING
+#define PS_ENABLE_TIME_SLICING				1
+#endif
+
+/* Time slice for round-robin scheduling between tasks with same priority */
+#ifndef PS_TIME_SLICE_IN_US
+#define PS_TIME_SLICE_IN_US					(10000)
+#endif
+
+/*
+ * Number of priorities in a priority group.
+ *  Each group is a word in ready bitmap so highest priority in a group is
+ *  found using a single CLZ instruction.
+ */
+#define PS_PRIORITY_GROUP_SIZE				(32)
+
+/* Number of priority groups */
+#define PS_PRIORITY_GROUP_COUNT \
+			((OS_TASK_PRIORITY_MAX + PS_PRIORITY_GROUP_SIZE - 1) / PS_PRIORITY_GROUP_SIZE)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif /* __PREEMPTIVE_SCHEDULER_INTERNAL_H */
@@ -0,0 +1,359 @@
+/*******************************************************************************
+ *
+ * @file unittest_PreemptiveScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Preemptive Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "mock_Timer.c"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../PreemptiveScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_LOW						(0)		/* Priority 5 */
+#define TEST_TASK_MID_1						(1)		/* Priority 40 */
+#define TEST_TASK_MID_2						(2)		/* Priority 40 */
+#define TEST_TASK_HIGH						(3)		/* Priority 63 */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	MockTimer_Reset();
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that ready bitmap keeps priorities of ready tasks in both levels.
+ */
+void test_ReadyBitmap(void)
+{
+	/* Priority 5 is in first group, 40 and 63 are in second group */
+	TEST_ASSERT_EQUAL_HEX32(0x3, scheduler.readyBitmap.groups);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(5), scheduler.readyBitmap.priorities[0]);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(40) | PRIORITY_BIT(63), scheduler.readyBitmap.priorities[1]);
+
+	/* Priority bit is kept while there is a ready task with same priority */
+	BlockTask(TEST_TASK_MID_1);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(40) | PRIORITY_BIT(63), scheduler.readyBitmap.priorities[1]);
+	BlockTask(TEST_TASK_MID_2);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(63), scheduler.readyBitmap.priorities[1]);
+
+	/* Group bit is cleared when last priority in group is not ready */
+	BlockTask(TEST_TASK_HIGH);
+	TEST_ASSERT_EQUAL_HEX32(0x1, scheduler.readyBitmap.groups);
+	TEST_ASSERT_EQUAL_HEX32(0, scheduler.readyBitmap.priorities[1]);
+
+	/* Only lowest priority task is ready */
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], Scheduler_GetNextTCB());
+}
+
+/*
+ * Tests that highest priority ready task is run.
+ */
+void test_HighestPriorityTaskIsRun(void)
+{
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+
+	/* Yield does not let lower priority tasks run */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+
+	/* Highest priority task is blocked, next priority level is run */
+	BlockTask(TEST_TASK_HIGH);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], Scheduler_GetNextTCB());
+}
+
+/*
+ * Tests round-robin order between tasks with same priority.
+ */
+void test_RoundRobinBetweenSamePriorities(void)
+{
+	BlockTask(TEST_TASK_HIGH);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	/* Time slice timer is started for each switched task */
+	TEST_ASSERT_EQUAL_UINT32(PS_TIME_SLICE_IN_US, mockTimer.timeoutInUs);
+	TEST_ASSERT_EQUAL_UINT32(3, mockTimer.startCount);
+
+	/* Time slice timeout yields to next task with same priority */
+	mockTimer.callback();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], lastSwitchedTCB);
+}
+
+/*
+ * Tests that a task which becomes ready preempts running task only if it has
+ * higher priority.
+ */
+void test_PreemptionOnWakeUp(void)
+{
+	BlockTask(TEST_TASK_HIGH);
+	BlockTask(TEST_TASK_MID_1);
+	BlockTask(TEST_TASK_MID_2);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+
+	/* Higher priority task preempts running task immediately */
+	WakeUpTask(TEST_TASK_MID_1);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	/* Task with same priority does not preempt running task */
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_MID_2);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	/* Lower priority task is resumed after higher priority tasks are blocked */
+	BlockTask(TEST_TASK_MID_1);
+	BlockTask(TEST_TASK_MID_2);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+}
+
+/*
+ * Tests that idle task is run if there is no ready task and it is preempted
+ * by any task which becomes ready.
+ */
+void test_IdleTaskRunsWhenNoReadyTask(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		BlockTask(i);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	/* Idle task is not sliced */
+	TEST_ASSERT_EQUAL_UINT32(0, mockTimer.startCount);
+
+	WakeUpTask(TEST_TASK_LOW);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+}
+
+/*
+ * Tests that a task which is not at head of its run queue can be removed.
+ */
+void test_RemoveTaskFromMiddleOfRunQueue(void)
+{
+	BlockTask(TEST_TASK_HIGH);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	/* Waiting task in queue is blocked */
+	BlockTask(TEST_TASK_MID_2);
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_MID_1], scheduler.runQueues[40]);
+	TEST_ASSERT_EQUAL_PTR(&scheduler.taskList[TEST_TASK_MID_1], scheduler.taskList[TEST_TASK_MID_1].next);
+
+	/* Only running task remains in run queue */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+
+	/* Woken task is added to end of queue */
+	WakeUpTask(TEST_TASK_MID_2);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], lastSwitchedTCB);
+}
+
+/*
+ * Tests that preemption threshold of a task is its priority by default.
+ */
+void test_DefaultPreemptionThreshold(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		TEST_ASSERT_EQUAL_UINT32(testTCBs[i].userTaskInfo->priority,
+								 scheduler.taskList[i].preemptionThreshold);
+	}
+}
+
+/*
+ * Tests that running task is only preempted by tasks above its preemption
+ * threshold and it is resumed before tasks below threshold.
+ */
+void test_PreemptionThreshold(void)
+{
+	/* Low priority task is non-preemptive to mid priority tasks */
+	scheduler.taskList[TEST_TASK_LOW].preemptionThreshold = 50;
+
+	BlockTask(TEST_TASK_HIGH);
+	BlockTask(TEST_TASK_MID_1);
+	BlockTask(TEST_TASK_MID_2);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(50, scheduler.taskList[TEST_TASK_LOW].priority);
+
+	/* Task below threshold does not preempt running task */
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_MID_1);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+
+	/* Task above threshold preempts running task */
+	WakeUpTask(TEST_TASK_HIGH);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+
+	/* Preempted task keeps its threshold and is resumed first */
+	BlockTask(TEST_TASK_HIGH);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+
+	/* Task goes back to its base priority when it yields */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(5, scheduler.taskList[TEST_TASK_LOW].priority);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(5), scheduler.readyBitmap.priorities[0]);
+	TEST_ASSERT_EQUAL_HEX32(PRIORITY_BIT(40), scheduler.readyBitmap.priorities[1]);
+	TEST_ASSERT_EQUAL_UINT32(3, switchCount);
+}
+
+/*
+ * Tests that end of time slice does not let tasks below preemption threshold
+ * run.
+ */
+void test_TimeSliceKeepsPreemptionThreshold(void)
+{
+	/* Low priority task is non-preemptive to mid priority tasks */
+	scheduler.taskList[TEST_TASK_LOW].preemptionThreshold = 50;
+
+	BlockTask(TEST_TASK_HIGH);
+	BlockTask(TEST_TASK_MID_1);
+	BlockTask(TEST_TASK_MID_2);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_LOW], lastSwitchedTCB);
+
+	/* Mid priority task is ready but below threshold */
+	WakeUpTask(TEST_TASK_MID_1);
+
+	/* Time slice expires, task keeps CPU and its threshold */
+	switchCount = 0;
+	mockTimer.callback();
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+	TEST_ASSERT_EQUAL_UINT32(50, scheduler.taskList[TEST_TASK_LOW].priority);
+	TEST_ASSERT_EQUAL_UINT32(2, mockTimer.startCount);
+
+	/* Task goes back to its base priority only when it yields */
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(5, scheduler.taskList[TEST_TASK_LOW].priority);
+}
@@ -0,0 +1,324 @@
+/*******************************************************************************
+ *
+ * @file RoundRobinScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Non-Preemptive Round-Robin Scheduler Implementation.
+ *
+ *          Ready tasks are kept in an intrusive circular list and run in
+ *          list order. A task runs until it yields or blocks, so scheduler
+ *          does not use any timer (interrupt).
+ *
+ *          Blocked tasks are removed from ready list so they cost nothing to
+ *          skip. Idle task is run if there is no ready task.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#include "OSConfig.h"
+
+#if (OS_SCHEDULER == OS_SCHEDULER_NON_PREEMPTIVE_RR)
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+#include "Scheduler.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Task count */
+#define TASK_COUNT                          NUM_OF_USER_TASKS
+
+/*
+ * Round-Robin scheduler is an internal object and external objects
+ * (e.g. User Application) cannot access and cannot pass parameter into
+ * this module. And assume that OS modules are robust and do not pass erronous
+ * parameters so no need to check parameter for public function to avoid
+ * unnecessary checks.
+ */
+#define RR_PARAMETER_CHECK(...)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Task Information
+ */
+typedef struct TaskInfo
+{
+    /*
+     * Links in ready list.
+     *  Ready list is a circular doubly linked list so a task can be removed
+     *  in constant time. Both are NULL if task is not ready.
+     */
+    struct TaskInfo* next;
+    struct TaskInfo* prev;
+
+    /* Task State */
+    OSTaskState state;
+
+    /*
+     * Task Control Block (TCB) Reference.
+     *  Kernel interests only TCB for context switching, when scheduler finds
+     *  the next task, just provides next task's TCB to kernel.
+     */
+    TCB* tcb;
+} TaskInfo;
+
+/*
+ * Scheduler Data Structure.
+ */
+typedef struct
+{
+    /* Client (Kernel) callback function to notify kernel for to be run task */
+    SchedulerCSCallback csCallback;
+
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Task List (Pool) to collect all user tasks. */
+    TaskInfo taskList[TASK_COUNT];
+    /* Idle task. Not kept in ready list, run if there is no ready task. */
+    TaskInfo idleTask;
+    /* Reference to Current (Running) task*/
+    TaskInfo* currentTask;
+
+    /*
+     * Head of ready list.
+     *  Running task is kept at head. Yield moves head to next task so end
+     *  of list (just before head) is end of round.
+     */
+    TaskInfo* readyList;
+} SchedulerData;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Scheduler (Internal) Data
+ */
+PRIVATE SchedulerData scheduler;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+/*
+ * Adds a task to end of ready list.
+ *
+ * @param task to be added task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void EnqueueTask(TaskInfo* task)
+{
+    TaskInfo* head = scheduler.readyList;
+
+    if (head == NULL)
+    {
+        /* First ready task */
+        task->next = task;
+        task->prev = task;
+        scheduler.readyList = task;
+    }
+    else
+    {
+        /* End of circular list is just before head */
+        task->next = head;
+        task->prev = head->prev;
+        head->prev->next = task;
+        head->prev = task;
+    }
+}
+
+/*
+ * Removes a task from ready list.
+ *
+ * @param task to be removed task
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void DequeueTask(TaskInfo* task)
+{
+    if (task->next == task)
+    {
+        /* Last ready task */
+        scheduler.readyList = NULL;
+    }
+    else
+    {
+        task->prev->next = task->next;
+        task->next->prev = task->prev;
+
+        /* Next task in round takes head */
+        if (scheduler.readyList == task)
+        {
+            scheduler.readyList = task->next;
+        }
+    }
+
+    task->next = NULL;
+    task->prev = NULL;
+}
+
+/*
+ * Checks whether if a task is in ready list or not.
+ *
+ * @param task to be checked task
+ * @return BOOL_TRUE if task is in ready list, otherwise BOOL_FALSE
+ */
+PRIVATE ALWAYS_INLINE uint32_t IsTaskQueued(TaskInfo* task)
+{
+    return (task->next != NULL) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+/*
+ * Initializes tasks and ready list.
+ *
+ * @param tcbList list of to be initialized tasks (TCBs)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
+{
+    TaskInfo* task;
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        task = &scheduler.taskList[i];
+
+        task->tcb = &tcbList[i];
+
+        /* When a task is created, it should be in ready state */
+        task->state = OSTaskState_Ready;
+        EnqueueTask(task);
+    }
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Round-Robin Scheduler
+ */
+PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
+{
+    RR_PARAMETER_CHECK(tcbList, idleTCB, csCallback);
+
+    /* Save client(kernel) callback to notify when Context Switching required */
+    scheduler.csCallback = csCallback;
+
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+    /* Save Idle TCB to run idle task if there is no ready task */
+    scheduler.idleTask.tcb = idleTCB;
+
+    InitializeTasks(tcbList);
+
+    /* Kernel starts with idle task */
+    scheduler.currentTask = &scheduler.idleTask;
+}
+
+/*
+ * Yields running task.
+ *
+ *  Next ready task in list is run. If running task is blocked, it is already
+ *  removed from list and its next task is already at head.
+ */
+PUBLIC void Scheduler_Yield(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+    TaskInfo* nextTask;
+
+    if ((currentTask != &scheduler.idleTask) && (IsTaskQueued(currentTask) == BOOL_TRUE))
+    {
+        scheduler.readyList = currentTask->next;
+    }
+
+    nextTask = scheduler.readyList;
+    if (nextTask == NULL)
+    {
+        nextTask = &scheduler.idleTask;
+    }
+
+    scheduler.currentTask = nextTask;
+
+    /* Notify kernel and pass next task (TCB) */
+    scheduler.csCallback(nextTask->tcb);
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  Scheduler is non-preemptive so a woken task is just added to end of round
+ *  and run when running task yields. Idle task does not yield so it is
+ *  switched to woken task immediately.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+
+    RR_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    task->state = state;
+
+    /* Running task is also a ready task for scheduling */
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if (IsTaskQueued(task) == BOOL_FALSE)
+        {
+            EnqueueTask(task);
+
+            if (scheduler.currentTask == &scheduler.idleTask)
+            {
+                Scheduler_Yield();
+            }
+        }
+    }
+    else if (IsTaskQueued(task) == BOOL_TRUE)
+    {
+        DequeueTask(task);
+    }
+}
+
+/*
+ * Returns next ready task in round without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+    TaskInfo* nextTask = scheduler.readyList;
+
+    if ((currentTask != &scheduler.idleTask) && (IsTaskQueued(currentTask) == BOOL_TRUE))
+    {
+        nextTask = currentTask->next;
+    }
+
+    return (nextTask != NULL) ? nextTask->tcb : scheduler.idleTask.tcb;
+}
+
+#endif /* #if (OS_SCHEDULER == OS_SCHEDULER_NON_PREEMPTIVE_RR) */
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ *
+ * @file unittest_RoundRobinScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Round-Robin Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../RoundRobinScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_1							(0)
+#define TEST_TASK_2							(1)
+#define TEST_TASK_3							(2)
+#define TEST_TASK_4							(3)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that ready tasks are run in round-robin order.
+ */
+void test_RoundRobinOrder(void)
+{
+	uint32_t round;
+	uint32_t i;
+
+	for (round = 0; round < 2; round++)
+	{
+		for (i = 0; i < TASK_COUNT; i++)
+		{
+			Scheduler_Yield();
+			TEST_ASSERT_EQUAL_PTR(&testTCBs[i], lastSwitchedTCB);
+		}
+	}
+}
+
+/*
+ * Tests that blocked tasks are skipped and woken tasks are added to end of
+ * round.
+ */
+void test_BlockedTasksAreSkipped(void)
+{
+	BlockTask(TEST_TASK_2);
+	BlockTask(TEST_TASK_3);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_4], lastSwitchedTCB);
+
+	/* Woken task is run after all ready tasks */
+	WakeUpTask(TEST_TASK_2);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_1], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_2], lastSwitchedTCB);
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_4], lastSwitchedTCB);
+}
+
+/*
+ * Tests that next task of a blocked running task is run on yield.
+ */
+void test_RunningTaskIsBlocked(void)
+{
+	Scheduler_Yield();
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_2], lastSwitchedTCB);
+
+	BlockTask(TEST_TASK_2);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_3], Scheduler_GetNextTCB());
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_3], lastSwitchedTCB);
+}
+
+/*
+ * Tests that idle task is run if there is no ready task.
+ */
+void test_IdleTaskIsRunWithoutReadyTask(void)
+{
+	uint32_t i;
+
+	Scheduler_Yield();
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		BlockTask(i);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+}
+
+/*
+ * Tests that a woken task does not preempt running task but it is switched
+ * immediately if idle task is running (idle task does not yield).
+ */
+void test_WakeUpFromIdle(void)
+{
+	uint32_t i;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_1], lastSwitchedTCB);
+
+	/* Non-preemptive, woken task waits for yield of running task */
+	BlockTask(TEST_TASK_3);
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_3);
+	TEST_ASSERT_EQUAL_UINT32(0, switchCount);
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		BlockTask(i);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+
+	/* All tasks are blocked (e.g. delayed), woken task leaves idle task */
+	switchCount = 0;
+	WakeUpTask(TEST_TASK_3);
+	TEST_ASSERT_EQUAL_UINT32(1, switchCount);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_3], lastSwitchedTCB);
+
+	/* Another woken task waits for its turn */
+	WakeUpTask(TEST_TASK_2);
+	TEST_ASSERT_EQUAL_UINT32(1, switchCount);
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_2], lastSwitchedTCB);
+}
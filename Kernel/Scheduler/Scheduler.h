@@ -79,6 +79,25 @@ void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback);
  */
 void Scheduler_Yield(void);
 
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  Kernel notifies scheduler when a task is blocked (e.g. waits for an event)
+ *  or becomes ready again so scheduler can keep its ready task set without
+ *  visiting all tasks. If running task is blocked, Kernel should yield after
+ *  this call. Only a preemptive scheduler may switch tasks in this function
+ *  (using context switching callback) if a task which becomes ready should
+ *  preempt running task.
+ *
+ *  [IMP] Must be called with interrupts disabled or from Kernel ISR context.
+ *
+ * @param tcb TCB of task
+ * @param state new state of task
+ *
+ * @return none
+ */
+void Scheduler_SetTaskState(TCB* tcb, OSTaskState state);
+
 /*
  * Returns ready TCB to run.
  *
@@ -88,4 +107,57 @@ void Scheduler_Yield(void);
  */
 TCB* Scheduler_GetNextTCB(void);
 
+#if (OS_SCHEDULER == OS_SCHEDULER_ADAPTIVE)
+/*
+ * Returns round time set point which is used for a task.
+ *
+ * @param tcb TCB of task
+ *
+ * @return round time set point of task (group) in microseconds
+ */
+uint32_t Scheduler_GetRoundSetPoint(TCB* tcb);
+
+/*
+ * Changes priority of a task.
+ *
+ *  Scheduler also updates priority in user task info.
+ *
+ * @param tcb TCB of task
+ * @param priority new priority of task
+ *
+ * @return BOOL_TRUE if priority is changed, otherwise BOOL_FALSE
+ */
+uint32_t Scheduler_SetTaskPriority(TCB* tcb, uint32_t priority);
+
+/*
+ * Yields running task and donates unused part of its burst to a task.
+ *
+ * @param tcb TCB of task to donate. NULL to keep unused burst as credit of
+ *        running task.
+ *
+ * @return none
+ */
+void Scheduler_YieldTo(TCB* tcb);
+
+/*
+ * Reads convergence statistics of regulator which is used for a task.
+ *
+ * @param tcb TCB of task
+ * @param statistics statistics of regulator (of task group)
+ *
+ * @return BOOL_TRUE if statistics are collected, otherwise BOOL_FALSE
+ */
+uint32_t Scheduler_GetRegulatorStatistics(TCB* tcb, OSRegulatorStatistics* statistics);
+
+/*
+ * Sets callback which is notified when a task is shed or restored because
+ * of overload.
+ *
+ * @param callback overload notification callback. NULL to disable.
+ *
+ * @return none
+ */
+void Scheduler_SetOverloadCallback(OSOverloadCallback callback);
+#endif
+
 #endif	/* __SCHEDULER_H */
@@ -0,0 +1,436 @@
+/*******************************************************************************
+ *
+ * @file StrideScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Stride (Proportional-Share) Scheduler Implementation.
+ *
+ *          Each task gets CPU share proportional to its tickets
+ *          (priority + 1) as Adaptive Scheduler's alpha but shares are
+ *          deterministic and applied from first round without any regulator.
+ *
+ *          Each task has a stride (inversely proportional to its tickets) and
+ *          a pass value. Task with minimum pass is run and its pass is
+ *          advanced by its stride for each microsecond it runs. Ready tasks
+ *          are kept in a binary min-heap keyed on pass.
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#include "OSConfig.h"
+
+#if (OS_SCHEDULER == OS_SCHEDULER_STRIDE)
+
+/********************************* INCLUDES ***********************************/
+#include "Kernel.h"
+#include "Kernel_Internal.h"
+#include "Scheduler.h"
+
+#include "StrideScheduler_Internal.h"
+
+#include "Debug.h"
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Task count */
+#define TASK_COUNT                          NUM_OF_USER_TASKS
+
+/* Heap index of a task which is not ready */
+#define NOT_IN_HEAP                         (0xFFFFFFFFUL)
+
+/* Pass of a task in heap */
+#define HEAP_PASS(index)                    (scheduler.readyHeap[index]->pass)
+
+/*
+ * Stride scheduler is an internal object and external objects
+ * (e.g. User Application) cannot access and cannot pass parameter into
+ * this module. And assume that OS modules are robust and do not pass erronous
+ * parameters so no need to check parameter for public function to avoid
+ * unnecessary checks.
+ */
+#define SS_PARAMETER_CHECK(...)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*
+ * Task Information
+ */
+typedef struct TaskInfo
+{
+    /* Virtual time of task. Task with minimum pass is run. */
+    uint64_t pass;
+    /* Pass increment for each microsecond of run time */
+    uint32_t stride;
+    /* Index of task in ready heap. NOT_IN_HEAP if task is not ready. */
+    uint32_t heapIndex;
+
+    /* Task State */
+    OSTaskState state;
+
+    /*
+     * Task Control Block (TCB) Reference.
+     *  Kernel interests only TCB for context switching, when scheduler finds
+     *  the next task, just provides next task's TCB to kernel.
+     */
+    TCB* tcb;
+} TaskInfo;
+
+/*
+ * Scheduler Data Structure.
+ */
+typedef struct
+{
+    /*
+     * Quantum Timer
+     *  Preempts running task at the end of its quantum and measures run time
+     *  of tasks.
+     */
+    KernelTimerHandle timer;
+
+    /* Client (Kernel) callback function to notify kernel for to be run task */
+    SchedulerCSCallback csCallback;
+
+    /* TCB List which is provided by Kernel. Used to find task of a TCB */
+    TCB* tcbList;
+
+    /* Task List (Pool) to collect all user tasks. */
+    TaskInfo taskList[TASK_COUNT];
+    /* Idle task. Not kept in ready heap, run if there is no ready task. */
+    TaskInfo idleTask;
+    /* Reference to Current (Running) task*/
+    TaskInfo* currentTask;
+
+    /* Ready tasks ordered by pass values (binary min-heap) */
+    TaskInfo* readyHeap[TASK_COUNT];
+    /* Number of ready tasks */
+    uint32_t readyCount;
+
+    /*
+     * Global pass (virtual time of scheduler).
+     *  Pass of last selected task. A woken task cannot be behind global pass
+     *  to avoid collecting CPU share while it is blocked.
+     */
+    uint64_t globalPass;
+} SchedulerData;
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/*
+ * Scheduler (Internal) Data
+ */
+PRIVATE SchedulerData scheduler;
+
+/**************************** PRIVATE FUNCTIONS ******************************/
+
+/*
+ * Places a task into a position of ready heap
+ */
+PRIVATE ALWAYS_INLINE void Heap_Place(TaskInfo* task, uint32_t index)
+{
+    scheduler.readyHeap[index] = task;
+    task->heapIndex = index;
+}
+
+/*
+ * Moves a task up until its parent has a smaller pass.
+ */
+PRIVATE void Heap_SiftUp(uint32_t index)
+{
+    TaskInfo* task = scheduler.readyHeap[index];
+    uint32_t parent;
+
+    while (index > 0)
+    {
+        parent = (index - 1) / 2;
+
+        if (HEAP_PASS(parent) <= task->pass)
+        {
+            break;
+        }
+
+        Heap_Place(scheduler.readyHeap[parent], index);
+        index = parent;
+    }
+
+    Heap_Place(task, index);
+}
+
+/*
+ * Moves a task down until its children have bigger passes.
+ */
+PRIVATE void Heap_SiftDown(uint32_t index)
+{
+    TaskInfo* task = scheduler.readyHeap[index];
+    uint32_t child;
+
+    while ((child = (2 * index) + 1) < scheduler.readyCount)
+    {
+        /* Select child with smaller pass */
+        if (((child + 1) < scheduler.readyCount) && (HEAP_PASS(child + 1) < HEAP_PASS(child)))
+        {
+            child++;
+        }
+
+        if (task->pass <= HEAP_PASS(child))
+        {
+            break;
+        }
+
+        Heap_Place(scheduler.readyHeap[child], index);
+        index = child;
+    }
+
+    Heap_Place(task, index);
+}
+
+/*
+ * Adds a task into ready heap. O(log n)
+ */
+PRIVATE ALWAYS_INLINE void EnqueueTask(TaskInfo* task)
+{
+    Heap_Place(task, scheduler.readyCount);
+    scheduler.readyCount++;
+
+    Heap_SiftUp(task->heapIndex);
+}
+
+/*
+ * Removes a task from ready heap. O(log n)
+ */
+PRIVATE ALWAYS_INLINE void DequeueTask(TaskInfo* task)
+{
+    uint32_t index = task->heapIndex;
+
+    scheduler.readyCount--;
+
+    if (index != scheduler.readyCount)
+    {
+        /* Move last task into empty position and restore heap order */
+        Heap_Place(scheduler.readyHeap[scheduler.readyCount], index);
+        Heap_SiftDown(index);
+        Heap_SiftUp(scheduler.readyHeap[index]->heapIndex);
+    }
+
+    task->heapIndex = NOT_IN_HEAP;
+}
+
+/*
+ * Checks whether if a task is ready (in heap) or not.
+ */
+PRIVATE ALWAYS_INLINE uint32_t IsTaskQueued(TaskInfo* task)
+{
+    return (task->heapIndex != NOT_IN_HEAP) ? BOOL_TRUE : BOOL_FALSE;
+}
+
+/*
+ * Charges running task for its run time.
+ *
+ *  Pass of a ready task is increased so it is only moved down in heap.
+ */
+PRIVATE ALWAYS_INLINE void ChargeTask(TaskInfo* task)
+{
+    uint32_t runTime = Kernel_GetPreemptionTimeStamp(scheduler.timer);
+
+    /* A task which yields immediately is charged at least for 1 us to rotate */
+    if (runTime == 0)
+    {
+        runTime = 1;
+    }
+
+    task->pass += (uint64_t)task->stride * runTime;
+
+    if (IsTaskQueued(task) == BOOL_TRUE)
+    {
+        Heap_SiftDown(task->heapIndex);
+    }
+}
+
+/*
+ * Switches to ready task with minimum pass or idle task if there is no ready
+ * task.
+ */
+PRIVATE ALWAYS_INLINE void SwitchToNextTask(void)
+{
+    TaskInfo* nextTask = &scheduler.idleTask;
+
+    if (scheduler.readyCount > 0)
+    {
+        nextTask = scheduler.readyHeap[0];
+        scheduler.globalPass = nextTask->pass;
+
+        /* Idle task is not preempted by timer, it runs until a task wakes up */
+        Kernel_StartPreemptionTimer(scheduler.timer, SS_QUANTUM_IN_US);
+    }
+
+    scheduler.currentTask = nextTask;
+
+    /* Notify kernel and pass next task (TCB) */
+    scheduler.csCallback(nextTask->tcb);
+}
+
+/*
+ * Interrupt Service Routine (ISR) to handle Quantum Timeouts
+ */
+void ISR_QuantumTimer(void) NO_INLINE;
+void ISR_QuantumTimer(void)
+{
+    /* Quantum of running task is ended */
+    Scheduler_Yield();
+}
+
+/*
+ * Initializes tasks and ready heap.
+ *
+ * @param tcbList list of to be initialized tasks (TCBs)
+ * @return none
+ */
+PRIVATE ALWAYS_INLINE void InitializeTasks(TCB* tcbList)
+{
+    TaskInfo* task;
+    uint32_t i;
+
+    for (i = 0; i < TASK_COUNT; i++)
+    {
+        task = &scheduler.taskList[i];
+
+        task->tcb = &tcbList[i];
+
+        DEBUG_ASSERT(tcbList[i].userTaskInfo->priority < OS_TASK_PRIORITY_MAX);
+
+        /* Tickets of a task is (priority + 1) as Adaptive Scheduler */
+        task->stride = SS_STRIDE1 / (tcbList[i].userTaskInfo->priority + 1);
+
+        /* First pass is a stride so tasks with more tickets start earlier */
+        task->pass = task->stride;
+
+        /* When a task is created, it should be in ready state */
+        task->state = OSTaskState_Ready;
+        EnqueueTask(task);
+    }
+}
+
+/***************************** PUBLIC FUNCTIONS *******************************/
+/*
+ * Initializes Stride Scheduler
+ */
+PUBLIC void Scheduler_Init(TCB* tcbList, TCB* idleTCB, SchedulerCSCallback csCallback)
+{
+    SS_PARAMETER_CHECK(tcbList, idleTCB, csCallback);
+
+    /* Save client(kernel) callback to notify when Context Switching required */
+    scheduler.csCallback = csCallback;
+
+    /*
+     * Create timer to preempt running task at the end of its quantum.
+     */
+    scheduler.timer = Kernel_CreatePreemptionTimer(SYSTEM_TIMER_KERNEL,
+                                                   KERNEL_TIMER_PRIORITY,
+                                                   ISR_QuantumTimer);
+
+    /* Save TCB List to find tasks of TCBs on state changes */
+    scheduler.tcbList = tcbList;
+
+    /* Save Idle TCB to run idle task if there is no ready task */
+    scheduler.idleTask.tcb = idleTCB;
+
+    InitializeTasks(tcbList);
+
+    /* Kernel starts with idle task */
+    scheduler.currentTask = &scheduler.idleTask;
+}
+
+/*
+ * Yields running task.
+ *
+ *  Running task is charged for its run time and task with minimum pass is
+ *  run.
+ */
+PUBLIC void Scheduler_Yield(void)
+{
+    TaskInfo* currentTask = scheduler.currentTask;
+
+    /* A blocked task is also charged, so it does not gain share by blocking */
+    if (currentTask != &scheduler.idleTask)
+    {
+        ChargeTask(currentTask);
+    }
+
+    SwitchToNextTask();
+}
+
+/*
+ * Changes state of a task in Scheduler side.
+ *
+ *  A woken task continues from global pass if it is behind. It preempts
+ *  only idle task, otherwise it is run when its pass is minimum.
+ */
+PUBLIC void Scheduler_SetTaskState(TCB* tcb, OSTaskState state)
+{
+    TaskInfo* task;
+
+    SS_PARAMETER_CHECK(tcb, state);
+
+    task = &scheduler.taskList[tcb - scheduler.tcbList];
+    task->state = state;
+
+    /* Running task is also a ready task for scheduling */
+    if ((state == OSTaskState_Ready) || (state == OSTaskState_Running))
+    {
+        if (IsTaskQueued(task) == BOOL_FALSE)
+        {
+            if (task->pass < scheduler.globalPass)
+            {
+                task->pass = scheduler.globalPass;
+            }
+
+            EnqueueTask(task);
+
+            if (scheduler.currentTask == &scheduler.idleTask)
+            {
+                SwitchToNextTask();
+            }
+        }
+    }
+    else if (IsTaskQueued(task) == BOOL_TRUE)
+    {
+        DequeueTask(task);
+    }
+}
+
+/*
+ * Returns ready task with minimum pass without switching.
+ */
+PUBLIC TCB* Scheduler_GetNextTCB(void)
+{
+    return (scheduler.readyCount > 0) ? scheduler.readyHeap[0]->tcb : scheduler.idleTask.tcb;
+}
+
+#endif /* #if (OS_SCHEDULER == OS_SCHEDULER_STRIDE) */
@@ -0,0 +1,65 @@
+/*******************************************************************************
+ *
+ * @file StrideScheduler_Internal.h
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Internal definitions and configurations of Stride Scheduler
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2016 P-OS
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ ******************************************************************************/
+#ifndef __STRIDE_SCHEDULER_INTERNAL_H
+#define __STRIDE_SCHEDULER_INTERNAL_H
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/*
+ * Scheduling quantum.
+ *  Running task is preempted at the end of its quantum. A task which yields
+ *  before end of its quantum is charged only for used time.
+ */
+#ifndef SS_QUANTUM_IN_US
+#define SS_QUANTUM_IN_US					(10000)
+#endif
+
+/*
+ * Stride of a task with single ticket.
+ *  Stride of a task is SS_STRIDE1 / tickets where tickets of a task is
+ *  (priority + 1). Must be a multiple of lots of ticket counts to keep
+ *  rounding error small.
+ */
+#define SS_STRIDE1							(1UL << 20)
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/*************************** FUNCTION DEFINITIONS *****************************/
+
+#endif /* __STRIDE_SCHEDULER_INTERNAL_H */
@@ -0,0 +1,232 @@
+/*******************************************************************************
+ *
+ * @file unittest_StrideScheduler.c
+ *
+ * @author Murat Cakmak
+ *
+ * @brief Unit test file for Stride Scheduler module
+ *
+ * @see https://github.com/P-LATFORM/P-OS/wiki
+ *
+ ******************************************************************************
+ *
+ *  Copyright (2016), P-OS
+ *
+ *   This software may be modified and distributed under the terms of the
+ *   'MIT License'.
+ *
+ *   See the LICENSE file for details.
+ *
+ ******************************************************************************/
+
+/********************************* INCLUDES ***********************************/
+#include "postypes.h"
+
+/* Let's include mock source files to simulate external module behaviours */
+#include "mock_Timer.c"
+
+/* Include Scheduler source file for WHITE-BOX unit testing */
+#include "../StrideScheduler.c"
+
+/* Include Unity Framework */
+#include "unity.h"
+
+/***************************** MACRO DEFINITIONS ******************************/
+
+/* Indexes of mock tasks (see Mock/UserStartupInfo.h) */
+#define TEST_TASK_LOW						(0)		/* Priority 5, 6 tickets */
+#define TEST_TASK_MID_1						(1)		/* Priority 40, 41 tickets */
+#define TEST_TASK_MID_2						(2)		/* Priority 40, 41 tickets */
+#define TEST_TASK_HIGH						(3)		/* Priority 63, 64 tickets */
+
+/***************************** TYPE DEFINITIONS *******************************/
+
+/**************************** FUNCTION PROTOTYPES *****************************/
+
+/******************************** VARIABLES ***********************************/
+
+/* Last TCB which is passed to Kernel by scheduler */
+static TCB* lastSwitchedTCB;
+
+/* Number of context switch requests */
+static uint32_t switchCount;
+
+/* TCB pool which is normally provided by Kernel */
+static TCB testTCBs[TASK_COUNT];
+
+/* TCB for Idle Task */
+static TCB testIdleTCB;
+
+/**************************** INTERNAL FUNCTIONS ******************************/
+
+/*
+ * Mock user task start point
+ */
+void MockTaskFunc(void* args)
+{
+	(void)args;
+}
+
+/*
+ * Mock Kernel Context Switch callback.
+ */
+static void MockContextSwitch(TCB* nextTCB)
+{
+	lastSwitchedTCB = nextTCB;
+	switchCount++;
+}
+
+/*
+ * Blocks a task
+ */
+static void BlockTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Waiting);
+}
+
+/*
+ * Makes a task ready
+ */
+static void WakeUpTask(uint32_t taskIndex)
+{
+	Scheduler_SetTaskState(&testTCBs[taskIndex], OSTaskState_Ready);
+}
+
+/*
+ * Runs scheduler for given number of full quantums and counts quantums of
+ * each task.
+ */
+static void RunQuantums(uint32_t quantumCount, uint32_t* taskQuantums)
+{
+	uint32_t i;
+
+	mockTimer.elapsedTimeInUs = SS_QUANTUM_IN_US;
+
+	for (i = 0; i < quantumCount; i++)
+	{
+		mockTimer.callback();
+		taskQuantums[lastSwitchedTCB - testTCBs]++;
+	}
+}
+
+/**
+ * @brief Constructor Method for each test case
+ *
+ */
+void setUp(void)
+{
+	void** appPtr = startupApplications;
+	uint32_t i;
+
+	MockTimer_Reset();
+	memset(&scheduler, 0, sizeof(scheduler));
+	lastSwitchedTCB = NULL;
+	switchCount = 0;
+
+	/* Simulate Kernel side task initialization */
+	for (i = 0; i < TASK_COUNT; i++, appPtr++)
+	{
+		testTCBs[i].userTaskInfo = (UserTaskBaseType*)(*appPtr);
+	}
+
+	Scheduler_Init(testTCBs, &testIdleTCB, MockContextSwitch);
+}
+
+/**
+ * @brief Destructor Method for each test case
+ *
+ */
+void tearDown(void)
+{
+	/* For now, nothing to do */
+}
+
+/***************************** TEST FUNCTIONS *******************************/
+
+/*
+ * Tests that CPU is shared in proportion to tickets in first round.
+ */
+void test_ProportionalShare(void)
+{
+	uint32_t taskQuantums[TASK_COUNT] = { 0 };
+
+	/* Start scheduling from idle task */
+	Scheduler_Yield();
+	taskQuantums[lastSwitchedTCB - testTCBs]++;
+
+	/* One round is total ticket count (6 + 41 + 41 + 64) */
+	RunQuantums(151, taskQuantums);
+
+	TEST_ASSERT_UINT32_WITHIN(1, 6, taskQuantums[TEST_TASK_LOW]);
+	TEST_ASSERT_UINT32_WITHIN(1, 41, taskQuantums[TEST_TASK_MID_1]);
+	TEST_ASSERT_UINT32_WITHIN(1, 41, taskQuantums[TEST_TASK_MID_2]);
+	TEST_ASSERT_UINT32_WITHIN(1, 64, taskQuantums[TEST_TASK_HIGH]);
+
+	/* Quantum timer is started for each task */
+	TEST_ASSERT_EQUAL_UINT32(SS_QUANTUM_IN_US, mockTimer.timeoutInUs);
+	TEST_ASSERT_EQUAL_UINT32(152, mockTimer.startCount);
+}
+
+/*
+ * Tests that a task is charged only for used time if it yields early.
+ */
+void test_EarlyYieldIsChargedForUsedTime(void)
+{
+	TaskInfo* task = &scheduler.taskList[TEST_TASK_HIGH];
+	uint64_t pass;
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_HIGH], lastSwitchedTCB);
+
+	pass = task->pass;
+	mockTimer.elapsedTimeInUs = 100;
+	Scheduler_Yield();
+
+	TEST_ASSERT_EQUAL_UINT64(pass + (100 * task->stride), task->pass);
+
+	/* Passes are advanced per microsecond, so another task is run */
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_1], lastSwitchedTCB);
+}
+
+/*
+ * Tests that a woken task does not collect share while it is blocked.
+ */
+void test_WokenTaskStartsFromGlobalPass(void)
+{
+	uint32_t taskQuantums[TASK_COUNT] = { 0 };
+
+	BlockTask(TEST_TASK_LOW);
+
+	Scheduler_Yield();
+	RunQuantums(100, taskQuantums);
+	TEST_ASSERT_EQUAL_UINT32(0, taskQuantums[TEST_TASK_LOW]);
+
+	WakeUpTask(TEST_TASK_LOW);
+	TEST_ASSERT_TRUE(scheduler.taskList[TEST_TASK_LOW].pass >= scheduler.globalPass);
+
+	/* Woken task gets its share, not whole CPU */
+	RunQuantums(146, taskQuantums);
+	TEST_ASSERT_UINT32_WITHIN(1, 6, taskQuantums[TEST_TASK_LOW]);
+}
+
+/*
+ * Tests that idle task is run if there is no ready task and it is preempted
+ * by a woken task.
+ */
+void test_IdleTaskIsPreempted(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < TASK_COUNT; i++)
+	{
+		BlockTask(i);
+	}
+
+	Scheduler_Yield();
+	TEST_ASSERT_EQUAL_PTR(&testIdleTCB, lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_UINT32(0, mockTimer.startCount);
+
+	WakeUpTask(TEST_TASK_MID_2);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], lastSwitchedTCB);
+	TEST_ASSERT_EQUAL_PTR(&testTCBs[TEST_TASK_MID_2], Scheduler_GetNextTCB());
+}
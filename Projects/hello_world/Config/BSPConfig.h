@@ -52,6 +52,7 @@
     #error "LED and LCD interfaces can not be used at same time!"
 #endif
 
+/* Maximum number of user (software) timers (see Drv_UserTimer.h) */
 #define CPU_TIMER_MAX_TIMER_COUNT       (30)
 
 
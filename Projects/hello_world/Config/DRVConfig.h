@@ -44,6 +44,6 @@
 /*
  * Used HW Timer count in that projects.
  */
-#define DRV_CONFIG_NUM_OF_USED_HW_TIMERS				(2)
+#define DRV_CONFIG_NUM_OF_USED_HW_TIMERS				(3)
 
 #endif	/* __DRV_CONFIG_H */
@@ -46,6 +46,16 @@
 
 #define OS_TASK_CREATION                    OS_TASK_CREATION_STATIC
 
+/*
+ * Kernel time services (OS_Delay) need a dedicated HW timer but P-OS has
+ * only one HW timer on PSoC 4 BLE.
+ */
+#if defined(PSOC_CREATOR_PROJECT)
+#define OS_ENABLE_TIME_SERVICES             0
+#else
+#define OS_ENABLE_TIME_SERVICES             1
+#endif
+
 /***************************** TYPE DEFINITIONS *******************************/
 
 /*************************** FUNCTION DEFINITIONS *****************************/
@@ -43,6 +43,8 @@
 /***************************** MACRO DEFINITIONS ******************************/
 #define SYSTEM_TIMER_KERNEL					0
 #define SYSTEM_TIMER_USER					1
+#define SYSTEM_TIMER_KERNEL_TIME			2
+#define SYSTEM_TIMER_KERNEL_TIMEBASE		SYSTEM_TIMER_KERNEL_TIME
 
 /* Debug Assertion */
 #define ENABLE_DEBUG_ASSERT					0
@@ -24,7 +24,12 @@ extern void Board_LedOff(uint32_t ledNo);
 /******************************** VARIABLES ***********************************/
 
 /**************************** PRIVATE FUNCTIONS ******************************/
-#if defined(PSOC_CREATOR_PROJECT)
+#if (OS_ENABLE_TIME_SERVICES == 1)
+
+/* Task sleeps so CPU is given to other tasks (or idle task) */
+#define Delay(delayInMs)           OS_Delay((delayInMs) * 1000)
+
+#elif defined(PSOC_CREATOR_PROJECT)
 
 extern void  CyDelay(uint32_t milliseconds);
 